@@ -17,6 +17,12 @@
 // Activates output of shader compile logs to log.
 #define SHADER_COMPILE_LOGS
 
+// Activates timing of the shader build pipeline (file I/O, compile, link, reflection), see ShaderBuildProfiler.
+//#define SHADER_BUILD_PROFILING
+
+// Activates counting of requested and issued calls of all redundancy checked binding and state functions, see StateChangeStatistics.
+//#define STATE_CHANGE_STATISTICS
+
 
 
 // Assert
@@ -87,6 +93,13 @@ namespace gl
 
 	typedef Details::DefaultMat3x3<float> Mat3;
 	typedef Details::DefaultMat4x4<float> Mat4;
+
+	typedef Details::DefaultVec2<double> DVec2;
+	typedef Details::DefaultVec3<double> DVec3;
+	typedef Details::DefaultVec4<double> DVec4;
+
+	typedef Details::DefaultMat3x3<double> DMat3;
+	typedef Details::DefaultMat4x4<double> DMat4;
 };
 
 
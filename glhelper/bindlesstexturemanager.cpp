@@ -0,0 +1,133 @@
+#include "bindlesstexturemanager.hpp"
+#include "texture.hpp"
+#include "samplerobject.hpp"
+#include "buffer.hpp"
+
+#include <limits>
+#include <string>
+
+namespace gl
+{
+	BindlessTextureManager::BindlessTextureManager(unsigned int _residencyBudget) :
+		m_residencyBudget(_residencyBudget),
+		m_currentFrame(0),
+		m_numEvictions(0),
+		m_lastBudgetWarningFrame(std::numeric_limits<std::uint64_t>::max())
+	{
+		GLHELPER_ASSERT(_residencyBudget > 0, "Residency budget needs to be at least one!");
+	}
+
+	BindlessTextureManager::~BindlessTextureManager()
+	{
+		for (auto& handle : m_handles)
+		{
+			if (handle.second.resident)
+				GL_CALL(glMakeTextureHandleNonResidentARB, handle.second.handle);
+		}
+	}
+
+	void BindlessTextureManager::BeginFrame()
+	{
+		++m_currentFrame;
+	}
+
+	GLuint64 BindlessTextureManager::RequestHandle(const Texture& _texture, const SamplerObject* _sampler)
+	{
+		SamplerId samplerId = _sampler ? _sampler->GetInternHandle() : 0;
+		auto it = m_handles.find(GetKey(_texture.GetInternHandle(), samplerId));
+		if (it == m_handles.end())
+		{
+			Handle newHandle;
+			if (_sampler)
+				newHandle.handle = GL_RET_CALL(glGetTextureSamplerHandleARB, _texture.GetInternHandle(), samplerId);
+			else
+				newHandle.handle = GL_RET_CALL(glGetTextureHandleARB, _texture.GetInternHandle());
+			newHandle.lastUsedFrame = m_currentFrame;
+			newHandle.resident = false;
+
+			if (newHandle.handle == 0)
+			{
+				GLHELPER_LOG_ERROR("Failed to create bindless handle for texture " + std::to_string(_texture.GetInternHandle()) + ".");
+				return 0;
+			}
+			it = m_handles.emplace(GetKey(_texture.GetInternHandle(), samplerId), newHandle).first;
+		}
+
+		Handle& handle = it->second;
+		handle.lastUsedFrame = m_currentFrame;
+		if (handle.resident)
+		{
+			// Move to front of LRU list.
+			m_residentHandles.splice(m_residentHandles.begin(), m_residentHandles, handle.lruPosition);
+		}
+		else
+		{
+			EvictToBudget(m_residencyBudget - 1);
+			GL_CALL(glMakeTextureHandleResidentARB, handle.handle);
+			handle.resident = true;
+			m_residentHandles.push_front(it->first);
+			handle.lruPosition = m_residentHandles.begin();
+		}
+
+		return handle.handle;
+	}
+
+	void BindlessTextureManager::WriteHandles(Buffer& _buffer, GLintptr _offset, const TextureSamplerPair* _textures, size_t _numTextures)
+	{
+		std::vector<GLuint64> handles(_numTextures);
+		for (size_t i = 0; i < _numTextures; ++i)
+			handles[i] = RequestHandle(*_textures[i].texture, _textures[i].sampler);
+
+		_buffer.Set(handles.data(), _offset, static_cast<GLsizeiptr>(handles.size() * sizeof(GLuint64)));
+	}
+
+	void BindlessTextureManager::ReleaseTexture(const Texture& _texture)
+	{
+		for (auto it = m_handles.begin(); it != m_handles.end();)
+		{
+			if (static_cast<TextureId>(it->first >> 32) == _texture.GetInternHandle())
+			{
+				if (it->second.resident)
+					MakeNonResident(it->second);
+				it = m_handles.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+	void BindlessTextureManager::SetResidencyBudget(unsigned int _residencyBudget)
+	{
+		GLHELPER_ASSERT(_residencyBudget > 0, "Residency budget needs to be at least one!");
+		m_residencyBudget = _residencyBudget;
+		EvictToBudget(m_residencyBudget);
+	}
+
+	void BindlessTextureManager::EvictToBudget(unsigned int _budget)
+	{
+		while (m_residentHandles.size() > _budget)
+		{
+			Handle& leastRecentlyUsed = m_handles[m_residentHandles.back()];
+			if (leastRecentlyUsed.lastUsedFrame == m_currentFrame)
+			{
+				// Everything left was requested in this frame and may be referenced by pending draws.
+				if (m_lastBudgetWarningFrame != m_currentFrame)
+				{
+					GLHELPER_LOG_WARNING("Bindless texture residency budget of " + std::to_string(m_residencyBudget) + " handles exceeded within a single frame.");
+					m_lastBudgetWarningFrame = m_currentFrame;
+				}
+				return;
+			}
+
+			MakeNonResident(leastRecentlyUsed);
+			++m_numEvictions;
+		}
+	}
+
+	void BindlessTextureManager::MakeNonResident(Handle& _handle)
+	{
+		GL_CALL(glMakeTextureHandleNonResidentARB, _handle.handle);
+		m_residentHandles.erase(_handle.lruPosition);
+		_handle.resident = false;
+	}
+}
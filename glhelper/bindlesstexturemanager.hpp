@@ -0,0 +1,101 @@
+#pragma once
+
+#include "gl.hpp"
+
+#include <unordered_map>
+#include <list>
+#include <vector>
+#include <cstdint>
+
+namespace gl
+{
+	class Texture;
+	class SamplerObject;
+	class Buffer;
+
+	/// Creates, caches and manages residency of bindless texture handles (ARB_bindless_texture).
+	///
+	/// Handles are created once per texture/sampler pair. Requested handles are made resident on demand. If more handles are resident than the residency budget allows,
+	/// the least recently requested handles that were not requested in the current frame are made non-resident.
+	/// Handles can be written into buffers (e.g. a shader storage buffer with a material table) and used in shaders as sampler via `sampler2D(handle)`.
+	///
+	/// \attention
+	///		Requires ARB_bindless_texture. Once a handle was created, the texture and sampler are immutable (no more parameter changes).
+	///		Call ReleaseTexture before destroying a texture that was used with this manager.
+	class BindlessTextureManager
+	{
+	public:
+		/// Texture and optional sampler, for writing several handles at once.
+		struct TextureSamplerPair
+		{
+			TextureSamplerPair(const Texture& _texture, const SamplerObject* _sampler = nullptr) : texture(&_texture), sampler(_sampler) {}
+
+			const Texture* texture;
+			const SamplerObject* sampler;
+		};
+
+		/// \param _residencyBudget
+		///		Maximum number of resident handles. Exceeded only if more handles are requested within a single frame.
+		BindlessTextureManager(unsigned int _residencyBudget = 4096);
+		/// Makes all handles non-resident.
+		~BindlessTextureManager();
+
+		BindlessTextureManager(const BindlessTextureManager&) = delete;
+		void operator = (const BindlessTextureManager&) = delete;
+
+		/// Starts a new frame. Handles requested before are allowed to be evicted again.
+		void BeginFrame();
+
+		/// Returns a resident handle for the texture with the given sampler, or with the texture's own sampling parameters if _sampler is nullptr.
+		///
+		/// Marks the handle as used in the current frame.
+		GLuint64 RequestHandle(const Texture& _texture, const SamplerObject* _sampler = nullptr);
+
+		/// Requests handles for all given pairs and writes them tightly packed (8 byte each) into the buffer starting at _offset.
+		void WriteHandles(Buffer& _buffer, GLintptr _offset, const TextureSamplerPair* _textures, size_t _numTextures);
+		/// \copydoc WriteHandles
+		void WriteHandles(Buffer& _buffer, GLintptr _offset, const std::vector<TextureSamplerPair>& _textures) { if (!_textures.empty()) WriteHandles(_buffer, _offset, _textures.data(), _textures.size()); }
+
+		/// Makes all handles of the given texture non-resident and forgets them.
+		///
+		/// Needs to be called before the texture is destroyed.
+		void ReleaseTexture(const Texture& _texture);
+
+		void SetResidencyBudget(unsigned int _residencyBudget);
+		unsigned int GetResidencyBudget() const { return m_residencyBudget; }
+
+		size_t GetNumHandles() const { return m_handles.size(); }
+		size_t GetNumResidentHandles() const { return m_residentHandles.size(); }
+
+		/// Number of handles that were made non-resident to stay within budget since construction.
+		std::uint64_t GetNumEvictions() const { return m_numEvictions; }
+
+	private:
+		typedef std::uint64_t Key;
+
+		struct Handle
+		{
+			GLuint64 handle;
+			std::uint64_t lastUsedFrame;
+			bool resident;
+			/// Position in m_residentHandles, only valid if resident.
+			std::list<Key>::iterator lruPosition;
+		};
+
+		static Key GetKey(TextureId _texture, SamplerId _sampler) { return (static_cast<Key>(_texture) << 32) | _sampler; }
+
+		/// Makes least recently used handles non-resident until the budget is met or only handles of the current frame are left.
+		void EvictToBudget(unsigned int _budget);
+		void MakeNonResident(Handle& _handle);
+
+		std::unordered_map<Key, Handle> m_handles;
+		/// Resident handles, most recently used first.
+		std::list<Key> m_residentHandles;
+
+		unsigned int m_residencyBudget;
+		std::uint64_t m_currentFrame;
+		std::uint64_t m_numEvictions;
+		/// Frame in which the budget was exceeded the last time, to warn only once per frame.
+		std::uint64_t m_lastBudgetWarningFrame;
+	};
+}
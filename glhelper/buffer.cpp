@@ -1,15 +1,9 @@
 #include "buffer.hpp"
+#include "context.hpp"
 #include "utils/flagoperators.hpp"
 
 namespace gl
 {
-	Buffer::BufferBinding Buffer::s_boundVertexBuffers[s_numVertexBufferBindings];
-	Buffer::BufferBinding Buffer::s_boundUBOs[s_numUBOBindings];
-	Buffer::BufferBinding Buffer::s_boundSSBOs[s_numSSBOBindings];
-	BufferId Buffer::s_boundIndexBuffer = 0;
-	BufferId Buffer::s_boundIndirectDrawBuffer = 0;
-	BufferId Buffer::s_boundIndirectDispatchBuffer = 0;
-
 	Buffer::Buffer(GLsizeiptr _sizeInBytes, UsageFlag _usageFlags, const void* _data) :
         m_sizeInBytes(_sizeInBytes),
 		m_usageFlags(_usageFlags),
@@ -74,28 +68,38 @@ namespace gl
 			// However this means, that glhelper's saved bindings are wrong.
 			// Iterating over all bindings is rather costly but reliable, easy and zero overhead for all other operations.
 			
-			if (s_boundIndexBuffer == m_bufferObject)
-				s_boundIndexBuffer = 0;
+			Context& context = Context::GetCurrent();
+			if (context.boundIndexBuffer == m_bufferObject)
+				context.boundIndexBuffer = 0;
+
+			if (context.boundIndirectDispatchBuffer == m_bufferObject)
+				context.boundIndirectDispatchBuffer = 0;
 
-			if (s_boundIndirectDispatchBuffer == m_bufferObject)
-				s_boundIndirectDispatchBuffer = 0;
+			if (context.boundPixelUnpackBuffer == m_bufferObject)
+				context.boundPixelUnpackBuffer = 0;
 
-			for (unsigned int i = 0; i < s_numVertexBufferBindings; ++i)
+			for (unsigned int i = 0; i < Context::s_numVertexBufferBindings; ++i)
 			{
-				if (s_boundVertexBuffers[i].bufferObject == m_bufferObject)
-					s_boundVertexBuffers[i].bufferObject = 0;
+				if (context.boundVertexBuffers[i].bufferObject == m_bufferObject)
+					context.boundVertexBuffers[i].bufferObject = 0;
 			}
 
-			for (unsigned int i = 0; i < s_numUBOBindings; ++i)
+			for (unsigned int i = 0; i < Context::s_numUBOBindings; ++i)
 			{
-				if (s_boundUBOs[i].bufferObject == m_bufferObject)
-					s_boundUBOs[i].bufferObject = 0;
+				if (context.boundUBOs[i].bufferObject == m_bufferObject)
+					context.boundUBOs[i].bufferObject = 0;
 			}
 			
-			for (unsigned int i = 0; i < s_numSSBOBindings; ++i)
+			for (unsigned int i = 0; i < Context::s_numSSBOBindings; ++i)
+			{
+				if (context.boundSSBOs[i].bufferObject == m_bufferObject)
+					context.boundSSBOs[i].bufferObject = 0;
+			}
+
+			for (unsigned int i = 0; i < Context::s_numAtomicCounterBufferBindings; ++i)
 			{
-				if (s_boundSSBOs[i].bufferObject == m_bufferObject)
-					s_boundSSBOs[i].bufferObject = 0;
+				if (context.boundAtomicCounterBuffers[i].bufferObject == m_bufferObject)
+					context.boundAtomicCounterBuffers[i].bufferObject = 0;
 			}			
 
 			GL_CALL(glDeleteBuffers, 1, &m_bufferObject);
@@ -239,76 +243,137 @@ namespace gl
 
 	void Buffer::BindVertexBuffer(BufferId _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizei _stride)
 	{
-		GLHELPER_ASSERT(_bindingIndex < s_numVertexBufferBindings, "Glhelper supports only " + std::to_string(s_numVertexBufferBindings) +
+		GLHELPER_ASSERT(_bindingIndex < Context::s_numVertexBufferBindings, "Glhelper supports only " + std::to_string(Context::s_numVertexBufferBindings) +
 			" bindings. See glGet with GL_MAX_VERTEX_ATTRIB_BINDINGS for actual hardware restrictions");
 
-		if (s_boundVertexBuffers[_bindingIndex].bufferObject != _buffer ||
-			s_boundVertexBuffers[_bindingIndex].offset != _offset ||
-			s_boundVertexBuffers[_bindingIndex].stride != _stride)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(VERTEX_BUFFER);
+		Context::BufferBinding& binding = Context::GetCurrent().boundVertexBuffers[_bindingIndex];
+		if (binding.bufferObject != _buffer ||
+			binding.offset != _offset ||
+			binding.stride != _stride)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(VERTEX_BUFFER);
 			GL_CALL(glBindVertexBuffer, _bindingIndex, _buffer, _offset, _stride);
-			s_boundVertexBuffers[_bindingIndex].bufferObject = _buffer;
-			s_boundVertexBuffers[_bindingIndex].offset = _offset;
-			s_boundVertexBuffers[_bindingIndex].stride = _stride;
+			binding.bufferObject = _buffer;
+			binding.offset = _offset;
+			binding.stride = _stride;
 		}
 	}
 
 	void Buffer::BindIndexBuffer()
 	{
-		if (s_boundIndexBuffer != m_bufferObject)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(INDEX_BUFFER);
+		BufferId& boundBuffer = Context::GetCurrent().boundIndexBuffer;
+		if (boundBuffer != m_bufferObject)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(INDEX_BUFFER);
 			GL_CALL(glBindBuffer, GL_ELEMENT_ARRAY_BUFFER, m_bufferObject);
-			s_boundIndexBuffer = m_bufferObject;
+			boundBuffer = m_bufferObject;
 		}
 	}
 
 	void Buffer::BindIndirectDrawBuffer()
 	{
-		if (s_boundIndirectDrawBuffer != m_bufferObject)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(INDIRECT_DRAW_BUFFER);
+		BufferId& boundBuffer = Context::GetCurrent().boundIndirectDrawBuffer;
+		if (boundBuffer != m_bufferObject)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(INDIRECT_DRAW_BUFFER);
 			GL_CALL(glBindBuffer, GL_DRAW_INDIRECT_BUFFER, m_bufferObject);
-			s_boundIndirectDrawBuffer = m_bufferObject;
+			boundBuffer = m_bufferObject;
 		}
 	}
 
 	void Buffer::BindIndirectDispatchBuffer()
 	{
-		if (s_boundIndirectDispatchBuffer != m_bufferObject)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(INDIRECT_DISPATCH_BUFFER);
+		BufferId& boundBuffer = Context::GetCurrent().boundIndirectDispatchBuffer;
+		if (boundBuffer != m_bufferObject)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(INDIRECT_DISPATCH_BUFFER);
 			GL_CALL(glBindBuffer, GL_DISPATCH_INDIRECT_BUFFER, m_bufferObject);
-			s_boundIndirectDispatchBuffer = m_bufferObject;
+			boundBuffer = m_bufferObject;
+		}
+	}
+
+	void Buffer::BindPixelUnpackBuffer()
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(PIXEL_UNPACK_BUFFER);
+		BufferId& boundBuffer = Context::GetCurrent().boundPixelUnpackBuffer;
+		if (boundBuffer != m_bufferObject)
+		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(PIXEL_UNPACK_BUFFER);
+			GL_CALL(glBindBuffer, GL_PIXEL_UNPACK_BUFFER, m_bufferObject);
+			boundBuffer = m_bufferObject;
+		}
+	}
+
+	void Buffer::UnbindPixelUnpackBuffer()
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(PIXEL_UNPACK_BUFFER);
+		BufferId& boundBuffer = Context::GetCurrent().boundPixelUnpackBuffer;
+		if (boundBuffer != 0)
+		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(PIXEL_UNPACK_BUFFER);
+			GL_CALL(glBindBuffer, GL_PIXEL_UNPACK_BUFFER, 0);
+			boundBuffer = 0;
 		}
 	}
 
 	void Buffer::BindUniformBuffer(BufferId _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size)
 	{
-		GLHELPER_ASSERT(_bindingIndex < s_numUBOBindings, "Glhelper supports only " + std::to_string(s_numUBOBindings) +
+		GLHELPER_ASSERT(_bindingIndex < Context::s_numUBOBindings, "Glhelper supports only " + std::to_string(Context::s_numUBOBindings) +
 			" UBO bindings. See glGet with GL_MAX_UNIFORM_BUFFER_BINDINGS for actual hardware restrictions");
 
-		if (s_boundUBOs[_bindingIndex].bufferObject != _buffer ||
-			s_boundUBOs[_bindingIndex].offset != _offset ||
-			s_boundUBOs[_bindingIndex].stride != _size)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(UNIFORM_BUFFER);
+		Context::BufferBinding& binding = Context::GetCurrent().boundUBOs[_bindingIndex];
+		if (binding.bufferObject != _buffer ||
+			binding.offset != _offset ||
+			binding.stride != _size)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(UNIFORM_BUFFER);
 			GL_CALL(glBindBufferRange, GL_UNIFORM_BUFFER, _bindingIndex, _buffer, _offset, _size);
-			s_boundUBOs[_bindingIndex].bufferObject = _buffer;
-			s_boundUBOs[_bindingIndex].offset = _offset;
-			s_boundUBOs[_bindingIndex].stride = _size;
+			binding.bufferObject = _buffer;
+			binding.offset = _offset;
+			binding.stride = _size;
 		}
 	}
 
 	void Buffer::BindShaderStorageBuffer(BufferId _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size)
 	{
-		GLHELPER_ASSERT(_bindingIndex < s_numSSBOBindings, "Glhelper supports only " + std::to_string(s_numSSBOBindings) +
+		GLHELPER_ASSERT(_bindingIndex < Context::s_numSSBOBindings, "Glhelper supports only " + std::to_string(Context::s_numSSBOBindings) +
 			" UBO bindings. See glGet with GL_MAX_COMBINED_SHADER_STORAGE_BLOCKS for actual hardware restrictions");
 
-		if (s_boundSSBOs[_bindingIndex].bufferObject != _buffer ||
-			s_boundSSBOs[_bindingIndex].offset != _offset ||
-			s_boundSSBOs[_bindingIndex].stride != _size)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(SHADER_STORAGE_BUFFER);
+		Context::BufferBinding& binding = Context::GetCurrent().boundSSBOs[_bindingIndex];
+		if (binding.bufferObject != _buffer ||
+			binding.offset != _offset ||
+			binding.stride != _size)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(SHADER_STORAGE_BUFFER);
 			GL_CALL(glBindBufferRange, GL_SHADER_STORAGE_BUFFER, _bindingIndex, _buffer, _offset, _size);
-			s_boundSSBOs[_bindingIndex].bufferObject = _buffer;
-			s_boundSSBOs[_bindingIndex].offset = _offset;
-			s_boundSSBOs[_bindingIndex].stride = _size;
+			binding.bufferObject = _buffer;
+			binding.offset = _offset;
+			binding.stride = _size;
+		}
+	}
+
+	void Buffer::BindAtomicCounterBuffer(BufferId _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size)
+	{
+		GLHELPER_ASSERT(_bindingIndex < Context::s_numAtomicCounterBufferBindings, "Glhelper supports only " + std::to_string(Context::s_numAtomicCounterBufferBindings) +
+			" atomic counter buffer bindings. See glGet with GL_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS for actual hardware restrictions");
+
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(ATOMIC_COUNTER_BUFFER);
+		Context::BufferBinding& binding = Context::GetCurrent().boundAtomicCounterBuffers[_bindingIndex];
+		if (binding.bufferObject != _buffer ||
+			binding.offset != _offset ||
+			binding.stride != _size)
+		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(ATOMIC_COUNTER_BUFFER);
+			GL_CALL(glBindBufferRange, GL_ATOMIC_COUNTER_BUFFER, _bindingIndex, _buffer, _offset, _size);
+			binding.bufferObject = _buffer;
+			binding.offset = _offset;
+			binding.stride = _size;
 		}
 	}
 }
@@ -204,11 +204,36 @@ namespace gl
 		static void BindShaderStorageBuffer(BufferId _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size);
 
 
+		/// \see Buffer::BindAtomicCounterBuffer
+		void BindAtomicCounterBuffer(GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size);
+		/// Binds entire buffer as atomic counter buffer.
+		/// \see Buffer::BindAtomicCounterBuffer
+		void BindAtomicCounterBuffer(GLuint _bindingIndex);
+
+		/// Binds as atomic counter buffer on a given slot if not already bound with the same parameters.
+		///
+		/// \param bindingIndex 
+		//		The index of the atomic counter buffer binding point to which to bind the buffer.
+		/// \param offset
+		///		The offset of the first element of the buffer.
+		/// \param size
+		///		The amount of data in machine units that can be read from the buffer object while used as an indexed target.
+		static void BindAtomicCounterBuffer(BufferId _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size);
+
+
 		/// Binds as indirect draw buffer if not already bound with the same parameters.
 		void BindIndirectDrawBuffer();
 		/// Binds as indirect dispatch buffer if not already bound with the same parameters.
 		void BindIndirectDispatchBuffer();
 
+		/// Binds as pixel unpack buffer if not already bound with the same parameters.
+		///
+		/// While a pixel unpack buffer is bound, all texture data pointers (e.g. in Texture2D::SetData) are interpreted as byte offsets into this buffer!
+		/// \see UnbindPixelUnpackBuffer
+		void BindPixelUnpackBuffer();
+		/// Unbinds any pixel unpack buffer if one is bound, so that texture uploads read from client memory again.
+		static void UnbindPixelUnpackBuffer();
+
     private:
 		friend class PersistentRingBuffer;
 
@@ -219,44 +244,6 @@ namespace gl
 		GLsizeiptr m_mappedDataSize;
 		GLintptr m_mappedDataOffset;
 		void* m_mappedData;
-
-		// -------------------------------------------------------------------------------
-		// Redundant binding checks for all types of buffer binding points.
-
-		/// Struct for general buffer bindings.
-		struct BufferBinding
-		{
-			BufferBinding() : bufferObject(0), offset(0), stride(0) {}
-
-			/// The bound buffer object.
-			BufferId bufferObject;
-			/// The offset of the first element of the buffer.
-			GLintptr offset;
-			/// The distance between elements within the buffer.
-			/// Might also be used as "size".
-			GLsizeiptr stride;
-		};
-
-		// Vertex Buffer
-		static const unsigned int s_numVertexBufferBindings = 16;
-		static BufferBinding s_boundVertexBuffers[s_numVertexBufferBindings];
-
-		// Index Buffer
-		static BufferId s_boundIndexBuffer;
-
-		// Uniform buffer
-		static const unsigned int s_numUBOBindings = 64;	/// Arbitrary value based on observation: http://delphigl.de/glcapsviewer/gl_stats_caps_single.php?listreportsbycap=GL_MAX_COMBINED_UNIFORM_BLOCKS
-		static BufferBinding s_boundUBOs[s_numUBOBindings];
-
-		// Shader Storage buffer
-		static const unsigned int s_numSSBOBindings = 16; /// Arbitrary value, based on observation: http://delphigl.de/glcapsviewer/gl_stats_caps_single.php?listreportsbycap=GL_MAX_COMBINED_SHADER_STORAGE_BLOCKS
-		static BufferBinding s_boundSSBOs[s_numSSBOBindings];
-
-		// Indirect Draw
-		static BufferId s_boundIndirectDrawBuffer;
-
-		// Indirect Dispatch
-		static BufferId s_boundIndirectDispatchBuffer;
     };
 
 	#include "buffer.inl"
@@ -32,4 +32,18 @@ inline void Buffer::BindShaderStorageBuffer(GLuint _bindingIndex)
 	GLHELPER_ASSERT((static_cast<unsigned int>(m_usageFlags)& gl::Buffer::UsageFlag::MAP_PERSISTENT) || m_mappedData == nullptr,
 		"Only persistent buffers can be bound while beeing mapped.");
 	Buffer::BindShaderStorageBuffer(m_bufferObject, _bindingIndex, 0, m_sizeInBytes);
-}
\ No newline at end of file
+}
+
+inline void Buffer::BindAtomicCounterBuffer(GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size)
+{
+	GLHELPER_ASSERT((static_cast<unsigned int>(m_usageFlags)& gl::Buffer::UsageFlag::MAP_PERSISTENT) || m_mappedData == nullptr,
+		"Only persistent buffers can be bound while beeing mapped.");
+	Buffer::BindAtomicCounterBuffer(m_bufferObject, _bindingIndex, _offset, _size);
+}
+
+inline void Buffer::BindAtomicCounterBuffer(GLuint _bindingIndex)
+{
+	GLHELPER_ASSERT((static_cast<unsigned int>(m_usageFlags)& gl::Buffer::UsageFlag::MAP_PERSISTENT) || m_mappedData == nullptr,
+		"Only persistent buffers can be bound while beeing mapped.");
+	Buffer::BindAtomicCounterBuffer(m_bufferObject, _bindingIndex, 0, m_sizeInBytes);
+}
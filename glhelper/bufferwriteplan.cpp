@@ -0,0 +1,118 @@
+#include "bufferwriteplan.hpp"
+#include "buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace gl
+{
+	template<typename VariableInfoType>
+	BufferWritePlan::BufferWritePlan(const BufferInfo<VariableInfoType>& _bufferInfo, std::initializer_list<std::string> _variableNames) :
+		m_sourceSize(0), m_destinationSize(0)
+	{
+		Build(_bufferInfo, _variableNames.begin(), _variableNames.end());
+	}
+
+	template<typename VariableInfoType>
+	BufferWritePlan::BufferWritePlan(const BufferInfo<VariableInfoType>& _bufferInfo, const std::vector<std::string>& _variableNames) :
+		m_sourceSize(0), m_destinationSize(0)
+	{
+		Build(_bufferInfo, _variableNames.begin(), _variableNames.end());
+	}
+
+	template<typename VariableInfoType, typename NameIterator>
+	void BufferWritePlan::Build(const BufferInfo<VariableInfoType>& _bufferInfo, NameIterator _namesBegin, NameIterator _namesEnd)
+	{
+		size_t sourceOffset = 0;
+		for (NameIterator name = _namesBegin; name != _namesEnd; ++name)
+		{
+			auto variableIt = _bufferInfo.variables.find(*name);
+			if (variableIt == _bufferInfo.variables.end())
+			{
+				GLHELPER_LOG_ERROR("Write plan: there is no variable named \"" + *name + "\" in the buffer block.");
+				continue;
+			}
+			const VariableInfoType& variable = variableIt->second;
+
+			ShaderVariableTypeLayout type;
+			if (!GetShaderVariableTypeLayout(variable.type, type))
+			{
+				GLHELPER_LOG_ERROR("Write plan: variable \"" + *name + "\" has a type that can not be written by a write plan.");
+				continue;
+			}
+			if (variable.arrayElementCount == 0)
+			{
+				GLHELPER_LOG_ERROR("Write plan: variable \"" + *name + "\" is a runtime sized array.");
+				continue;
+			}
+
+			// Natural alignment of the source member.
+			sourceOffset = (sourceOffset + type.componentSize - 1) / type.componentSize * type.componentSize;
+
+			// A matrix is a list of column (or row) vectors that may be padded in the block.
+			size_t numVectors = type.numColumns;
+			size_t vectorSize = type.componentSize * type.numRows;
+			if (variable.rowMajor && type.numColumns > 1)
+			{
+				numVectors = type.numRows;
+				vectorSize = type.componentSize * type.numColumns;
+			}
+			size_t vectorStride = (type.numColumns > 1 && variable.matrixStride > 0) ? variable.matrixStride : vectorSize;
+			size_t elementSize = type.GetPackedSize();
+			size_t elementStride = variable.arrayStride > 0 ? variable.arrayStride : elementSize;
+
+			for (std::int32_t element = 0; element < std::max(variable.arrayElementCount, 1); ++element)
+			{
+				size_t destinationOffset = variable.blockOffset + element * elementStride;
+				for (size_t vector = 0; vector < numVectors; ++vector)
+					AddCopyOperation(sourceOffset + vector * vectorSize, destinationOffset + vector * vectorStride, vectorSize);
+				sourceOffset += elementSize;
+			}
+		}
+		m_sourceSize = sourceOffset;
+
+		GLHELPER_ASSERT(m_destinationSize <= static_cast<size_t>(_bufferInfo.bufferDataSizeByte) || _bufferInfo.bufferDataSizeByte == 0, "Write plan exceeds the buffer block.");
+	}
+
+	template BufferWritePlan::BufferWritePlan(const BufferInfo<UniformVariableInfo>&, std::initializer_list<std::string>);
+	template BufferWritePlan::BufferWritePlan(const BufferInfo<BufferVariableInfo>&, std::initializer_list<std::string>);
+	template BufferWritePlan::BufferWritePlan(const BufferInfo<UniformVariableInfo>&, const std::vector<std::string>&);
+	template BufferWritePlan::BufferWritePlan(const BufferInfo<BufferVariableInfo>&, const std::vector<std::string>&);
+
+	void BufferWritePlan::AddCopyOperation(size_t _sourceOffset, size_t _destinationOffset, size_t _size)
+	{
+		if (!m_copyOperations.empty())
+		{
+			CopyOperation& previous = m_copyOperations.back();
+			if (previous.sourceOffset + previous.size == _sourceOffset && previous.destinationOffset + previous.size == _destinationOffset)
+			{
+				previous.size += _size;
+				m_destinationSize = std::max(m_destinationSize, _destinationOffset + _size);
+				return;
+			}
+		}
+
+		CopyOperation operation = { _sourceOffset, _destinationOffset, _size };
+		m_copyOperations.push_back(operation);
+		m_destinationSize = std::max(m_destinationSize, _destinationOffset + _size);
+	}
+
+	void BufferWritePlan::Apply(const void* _source, void* _destination) const
+	{
+		GLHELPER_ASSERT(_source != nullptr && _destination != nullptr, "Write plan source or destination is nullptr.");
+
+		const char* source = reinterpret_cast<const char*>(_source);
+		char* destination = reinterpret_cast<char*>(_destination);
+		for (const CopyOperation& operation : m_copyOperations)
+			memcpy(destination + operation.destinationOffset, source + operation.sourceOffset, operation.size);
+	}
+
+	void BufferWritePlan::Apply(const void* _source, Buffer& _buffer, GLintptr _bufferOffset) const
+	{
+		GLHELPER_ASSERT(_source != nullptr, "Write plan source is nullptr.");
+
+		const char* source = reinterpret_cast<const char*>(_source);
+		for (const CopyOperation& operation : m_copyOperations)
+			_buffer.Set(source + operation.sourceOffset, _bufferOffset + operation.destinationOffset, operation.size);
+	}
+}
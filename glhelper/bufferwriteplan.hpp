@@ -0,0 +1,74 @@
+#pragma once
+
+#include "shaderdatametainfo.hpp"
+
+#include <vector>
+#include <string>
+#include <initializer_list>
+
+namespace gl
+{
+	class Buffer;
+
+	/// Precomputed list of copy operations for filling a buffer block from a packed CPU-side struct.
+	///
+	/// Setting many variables via BufferInfoView costs a hash lookup and a small copy per variable.
+	/// A write plan resolves all offsets once on construction and merges operations that are contiguous both in source and destination.
+	/// If the source struct matches the block layout, applying the plan is a single memcpy.
+	///
+	/// The source struct contains all listed variables in the given order, without any padding besides the natural alignment of the component type,
+	/// i.e. a struct with members of type float, gl::Vec3, gl::Mat4, std::int32_t[N] etc. is expected. Bools are represented by 32 bit integers.
+	/// Matrices are expected with the same majority as in the shader.
+	class BufferWritePlan
+	{
+	public:
+		/// Creates an empty plan.
+		BufferWritePlan() : m_sourceSize(0), m_destinationSize(0) {}
+
+		/// Creates a plan for the given variables of a block.
+		///
+		/// Unknown variables or variables with unsupported types are reported as error and skipped (the source offset is not advanced).
+		/// \param _variableNames
+		///		Variable names as reflected (arrays with "[0]" suffix), in order of appearance in the source struct.
+		template<typename VariableInfoType>
+		BufferWritePlan(const BufferInfo<VariableInfoType>& _bufferInfo, std::initializer_list<std::string> _variableNames);
+		template<typename VariableInfoType>
+		BufferWritePlan(const BufferInfo<VariableInfoType>& _bufferInfo, const std::vector<std::string>& _variableNames);
+
+		/// Copies the source struct to memory that represents the block (e.g. mapped memory or a staging copy of the block).
+		void Apply(const void* _source, void* _destination) const;
+
+		/// Writes the source struct into a buffer using Buffer::Set for each merged copy operation.
+		///
+		/// \param _bufferOffset
+		///		Offset of the block within the buffer.
+		void Apply(const void* _source, Buffer& _buffer, GLintptr _bufferOffset = 0) const;
+
+		/// Size of the expected source struct in bytes (without trailing padding).
+		size_t GetSourceSize() const { return m_sourceSize; }
+
+		/// Size of the touched destination memory in bytes, starting from the block's start.
+		size_t GetDestinationSize() const { return m_destinationSize; }
+
+		/// Number of copy operations after merging.
+		size_t GetNumCopyOperations() const { return m_copyOperations.size(); }
+
+	private:
+		template<typename VariableInfoType, typename NameIterator>
+		void Build(const BufferInfo<VariableInfoType>& _bufferInfo, NameIterator _namesBegin, NameIterator _namesEnd);
+
+		/// Adds a copy operation, merges it with the previous if possible.
+		void AddCopyOperation(size_t _sourceOffset, size_t _destinationOffset, size_t _size);
+
+		struct CopyOperation
+		{
+			size_t sourceOffset;
+			size_t destinationOffset;
+			size_t size;
+		};
+		std::vector<CopyOperation> m_copyOperations;
+
+		size_t m_sourceSize;
+		size_t m_destinationSize;
+	};
+}
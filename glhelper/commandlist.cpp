@@ -0,0 +1,414 @@
+#include "commandlist.hpp"
+#include "buffer.hpp"
+#include "texture.hpp"
+#include "samplerobject.hpp"
+#include "shaderobject.hpp"
+#include "vertexarrayobject.hpp"
+#include "framebufferobject.hpp"
+#include "pipelinestate.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace gl
+{
+	namespace
+	{
+		enum class CommandType : std::uint32_t
+		{
+			ACTIVATE_SHADER,
+			BIND_VERTEX_ARRAY,
+			BIND_VERTEX_BUFFER,
+			BIND_INDEX_BUFFER,
+			BIND_INDIRECT_DRAW_BUFFER,
+			BIND_UNIFORM_BUFFER,
+			BIND_SHADER_STORAGE_BUFFER,
+			BIND_TEXTURE,
+			BIND_SAMPLER,
+			BIND_FRAMEBUFFER,
+			BIND_BACKBUFFER,
+			APPLY_PIPELINE_STATE,
+			ENABLE,
+			DISABLE,
+			SET_VIEWPORT,
+			SET_BUFFER_DATA,
+			DRAW_ARRAYS,
+			DRAW_ELEMENTS,
+			DRAW_ARRAYS_INDIRECT,
+			DRAW_ELEMENTS_INDIRECT,
+			DISPATCH,
+			MEMORY_BARRIER
+		};
+
+		struct CommandHeader
+		{
+			CommandType type;
+			/// Size of header, payload and extra data in 8 byte words.
+			std::uint32_t numWords;
+		};
+		static_assert(sizeof(CommandHeader) == sizeof(std::uint64_t), "Command header needs to fill exactly one word.");
+
+		struct EmptyPayload {};
+
+		template<typename T>
+		struct PointerPayload
+		{
+			T* object;
+		};
+
+		struct BufferRangePayload
+		{
+			GLintptr offset;
+			GLsizeiptr size;
+			BufferId buffer;
+			GLuint bindingIndex;
+		};
+
+		struct SlotPayload
+		{
+			const void* object;
+			GLuint slot;
+		};
+
+		struct FramebufferPayload
+		{
+			FramebufferObject* framebuffer;
+			bool autoViewportSet;
+		};
+
+		struct ViewportPayload
+		{
+			GLfloat x, y, width, height;
+		};
+
+		struct BufferDataPayload
+		{
+			Buffer* buffer;
+			GLintptr offset;
+			GLsizeiptr numBytes;
+		};
+
+		struct DrawArraysPayload
+		{
+			GLenum primitiveType;
+			GLint first;
+			GLsizei count;
+			GLsizei instanceCount;
+			GLuint baseInstance;
+		};
+
+		struct DrawElementsPayload
+		{
+			GLintptr offset;
+			GLenum primitiveType;
+			GLsizei count;
+			GLenum indexType;
+			GLsizei instanceCount;
+			GLint baseVertex;
+			GLuint baseInstance;
+		};
+
+		struct DrawIndirectPayload
+		{
+			GLintptr offset;
+			GLenum primitiveType;
+			GLenum indexType;
+		};
+
+		struct DispatchPayload
+		{
+			const ShaderObject* program;
+			GLuint totalInvocations[3];
+		};
+	}
+
+	CommandList::CommandList(size_t _reservedBytes) :
+		m_data((_reservedBytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t)),
+		m_numWords(0),
+		m_numCommands(0)
+	{
+	}
+
+	void CommandList::Clear()
+	{
+		m_numWords = 0;
+		m_numCommands = 0;
+	}
+
+	template<typename Payload>
+	void* CommandList::Push(std::uint32_t _type, const Payload& _payload, size_t _extraBytes)
+	{
+		const size_t numWords = (sizeof(CommandHeader) + sizeof(Payload) + _extraBytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+		if (m_numWords + numWords > m_data.size())
+			m_data.resize(std::max(m_data.size() * 2, m_numWords + numWords));
+
+		std::uint8_t* command = reinterpret_cast<std::uint8_t*>(&m_data[m_numWords]);
+		CommandHeader header = { static_cast<CommandType>(_type), static_cast<std::uint32_t>(numWords) };
+		memcpy(command, &header, sizeof(header));
+		memcpy(command + sizeof(header), &_payload, sizeof(Payload));
+
+		m_numWords += numWords;
+		++m_numCommands;
+		return command + sizeof(header) + sizeof(Payload);
+	}
+
+	#define PUSH_COMMAND(type, payload) Push(static_cast<std::uint32_t>(CommandType::type), payload)
+
+	void CommandList::ActivateShader(const ShaderObject& _program)
+	{
+		PointerPayload<const ShaderObject> payload = { &_program };
+		PUSH_COMMAND(ACTIVATE_SHADER, payload);
+	}
+
+	void CommandList::BindVertexArray(VertexArrayObject& _vertexArray)
+	{
+		PointerPayload<VertexArrayObject> payload = { &_vertexArray };
+		PUSH_COMMAND(BIND_VERTEX_ARRAY, payload);
+	}
+
+	void CommandList::BindVertexBuffer(const Buffer& _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizei _stride)
+	{
+		BufferRangePayload payload = { _offset, _stride, _buffer.GetInternHandle(), _bindingIndex };
+		PUSH_COMMAND(BIND_VERTEX_BUFFER, payload);
+	}
+
+	void CommandList::BindIndexBuffer(Buffer& _buffer)
+	{
+		PointerPayload<Buffer> payload = { &_buffer };
+		PUSH_COMMAND(BIND_INDEX_BUFFER, payload);
+	}
+
+	void CommandList::BindIndirectDrawBuffer(Buffer& _buffer)
+	{
+		PointerPayload<Buffer> payload = { &_buffer };
+		PUSH_COMMAND(BIND_INDIRECT_DRAW_BUFFER, payload);
+	}
+
+	void CommandList::BindUniformBuffer(const Buffer& _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size)
+	{
+		BufferRangePayload payload = { _offset, _size, _buffer.GetInternHandle(), _bindingIndex };
+		PUSH_COMMAND(BIND_UNIFORM_BUFFER, payload);
+	}
+
+	void CommandList::BindShaderStorageBuffer(const Buffer& _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size)
+	{
+		BufferRangePayload payload = { _offset, _size, _buffer.GetInternHandle(), _bindingIndex };
+		PUSH_COMMAND(BIND_SHADER_STORAGE_BUFFER, payload);
+	}
+
+	void CommandList::BindTexture(const Texture& _texture, GLuint _slotIndex)
+	{
+		SlotPayload payload = { &_texture, _slotIndex };
+		PUSH_COMMAND(BIND_TEXTURE, payload);
+	}
+
+	void CommandList::BindSampler(const SamplerObject& _sampler, GLuint _textureStage)
+	{
+		SlotPayload payload = { &_sampler, _textureStage };
+		PUSH_COMMAND(BIND_SAMPLER, payload);
+	}
+
+	void CommandList::BindFramebuffer(FramebufferObject& _framebuffer, bool _autoViewportSet)
+	{
+		FramebufferPayload payload = { &_framebuffer, _autoViewportSet };
+		PUSH_COMMAND(BIND_FRAMEBUFFER, payload);
+	}
+
+	void CommandList::BindBackBuffer()
+	{
+		PUSH_COMMAND(BIND_BACKBUFFER, EmptyPayload());
+	}
+
+	void CommandList::ApplyPipelineState(PipelineStateId _id)
+	{
+		PUSH_COMMAND(APPLY_PIPELINE_STATE, _id);
+	}
+
+	void CommandList::Enable(Cap _cap)
+	{
+		PUSH_COMMAND(ENABLE, _cap);
+	}
+
+	void CommandList::Disable(Cap _cap)
+	{
+		PUSH_COMMAND(DISABLE, _cap);
+	}
+
+	void CommandList::SetViewport(GLfloat _x, GLfloat _y, GLfloat _width, GLfloat _height)
+	{
+		ViewportPayload payload = { _x, _y, _width, _height };
+		PUSH_COMMAND(SET_VIEWPORT, payload);
+	}
+
+	void CommandList::SetBufferData(Buffer& _buffer, const void* _data, GLintptr _offset, GLsizeiptr _numBytes)
+	{
+		GLHELPER_ASSERT(_numBytes > 0, "Buffer data command without data!");
+		BufferDataPayload payload = { &_buffer, _offset, _numBytes };
+		void* data = Push(static_cast<std::uint32_t>(CommandType::SET_BUFFER_DATA), payload, static_cast<size_t>(_numBytes));
+		memcpy(data, _data, static_cast<size_t>(_numBytes));
+	}
+
+	void CommandList::DrawArrays(GLenum _primitiveType, GLint _first, GLsizei _count, GLsizei _instanceCount, GLuint _baseInstance)
+	{
+		DrawArraysPayload payload = { _primitiveType, _first, _count, _instanceCount, _baseInstance };
+		PUSH_COMMAND(DRAW_ARRAYS, payload);
+	}
+
+	void CommandList::DrawElements(GLenum _primitiveType, GLsizei _count, GLenum _indexType, GLintptr _offset, GLsizei _instanceCount, GLint _baseVertex, GLuint _baseInstance)
+	{
+		DrawElementsPayload payload = { _offset, _primitiveType, _count, _indexType, _instanceCount, _baseVertex, _baseInstance };
+		PUSH_COMMAND(DRAW_ELEMENTS, payload);
+	}
+
+	void CommandList::DrawArraysIndirect(GLenum _primitiveType, GLintptr _offset)
+	{
+		DrawIndirectPayload payload = { _offset, _primitiveType, GL_NONE };
+		PUSH_COMMAND(DRAW_ARRAYS_INDIRECT, payload);
+	}
+
+	void CommandList::DrawElementsIndirect(GLenum _primitiveType, GLenum _indexType, GLintptr _offset)
+	{
+		DrawIndirectPayload payload = { _offset, _primitiveType, _indexType };
+		PUSH_COMMAND(DRAW_ELEMENTS_INDIRECT, payload);
+	}
+
+	void CommandList::Dispatch(const ShaderObject& _program, GLuint _totalInvocationsX, GLuint _totalInvocationsY, GLuint _totalInvocationsZ)
+	{
+		DispatchPayload payload = { &_program, { _totalInvocationsX, _totalInvocationsY, _totalInvocationsZ } };
+		PUSH_COMMAND(DISPATCH, payload);
+	}
+
+	void CommandList::InsertMemoryBarrier(GLbitfield _barriers)
+	{
+		PUSH_COMMAND(MEMORY_BARRIER, _barriers);
+	}
+
+	#undef PUSH_COMMAND
+
+	void CommandList::Execute() const
+	{
+		const std::uint64_t* command = m_data.data();
+		const std::uint64_t* end = command + m_numWords;
+		while (command != end)
+		{
+			const CommandHeader& header = *reinterpret_cast<const CommandHeader*>(command);
+			const void* payload = command + 1;
+
+			switch (header.type)
+			{
+			case CommandType::ACTIVATE_SHADER:
+				static_cast<const PointerPayload<const ShaderObject>*>(payload)->object->Activate();
+				break;
+			case CommandType::BIND_VERTEX_ARRAY:
+				static_cast<const PointerPayload<VertexArrayObject>*>(payload)->object->Bind();
+				break;
+			case CommandType::BIND_VERTEX_BUFFER:
+			{
+				const BufferRangePayload& binding = *static_cast<const BufferRangePayload*>(payload);
+				Buffer::BindVertexBuffer(binding.buffer, binding.bindingIndex, binding.offset, static_cast<GLsizei>(binding.size));
+				break;
+			}
+			case CommandType::BIND_INDEX_BUFFER:
+				static_cast<const PointerPayload<Buffer>*>(payload)->object->BindIndexBuffer();
+				break;
+			case CommandType::BIND_INDIRECT_DRAW_BUFFER:
+				static_cast<const PointerPayload<Buffer>*>(payload)->object->BindIndirectDrawBuffer();
+				break;
+			case CommandType::BIND_UNIFORM_BUFFER:
+			{
+				const BufferRangePayload& binding = *static_cast<const BufferRangePayload*>(payload);
+				Buffer::BindUniformBuffer(binding.buffer, binding.bindingIndex, binding.offset, binding.size);
+				break;
+			}
+			case CommandType::BIND_SHADER_STORAGE_BUFFER:
+			{
+				const BufferRangePayload& binding = *static_cast<const BufferRangePayload*>(payload);
+				Buffer::BindShaderStorageBuffer(binding.buffer, binding.bindingIndex, binding.offset, binding.size);
+				break;
+			}
+			case CommandType::BIND_TEXTURE:
+			{
+				const SlotPayload& binding = *static_cast<const SlotPayload*>(payload);
+				static_cast<const Texture*>(binding.object)->Bind(binding.slot);
+				break;
+			}
+			case CommandType::BIND_SAMPLER:
+			{
+				const SlotPayload& binding = *static_cast<const SlotPayload*>(payload);
+				static_cast<const SamplerObject*>(binding.object)->BindSampler(binding.slot);
+				break;
+			}
+			case CommandType::BIND_FRAMEBUFFER:
+			{
+				const FramebufferPayload& binding = *static_cast<const FramebufferPayload*>(payload);
+				binding.framebuffer->Bind(binding.autoViewportSet);
+				break;
+			}
+			case CommandType::BIND_BACKBUFFER:
+				FramebufferObject::BindBackBuffer();
+				break;
+			case CommandType::APPLY_PIPELINE_STATE:
+				gl::ApplyPipelineState(*static_cast<const PipelineStateId*>(payload));
+				break;
+			case CommandType::ENABLE:
+				gl::Enable(*static_cast<const Cap*>(payload));
+				break;
+			case CommandType::DISABLE:
+				gl::Disable(*static_cast<const Cap*>(payload));
+				break;
+			case CommandType::SET_VIEWPORT:
+			{
+				const ViewportPayload& viewport = *static_cast<const ViewportPayload*>(payload);
+				gl::SetViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+				FlushViewportState();
+				break;
+			}
+			case CommandType::SET_BUFFER_DATA:
+			{
+				const BufferDataPayload& bufferData = *static_cast<const BufferDataPayload*>(payload);
+				bufferData.buffer->Set(&bufferData + 1, bufferData.offset, bufferData.numBytes);
+				break;
+			}
+			case CommandType::DRAW_ARRAYS:
+			{
+				const DrawArraysPayload& draw = *static_cast<const DrawArraysPayload*>(payload);
+				GL_CALL(glDrawArraysInstancedBaseInstance, draw.primitiveType, draw.first, draw.count, draw.instanceCount, draw.baseInstance);
+				break;
+			}
+			case CommandType::DRAW_ELEMENTS:
+			{
+				const DrawElementsPayload& draw = *static_cast<const DrawElementsPayload*>(payload);
+				GL_CALL(glDrawElementsInstancedBaseVertexBaseInstance, draw.primitiveType, draw.count, draw.indexType, reinterpret_cast<const void*>(draw.offset),
+														draw.instanceCount, draw.baseVertex, draw.baseInstance);
+				break;
+			}
+			case CommandType::DRAW_ARRAYS_INDIRECT:
+			{
+				const DrawIndirectPayload& draw = *static_cast<const DrawIndirectPayload*>(payload);
+				GL_CALL(glDrawArraysIndirect, draw.primitiveType, reinterpret_cast<const void*>(draw.offset));
+				break;
+			}
+			case CommandType::DRAW_ELEMENTS_INDIRECT:
+			{
+				const DrawIndirectPayload& draw = *static_cast<const DrawIndirectPayload*>(payload);
+				GL_CALL(glDrawElementsIndirect, draw.primitiveType, draw.indexType, reinterpret_cast<const void*>(draw.offset));
+				break;
+			}
+			case CommandType::DISPATCH:
+			{
+				const DispatchPayload& dispatch = *static_cast<const DispatchPayload*>(payload);
+				dispatch.program->Dispatch(dispatch.totalInvocations[0], dispatch.totalInvocations[1], dispatch.totalInvocations[2]);
+				break;
+			}
+			case CommandType::MEMORY_BARRIER:
+				GL_CALL(glMemoryBarrier, *static_cast<const GLbitfield*>(payload));
+				break;
+			default:
+				GLHELPER_ASSERT(false, "Unknown command type in command list!");
+				break;
+			}
+
+			command += header.numWords;
+		}
+	}
+}
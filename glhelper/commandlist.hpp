@@ -0,0 +1,101 @@
+#pragma once
+
+#include "gl.hpp"
+#include "statemanagement.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace gl
+{
+	class Buffer;
+	class Texture;
+	class SamplerObject;
+	class ShaderObject;
+	class VertexArrayObject;
+	class FramebufferObject;
+
+	/// Records glhelper commands into a linear byte stream for later execution.
+	///
+	/// Recording does not call OpenGL or touch any context state, therefore any number of threads can record into their own lists concurrently.
+	/// The thread with the OpenGL context then calls Execute on all lists in the desired order. Execution goes through the usual
+	/// redundancy checked functions (Activate, Bind..., Enable, ApplyPipelineState ...).
+	///
+	/// Clear keeps the allocated memory, so once a list has reached its typical size, recording does not allocate anymore.
+	/// \attention
+	///		Only pointers are recorded for all objects. They need to stay alive until the list was executed.
+	class CommandList
+	{
+	public:
+		/// \param _reservedBytes
+		///		Initial size of the command stream.
+		CommandList(size_t _reservedBytes = 4096);
+
+		/// Removes all commands. Keeps the allocated memory.
+		void Clear();
+
+		/// Executes all commands in recording order. Needs to be called from the thread with the OpenGL context.
+		void Execute() const;
+
+		/// Returns the number of recorded commands.
+		size_t GetNumCommands() const { return m_numCommands; }
+		/// Returns the size of the command stream in bytes.
+		size_t GetSize() const { return m_numWords * sizeof(std::uint64_t); }
+
+
+		// Bindings
+
+		void ActivateShader(const ShaderObject& _program);
+		void BindVertexArray(VertexArrayObject& _vertexArray);
+		void BindVertexBuffer(const Buffer& _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizei _stride);
+		void BindIndexBuffer(Buffer& _buffer);
+		void BindIndirectDrawBuffer(Buffer& _buffer);
+		void BindUniformBuffer(const Buffer& _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size);
+		void BindShaderStorageBuffer(const Buffer& _buffer, GLuint _bindingIndex, GLintptr _offset, GLsizeiptr _size);
+		void BindTexture(const Texture& _texture, GLuint _slotIndex);
+		void BindSampler(const SamplerObject& _sampler, GLuint _textureStage);
+		void BindFramebuffer(FramebufferObject& _framebuffer, bool _autoViewportSet);
+		void BindBackBuffer();
+
+		// States
+
+		void ApplyPipelineState(PipelineStateId _id);
+		void Enable(Cap _cap);
+		void Disable(Cap _cap);
+		/// Sets the viewport of all viewport indices and flushes the viewport state.
+		void SetViewport(GLfloat _x, GLfloat _y, GLfloat _width, GLfloat _height);
+
+		// Data
+
+		/// Copies the given data into the command stream and writes it to the buffer on execution (Buffer::Set).
+		///
+		/// Meant for small updates like uniform buffer contents.
+		void SetBufferData(Buffer& _buffer, const void* _data, GLintptr _offset, GLsizeiptr _numBytes);
+
+		// Draws & dispatches
+
+		void DrawArrays(GLenum _primitiveType, GLint _first, GLsizei _count, GLsizei _instanceCount = 1, GLuint _baseInstance = 0);
+		/// \param _offset
+		///		Offset in bytes into the bound index buffer.
+		void DrawElements(GLenum _primitiveType, GLsizei _count, GLenum _indexType, GLintptr _offset, GLsizei _instanceCount = 1, GLint _baseVertex = 0, GLuint _baseInstance = 0);
+		/// Uses the bound indirect draw buffer.
+		void DrawArraysIndirect(GLenum _primitiveType, GLintptr _offset);
+		/// Uses the bound indirect draw buffer.
+		void DrawElementsIndirect(GLenum _primitiveType, GLenum _indexType, GLintptr _offset);
+		/// Activates the program and dispatches, see ShaderObject::Dispatch.
+		void Dispatch(const ShaderObject& _program, GLuint _totalInvocationsX, GLuint _totalInvocationsY = 1, GLuint _totalInvocationsZ = 1);
+		/// Issues glMemoryBarrier.
+		void InsertMemoryBarrier(GLbitfield _barriers);
+
+	private:
+		/// Appends a command with given payload and _extraBytes of additional data. Returns pointer to the additional data.
+		template<typename Payload>
+		void* Push(std::uint32_t _type, const Payload& _payload, size_t _extraBytes = 0);
+
+		/// Command stream, 8 byte words keep all payloads aligned. Is only ever enlarged.
+		std::vector<std::uint64_t> m_data;
+		/// Number of used words in m_data.
+		size_t m_numWords;
+		size_t m_numCommands;
+	};
+}
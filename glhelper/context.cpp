@@ -0,0 +1,80 @@
+#include "context.hpp"
+#include "pipelinestate.hpp"
+
+namespace gl
+{
+	namespace
+	{
+		/// Created on first use and intentionally leaked: constant initialized and trivially destructible, therefore safe to use during static initialization and destruction.
+		std::atomic<Context*> s_defaultContext(nullptr);
+	}
+
+	namespace Details
+	{
+		GLHELPER_THREAD_LOCAL Context* CurrentContext = nullptr;
+
+		Context& InitCurrentContext()
+		{
+			CurrentContext = &Context::GetDefault();
+			return *CurrentContext;
+		}
+	}
+
+	Context::Context() :
+		boundIndexBuffer(0),
+		boundIndirectDrawBuffer(0),
+		boundIndirectDispatchBuffer(0),
+		boundPixelUnpackBuffer(0),
+		boundVertexArray(nullptr),
+		boundFramebuffer(0),
+		activeShaderObject(nullptr),
+		boundProgramPipeline(0),
+		currentPipelineState(InvalidPipelineStateId),
+		m_numCurrentThreads(0)
+	{
+		for (unsigned int i = 0; i < Texture::s_numTextureBindings; ++i)
+		{
+			boundTextures[i] = 0;
+			samplerBindings[i] = nullptr;
+		}
+	}
+
+	Context::~Context()
+	{
+		GLHELPER_ASSERT(this != s_defaultContext.load(), "The default context must not be destroyed!");
+
+		if (Details::CurrentContext == this)
+			GetDefault().MakeCurrent();
+		GLHELPER_ASSERT(m_numCurrentThreads == 0, "Context is destroyed while it is still current on " + std::to_string(m_numCurrentThreads) + " other thread(s)!");
+	}
+
+	void Context::MakeCurrent()
+	{
+		Context& current = GetCurrent();
+		if (&current == this)
+			return;
+
+		// The default context is implicitly current on all threads, its count is not maintained.
+		Context& defaultContext = GetDefault();
+		if (&current != &defaultContext)
+			--current.m_numCurrentThreads;
+		if (this != &defaultContext)
+			++m_numCurrentThreads;
+		Details::CurrentContext = this;
+	}
+
+	Context& Context::GetDefault()
+	{
+		// No function local static, since VS2013 does not initialize those thread safe.
+		Context* defaultContext = s_defaultContext.load();
+		if (!defaultContext)
+		{
+			Context* newContext = new Context();
+			if (s_defaultContext.compare_exchange_strong(defaultContext, newContext))
+				defaultContext = newContext;
+			else
+				delete newContext; // Another thread was faster, defaultContext holds its context now.
+		}
+		return *defaultContext;
+	}
+}
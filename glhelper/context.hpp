@@ -0,0 +1,161 @@
+#pragma once
+
+#include "gl.hpp"
+#include "statemanagement.hpp"
+#include "statechangestatistics.hpp"
+#include "texture.hpp"
+#include "shaderstagecache.hpp"
+
+#include <atomic>
+
+/// Storage class for variables with one instance per thread. VS2013 does not support the C++11 keyword.
+#if defined(_MSC_VER) && _MSC_VER < 1900
+	#define GLHELPER_THREAD_LOCAL __declspec(thread)
+#else
+	#define GLHELPER_THREAD_LOCAL thread_local
+#endif
+
+namespace gl
+{
+	class Context;
+	class VertexArrayObject;
+	class ShaderObject;
+	class SamplerObject;
+
+	namespace Details
+	{
+		/// Context that is current on this thread, see Context::MakeCurrent. nullptr until the thread first accesses its context.
+		extern GLHELPER_THREAD_LOCAL Context* CurrentContext;
+
+		/// Makes the default context current on a thread that has no current context yet.
+		Context& InitCurrentContext();
+	}
+
+	/// All OpenGL state that glhelper caches to avoid redundant calls: object bindings and the state tables of statemanagement.hpp.
+	///
+	/// Create one Context for every OpenGL context and make it current whenever the OpenGL context is made current on a thread (e.g. after wglMakeCurrent).
+	/// The current context is stored per thread, therefore several threads with their own OpenGL context (e.g. an upload thread) each get correct redundancy checks.
+	/// Threads that never made a Context current use the default context. This allows single context applications to ignore this class entirely.
+	/// The default context is created on first use and never destroyed, so glhelper objects with static storage duration can be created and destroyed at any time.
+	///
+	/// \attention
+	///		Deleting an OpenGL object removes it only from the binding tables of the current context.
+	///		If objects are deleted while they are bound in another context, call the respective Reset function there or use force where available.
+	class Context
+	{
+	public:
+		/// Creates a context with the bindings and states of a newly created OpenGL context.
+		Context();
+		/// If this context is current on the calling thread, the default context becomes current instead.
+		///
+		/// \attention
+		///		The context must not be current on any other thread anymore, since these threads would keep a dangling pointer (asserted).
+		///		Make another context current on them first, e.g. Context::GetDefault().MakeCurrent() before a thread exits.
+		~Context();
+
+		Context(const Context&) = delete;
+		void operator = (const Context&) = delete;
+
+		/// Makes this the current context of the calling thread.
+		///
+		/// Does not make any OpenGL context current, use your platform's functions for this.
+		void MakeCurrent();
+
+		/// Returns the context that is current on the calling thread.
+		static Context& GetCurrent()
+		{
+			Context* context = Details::CurrentContext;
+			return context ? *context : Details::InitCurrentContext();
+		}
+
+		/// Returns the default context, which is current on all threads that did not call MakeCurrent.
+		///
+		/// Created on first use and never destroyed.
+		static Context& GetDefault();
+
+
+		// -------------------------------------------------------------------------------
+		// Binding tables.
+		// Used by the respective wrapper classes, usually there is no need to access them directly.
+
+		/// Struct for general buffer bindings.
+		struct BufferBinding
+		{
+			BufferBinding() : bufferObject(0), offset(0), stride(0) {}
+
+			/// The bound buffer object.
+			BufferId bufferObject;
+			/// The offset of the first element of the buffer.
+			GLintptr offset;
+			/// The distance between elements within the buffer.
+			/// Might also be used as "size".
+			GLsizeiptr stride;
+		};
+
+		// Vertex Buffer
+		static const unsigned int s_numVertexBufferBindings = 16;
+		BufferBinding boundVertexBuffers[s_numVertexBufferBindings];
+
+		// Index Buffer
+		BufferId boundIndexBuffer;
+
+		// Uniform buffer
+		static const unsigned int s_numUBOBindings = 64;	/// Arbitrary value based on observation: http://delphigl.de/glcapsviewer/gl_stats_caps_single.php?listreportsbycap=GL_MAX_COMBINED_UNIFORM_BLOCKS
+		BufferBinding boundUBOs[s_numUBOBindings];
+
+		// Shader Storage buffer
+		static const unsigned int s_numSSBOBindings = 16; /// Arbitrary value, based on observation: http://delphigl.de/glcapsviewer/gl_stats_caps_single.php?listreportsbycap=GL_MAX_COMBINED_SHADER_STORAGE_BLOCKS
+		BufferBinding boundSSBOs[s_numSSBOBindings];
+
+		// Atomic counter buffer
+		static const unsigned int s_numAtomicCounterBufferBindings = 8; /// Arbitrary value, based on observation: http://delphigl.de/glcapsviewer/gl_stats_caps_single.php?listreportsbycap=GL_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS
+		BufferBinding boundAtomicCounterBuffers[s_numAtomicCounterBufferBindings];
+
+		// Indirect Draw
+		BufferId boundIndirectDrawBuffer;
+
+		// Indirect Dispatch
+		BufferId boundIndirectDispatchBuffer;
+
+		// Pixel Unpack
+		BufferId boundPixelUnpackBuffer;
+
+		/// Currently bound textures, also used for texture buffers. Not used for image binding.
+		TextureId boundTextures[Texture::s_numTextureBindings];
+		const SamplerObject* samplerBindings[Texture::s_numTextureBindings];
+
+		VertexArrayObject* boundVertexArray;
+		FramebufferId boundFramebuffer;
+		const ShaderObject* activeShaderObject;
+		ProgramPipelineId boundProgramPipeline;
+		PipelineStateId currentPipelineState;
+
+		Details::StateTables stateTables;
+
+		/// Compiled shader stages of this context, see ShaderStageCache.
+		ShaderStageCache shaderStageCache;
+
+#ifdef STATE_CHANGE_STATISTICS
+		StateChangeStatistics stateChangeStatistics;
+#endif
+
+	private:
+		/// Number of threads this context is current on via MakeCurrent.
+		std::atomic<unsigned int> m_numCurrentThreads;
+	};
+
+	namespace Details
+	{
+		inline StateTables& GetStateTables()
+		{
+			return Context::GetCurrent().stateTables;
+		}
+
+#ifdef STATE_CHANGE_STATISTICS
+		inline StateChangeStatistics& GetCurrentStateChangeStatistics()
+		{
+			return Context::GetCurrent().stateChangeStatistics;
+		}
+#endif
+	}
+}
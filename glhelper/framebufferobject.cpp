@@ -1,9 +1,10 @@
 #include "framebufferobject.hpp"
 #include "texture2d.hpp"
+#include "statemanagement.hpp"
+#include "context.hpp"
 
 namespace gl
 {
-	FramebufferId FramebufferObject::s_BoundFrameBuffer = 0;
 	//FramebufferObject* FramebufferObject::s_BoundFrameBufferRead = NULL;
 
 	FramebufferObject::FramebufferObject(Attachment colorAttachments, Attachment depthStencil, bool depthWithStencil) :
@@ -59,25 +60,29 @@ namespace gl
 		m_depthStencil(_moved.m_depthStencil),
 		m_colorAttachments(std::move(_moved.m_colorAttachments))
 	{
-		_moved.s_BoundFrameBuffer = 0;
+		_moved.m_framebuffer = 0;
 	}
 
 	FramebufferObject::~FramebufferObject()
 	{
 		if(m_framebuffer != 0)
 		{
-			if(s_BoundFrameBuffer == m_framebuffer)
-				s_BoundFrameBuffer = 0;
+			FramebufferId& boundFramebuffer = Context::GetCurrent().boundFramebuffer;
+			if(boundFramebuffer == m_framebuffer)
+				boundFramebuffer = 0;
 			GL_CALL(glDeleteFramebuffers, 1, &m_framebuffer);
 		}
 	}
 
 	void FramebufferObject::Bind(bool autoViewportSet)
 	{
-		if (s_BoundFrameBuffer != m_framebuffer)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(FRAMEBUFFER);
+		FramebufferId& boundFramebuffer = Context::GetCurrent().boundFramebuffer;
+		if (boundFramebuffer != m_framebuffer)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(FRAMEBUFFER);
 			GL_CALL(glBindFramebuffer, GL_DRAW_FRAMEBUFFER, m_framebuffer);
-			s_BoundFrameBuffer = m_framebuffer;
+			boundFramebuffer = m_framebuffer;
 
 			if (autoViewportSet)
 			{
@@ -95,20 +100,31 @@ namespace gl
 					width /= 2;
 					height /= 2;
 				}
-				glViewport(0, 0, width, height);
+				SetViewport(0.0f, 0.0f, static_cast<GLfloat>(width), static_cast<GLfloat>(height));
+				FlushViewportState();
 			}
 		}
 	}
 
 	void FramebufferObject::BindBackBuffer()
 	{
-		if (s_BoundFrameBuffer != 0)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(FRAMEBUFFER);
+		FramebufferId& boundFramebuffer = Context::GetCurrent().boundFramebuffer;
+		if (boundFramebuffer != 0)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(FRAMEBUFFER);
 			GL_CALL(glBindFramebuffer, GL_DRAW_FRAMEBUFFER, 0);
-			s_BoundFrameBuffer = 0;
+			boundFramebuffer = 0;
 		}
 	}
 
+	void FramebufferObject::BindBackBuffer(GLsizei _backbufferWidth, GLsizei _backbufferHeight)
+	{
+		BindBackBuffer();
+		SetViewport(0.0f, 0.0f, static_cast<GLfloat>(_backbufferWidth), static_cast<GLfloat>(_backbufferHeight));
+		FlushViewportState();
+	}
+
 
 /*	void FramebufferObject::BlitTo(FramebufferObject* pDest, const ezRectU32& srcRect, const ezRectU32& dstRect, GLuint mask, GLuint filter)
 	{
@@ -42,12 +42,20 @@ namespace gl
 
 		/// Binds the framebuffer object (GL_DRAW_FRAMEBUFFER).
 		/// Has no effect if this FBO is already bound.
-		/// \param autoViewportSet  If true an appropriate viewport will be set.
+		/// \param autoViewportSet  If true an appropriate viewport will be set for all viewport indices (via the cache in statemanagement.hpp, flushed immediately).
+		/// \attention
+		///		The automatic viewport is filtered against the viewport cache. If you changed the viewport with a raw glViewport call,
+		///		call ResetViewportStateTable_Unkown afterwards, otherwise the viewport of the next Bind may be skipped.
 		void Bind(bool autoViewportSet);
 		/// Resets the binding to zero (GL_DRAW_FRAMEBUFFER).
 		/// Has no effect if backbuffer is already bound.
-		/// You'll have to the the viewport on your own! 
+		/// You'll have to the the viewport on your own! Use SetViewport from statemanagement.hpp or the overload with the backbuffer size.
+		/// \see Bind for raw glViewport calls.
 		static void BindBackBuffer();
+		/// Resets the binding to zero (GL_DRAW_FRAMEBUFFER) and sets the viewport of all viewport indices to the given backbuffer size.
+		///
+		/// The viewport is set via the cache in statemanagement.hpp and flushed immediately.
+		static void BindBackBuffer(GLsizei _backbufferWidth, GLsizei _backbufferHeight);
 
 		/// Blits this Framebuffer to another one. Afterwards the dest buffer is set for drawing and this buffer is set for reading!
 		/// \param pDest   Backbuffer if NULL
@@ -63,9 +71,6 @@ namespace gl
 		const Attachment& GetDepthStencilAttachment() { return m_depthStencil; }
 
 	private:
-		/// Currently bound draw framebuffer object
-		static FramebufferId s_BoundFrameBuffer;
-
 		FramebufferId m_framebuffer;
 
 		Attachment m_depthStencil;
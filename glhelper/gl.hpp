@@ -2,12 +2,14 @@
 
 #include <glhelperconfig.hpp>
 #include <type_traits>
+#include <cstdint>
 
 namespace gl
 {
 	// Typedefs for different kinds of OpenGL IDs for better readability.
 	typedef GLuint ShaderId;
 	typedef GLuint ProgramId;
+	typedef GLuint ProgramPipelineId;
 
 	typedef GLuint BufferId;
 	typedef GLuint IndexBufferId;
@@ -19,6 +21,9 @@ namespace gl
 
 	typedef GLuint QueryId;
 
+	/// Identifier of a registered pipeline state, see RegisterPipelineState.
+	typedef std::uint16_t PipelineStateId;
+
 
 	// Error handling
 
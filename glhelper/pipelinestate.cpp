@@ -0,0 +1,294 @@
+#include "pipelinestate.hpp"
+#include "utils/hash.hpp"
+
+#include <cstring>
+#include <vector>
+#include <unordered_map>
+
+namespace gl
+{
+	PipelineState::PipelineState()
+	{
+		// Zero padding for bytewise hashing and comparision.
+		memset(this, 0, sizeof(*this));
+
+		caps = 0;
+		for (unsigned int i = 0; i < static_cast<unsigned int>(Cap::NUM_CAPS); ++i)
+		{
+			// Initial states according to http://docs.gl/gl4/glEnable
+			if (i == static_cast<unsigned int>(Cap::DITHER) || i == static_cast<unsigned int>(Cap::MULTISAMPLE))
+				caps |= std::uint64_t(1) << i;
+		}
+
+		depthWrite = true;
+		depthFunc = DepthFunc::LESS;
+
+		stencilFront.func = DepthFunc::ALWAYS;
+		stencilFront.ref = 0;
+		stencilFront.readMask = 0xFFFFFFFF;
+		stencilFront.writeMask = 0xFFFFFFFF;
+		stencilFront.stencilFail = StencilOp::KEEP;
+		stencilFront.depthFail = StencilOp::KEEP;
+		stencilFront.depthPass = StencilOp::KEEP;
+		stencilBack = stencilFront;
+
+		for (BlendTarget& target : blend)
+		{
+			target.enabled = false;
+			target.srcRGB = BlendFactor::ONE;
+			target.dstRGB = BlendFactor::ZERO;
+			target.srcAlpha = BlendFactor::ONE;
+			target.dstAlpha = BlendFactor::ZERO;
+			target.equationRGB = BlendEquation::ADD;
+			target.equationAlpha = BlendEquation::ADD;
+			target.colorMask = ColorMask::ALL;
+		}
+
+		cullFace = CullFace::BACK;
+		frontFace = FrontFace::CCW;
+
+		polygonOffsetFactor = 0.0f;
+		polygonOffsetUnits = 0.0f;
+	}
+
+	PipelineState& PipelineState::SetCap(Cap _cap, bool _enabled)
+	{
+		GLHELPER_ASSERT(_cap != Cap::BLEND, "Blending is enabled per draw buffer, use PipelineState::blend instead!");
+		if (_cap == Cap::BLEND)
+			return *this;
+
+		if (_enabled)
+			caps |= std::uint64_t(1) << static_cast<unsigned int>(_cap);
+		else
+			caps &= ~(std::uint64_t(1) << static_cast<unsigned int>(_cap));
+		return *this;
+	}
+
+	bool PipelineState::operator == (const PipelineState& _other) const
+	{
+		return memcmp(this, &_other, sizeof(PipelineState)) == 0;
+	}
+
+	namespace
+	{
+		struct PipelineStateHasher
+		{
+			size_t operator()(const PipelineState& _state) const { return static_cast<size_t>(HashUtils::FNV1a(&_state, sizeof(_state))); }
+		};
+
+		std::vector<PipelineState> s_pipelineStates;
+		std::unordered_map<PipelineState, PipelineStateId, PipelineStateHasher> s_pipelineStateIds;
+
+		/// Caps that are not part of the pipeline state. Blending is per draw buffer, debug output is a context setting.
+		const std::uint64_t s_unmanagedCaps = (std::uint64_t(1) << static_cast<unsigned int>(Cap::BLEND)) |
+												(std::uint64_t(1) << static_cast<unsigned int>(Cap::DEBUG_OUTPUT)) |
+												(std::uint64_t(1) << static_cast<unsigned int>(Cap::DEBUG_OUTPUT_SYNCHRONOUS));
+
+		/// Groups of state that are set by the same GL calls.
+		const std::uint64_t DIFF_DEPTH_WRITE = 1 << 0;
+		const std::uint64_t DIFF_DEPTH_FUNC = 1 << 1;
+		const std::uint64_t DIFF_STENCIL_FUNC = 1 << 2;
+		const std::uint64_t DIFF_STENCIL_OP = 1 << 3;
+		const std::uint64_t DIFF_STENCIL_WRITEMASK = 1 << 4;
+		const std::uint64_t DIFF_CULL_FACE = 1 << 5;
+		const std::uint64_t DIFF_FRONT_FACE = 1 << 6;
+		const std::uint64_t DIFF_POLYGON_OFFSET = 1 << 7;
+		// Per draw buffer bits, shifted by the draw buffer index.
+		const std::uint64_t DIFF_BLEND_ENABLED = std::uint64_t(1) << 8;
+		const std::uint64_t DIFF_BLEND_FUNC = DIFF_BLEND_ENABLED << Details::MaxExpectedDrawbuffers;
+		const std::uint64_t DIFF_BLEND_EQUATION = DIFF_BLEND_FUNC << Details::MaxExpectedDrawbuffers;
+		const std::uint64_t DIFF_COLOR_MASK = DIFF_BLEND_EQUATION << Details::MaxExpectedDrawbuffers;
+		static_assert(8 + 4 * Details::MaxExpectedDrawbuffers <= 64, "Diff bits exceed 64 bit.");
+
+		std::uint64_t ComputeDiff(const PipelineState& _from, const PipelineState& _to)
+		{
+			std::uint64_t diff = 0;
+			if (_from.depthWrite != _to.depthWrite) diff |= DIFF_DEPTH_WRITE;
+			if (_from.depthFunc != _to.depthFunc) diff |= DIFF_DEPTH_FUNC;
+
+			const PipelineState::StencilFaceState* fromFaces[] = { &_from.stencilFront, &_from.stencilBack };
+			const PipelineState::StencilFaceState* toFaces[] = { &_to.stencilFront, &_to.stencilBack };
+			for (int face = 0; face < 2; ++face)
+			{
+				if (fromFaces[face]->func != toFaces[face]->func || fromFaces[face]->ref != toFaces[face]->ref || fromFaces[face]->readMask != toFaces[face]->readMask)
+					diff |= DIFF_STENCIL_FUNC;
+				if (fromFaces[face]->stencilFail != toFaces[face]->stencilFail || fromFaces[face]->depthFail != toFaces[face]->depthFail || fromFaces[face]->depthPass != toFaces[face]->depthPass)
+					diff |= DIFF_STENCIL_OP;
+				if (fromFaces[face]->writeMask != toFaces[face]->writeMask)
+					diff |= DIFF_STENCIL_WRITEMASK;
+			}
+
+			if (_from.cullFace != _to.cullFace) diff |= DIFF_CULL_FACE;
+			if (_from.frontFace != _to.frontFace) diff |= DIFF_FRONT_FACE;
+			if (_from.polygonOffsetFactor != _to.polygonOffsetFactor || _from.polygonOffsetUnits != _to.polygonOffsetUnits) diff |= DIFF_POLYGON_OFFSET;
+
+			for (unsigned int i = 0; i < Details::MaxExpectedDrawbuffers; ++i)
+			{
+				const PipelineState::BlendTarget& from = _from.blend[i];
+				const PipelineState::BlendTarget& to = _to.blend[i];
+				if (from.enabled != to.enabled)
+					diff |= DIFF_BLEND_ENABLED << i;
+				if (from.srcRGB != to.srcRGB || from.dstRGB != to.dstRGB || from.srcAlpha != to.srcAlpha || from.dstAlpha != to.dstAlpha)
+					diff |= DIFF_BLEND_FUNC << i;
+				if (from.equationRGB != to.equationRGB || from.equationAlpha != to.equationAlpha)
+					diff |= DIFF_BLEND_EQUATION << i;
+				if (from.colorMask != to.colorMask)
+					diff |= DIFF_COLOR_MASK << i;
+			}
+
+			return diff;
+		}
+
+		void ApplyCaps(std::uint64_t _caps, std::uint64_t _changedCaps, bool _force)
+		{
+			_changedCaps &= ~s_unmanagedCaps;
+			while (_changedCaps != 0)
+			{
+				// Isolate and clear lowest bit.
+				unsigned int capIndex = 0;
+				while (((_changedCaps >> capIndex) & 1) == 0)
+					++capIndex;
+				_changedCaps &= _changedCaps - 1;
+
+				if ((_caps >> capIndex) & 1)
+					Enable(static_cast<Cap>(capIndex), _force);
+				else
+					Disable(static_cast<Cap>(capIndex), _force);
+			}
+		}
+
+		void ApplyDiff(const PipelineState& _state, std::uint64_t _diff, bool _force)
+		{
+			if (_diff & DIFF_DEPTH_WRITE)
+				SetDepthWrite(_state.depthWrite, _force);
+			if (_diff & DIFF_DEPTH_FUNC)
+				SetDepthFunc(_state.depthFunc, _force);
+
+			// Set both faces with a single call if they are equal.
+			const PipelineState::StencilFaceState& front = _state.stencilFront;
+			const PipelineState::StencilFaceState& back = _state.stencilBack;
+			if (_diff & DIFF_STENCIL_FUNC)
+			{
+				if (front.func == back.func && front.ref == back.ref && front.readMask == back.readMask)
+					SetStencilFunc(StencilFace::FRONT_AND_BACK, front.func, front.ref, front.readMask, _force);
+				else
+				{
+					SetStencilFunc(StencilFace::FRONT, front.func, front.ref, front.readMask, _force);
+					SetStencilFunc(StencilFace::BACK, back.func, back.ref, back.readMask, _force);
+				}
+			}
+			if (_diff & DIFF_STENCIL_OP)
+			{
+				if (front.stencilFail == back.stencilFail && front.depthFail == back.depthFail && front.depthPass == back.depthPass)
+					SetStencilOp(StencilFace::FRONT_AND_BACK, front.stencilFail, front.depthFail, front.depthPass, _force);
+				else
+				{
+					SetStencilOp(StencilFace::FRONT, front.stencilFail, front.depthFail, front.depthPass, _force);
+					SetStencilOp(StencilFace::BACK, back.stencilFail, back.depthFail, back.depthPass, _force);
+				}
+			}
+			if (_diff & DIFF_STENCIL_WRITEMASK)
+			{
+				if (front.writeMask == back.writeMask)
+					SetStencilWriteMask(StencilFace::FRONT_AND_BACK, front.writeMask, _force);
+				else
+				{
+					SetStencilWriteMask(StencilFace::FRONT, front.writeMask, _force);
+					SetStencilWriteMask(StencilFace::BACK, back.writeMask, _force);
+				}
+			}
+
+			if (_diff & DIFF_CULL_FACE)
+				GL_CALL(glCullFace, static_cast<GLenum>(_state.cullFace));
+			if (_diff & DIFF_FRONT_FACE)
+				GL_CALL(glFrontFace, static_cast<GLenum>(_state.frontFace));
+			if (_diff & DIFF_POLYGON_OFFSET)
+				GL_CALL(glPolygonOffset, _state.polygonOffsetFactor, _state.polygonOffsetUnits);
+
+			for (GLuint i = 0; i < Details::MaxExpectedDrawbuffers; ++i)
+			{
+				const PipelineState::BlendTarget& target = _state.blend[i];
+				if (_diff & (DIFF_BLEND_ENABLED << i))
+				{
+					if (target.enabled)
+						Enable(Cap::BLEND, i, _force);
+					else
+						Disable(Cap::BLEND, i, _force);
+				}
+				if (_diff & (DIFF_BLEND_FUNC << i))
+					SetBlendFuncSeparate(i, target.srcRGB, target.dstRGB, target.srcAlpha, target.dstAlpha, _force);
+				if (_diff & (DIFF_BLEND_EQUATION << i))
+					SetBlendEquationSeparate(i, target.equationRGB, target.equationAlpha, _force);
+				if (_diff & (DIFF_COLOR_MASK << i))
+					SetColorMask(i, target.colorMask, _force);
+			}
+		}
+	}
+
+	PipelineStateId RegisterPipelineState(const PipelineState& _state)
+	{
+		auto it = s_pipelineStateIds.find(_state);
+		if (it != s_pipelineStateIds.end())
+			return it->second;
+
+		if (s_pipelineStates.size() >= InvalidPipelineStateId)
+		{
+			GLHELPER_LOG_ERROR("Exceeded maximum number of pipeline states!");
+			return InvalidPipelineStateId;
+		}
+
+		PipelineStateId id = static_cast<PipelineStateId>(s_pipelineStates.size());
+		s_pipelineStates.push_back(_state);
+		s_pipelineStateIds.emplace(_state, id);
+		return id;
+	}
+
+	const PipelineState& GetPipelineState(PipelineStateId _id)
+	{
+		GLHELPER_ASSERT(_id < s_pipelineStates.size(), "Invalid pipeline state id!");
+		return s_pipelineStates[_id];
+	}
+
+	size_t GetNumRegisteredPipelineStates()
+	{
+		return s_pipelineStates.size();
+	}
+
+	void ApplyPipelineState(PipelineStateId _id, bool _force)
+	{
+		GLHELPER_ASSERT(_id < s_pipelineStates.size(), "Invalid pipeline state id!");
+
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(PIPELINE_STATE);
+		PipelineStateId& currentPipelineState = Context::GetCurrent().currentPipelineState;
+		if (_id == currentPipelineState && !_force)
+			return;
+
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(PIPELINE_STATE);
+
+		const PipelineState& state = s_pipelineStates[_id];
+		if (currentPipelineState == InvalidPipelineStateId || _force)
+		{
+			// Set everything.
+			ApplyCaps(state.caps, (std::uint64_t(1) << static_cast<unsigned int>(Cap::NUM_CAPS)) - 1, true);
+			ApplyDiff(state, ~std::uint64_t(0), true);
+		}
+		else
+		{
+			const PipelineState& current = s_pipelineStates[currentPipelineState];
+			ApplyCaps(state.caps, state.caps ^ current.caps, false);
+			ApplyDiff(state, ComputeDiff(current, state), false);
+		}
+
+		currentPipelineState = _id;
+	}
+
+	PipelineStateId GetCurrentPipelineState()
+	{
+		return Context::GetCurrent().currentPipelineState;
+	}
+
+	void InvalidateCurrentPipelineState()
+	{
+		Context::GetCurrent().currentPipelineState = InvalidPipelineStateId;
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "statemanagement.hpp"
+
+#include <cstdint>
+
+namespace gl
+{
+	/// Descriptor of a complete fixed function pipeline state block.
+	///
+	/// Covers boolean caps, depth, stencil, blending (per draw buffer), culling, polygon offset and color mask.
+	/// Register descriptors once with RegisterPipelineState and switch between them with ApplyPipelineState.
+	/// Default constructed descriptors correspond to the initial OpenGL state.
+	///
+	/// \attention
+	///		Since descriptors are hashed and compared bytewise, all padding is zeroed on construction. Do not memcpy partial descriptors.
+	struct PipelineState
+	{
+		PipelineState();
+
+		/// Enables or disables a cap.
+		///
+		/// Cap::BLEND is ignored, use the per draw buffer flags in blend instead. DEBUG_OUTPUT and DEBUG_OUTPUT_SYNCHRONOUS are never changed by ApplyPipelineState.
+		PipelineState& SetCap(Cap _cap, bool _enabled);
+		bool GetCap(Cap _cap) const { return (caps & (std::uint64_t(1) << static_cast<unsigned int>(_cap))) != 0; }
+
+		/// Bitmask of enabled caps, bit i corresponds to Cap with value i.
+		std::uint64_t caps;
+
+		bool depthWrite;
+		DepthFunc depthFunc;
+
+		struct StencilFaceState
+		{
+			DepthFunc func;
+			GLint ref;
+			GLuint readMask;
+			GLuint writeMask;
+			StencilOp stencilFail;
+			StencilOp depthFail;
+			StencilOp depthPass;
+		};
+		/// Front and back face stencil state. Only relevant if Cap::STENCIL_TEST is enabled.
+		StencilFaceState stencilFront;
+		StencilFaceState stencilBack;
+
+		struct BlendTarget
+		{
+			bool enabled;
+			BlendFactor srcRGB;
+			BlendFactor dstRGB;
+			BlendFactor srcAlpha;
+			BlendFactor dstAlpha;
+			BlendEquation equationRGB;
+			BlendEquation equationAlpha;
+			ColorMask colorMask;
+		};
+		/// Blend state and color mask per draw buffer.
+		BlendTarget blend[Details::MaxExpectedDrawbuffers];
+
+		/// Only relevant if Cap::CULL_FACE is enabled.
+		CullFace cullFace;
+		FrontFace frontFace;
+
+		/// Only relevant if any of the POLYGON_OFFSET caps is enabled.
+		float polygonOffsetFactor;
+		float polygonOffsetUnits;
+
+		bool operator == (const PipelineState& _other) const;
+		bool operator != (const PipelineState& _other) const { return !(*this == _other); }
+	};
+
+	/// Marks an invalid or unknown pipeline state.
+	static const PipelineStateId InvalidPipelineStateId = 0xFFFF;
+
+	/// Registers a pipeline state descriptor.
+	///
+	/// Identical descriptors are deduplicated and get the same id. Registered states can not be removed.
+	/// Ids are valid in all contexts (see gl::Context), but registration itself is not thread safe.
+	/// \return
+	///		Small integer id, InvalidPipelineStateId if the maximum number of states was exceeded.
+	PipelineStateId RegisterPipelineState(const PipelineState& _state);
+
+	/// Returns a registered pipeline state descriptor.
+	const PipelineState& GetPipelineState(PipelineStateId _id);
+
+	/// Returns the number of distinct registered pipeline states.
+	size_t GetNumRegisteredPipelineStates();
+
+	/// Applies a registered pipeline state.
+	///
+	/// Compares the state with the last applied one and issues only the GL calls for parts that differ. Applying the same id twice is almost free.
+	/// Uses the state setters of statemanagement.hpp, so their internal tables stay valid.
+	/// \param _force
+	///		Sets the entire state, regardless of the last applied one.
+	/// \attention
+	///		If state was changed without ApplyPipelineState since the last call, call InvalidateCurrentPipelineState or use _force.
+	void ApplyPipelineState(PipelineStateId _id, bool _force = false);
+
+	/// Returns the id of the last applied pipeline state, InvalidPipelineStateId if unknown.
+	PipelineStateId GetCurrentPipelineState();
+
+	/// Marks the current pipeline state as unknown. The next ApplyPipelineState will set the entire state.
+	void InvalidateCurrentPipelineState();
+}
@@ -0,0 +1,150 @@
+#include "programpipeline.hpp"
+#include "context.hpp"
+#include "utils/flagoperators.hpp"
+
+namespace gl
+{
+	ProgramPipeline::StageFlag ProgramPipeline::GetStageFlag(ShaderObject::ShaderType _type)
+	{
+		static const StageFlag shaderTypeToStageFlag[static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES)] =
+		{
+			StageFlag::VERTEX,
+			StageFlag::FRAGMENT,
+			StageFlag::EVALUATION,
+			StageFlag::CONTROL,
+			StageFlag::GEOMETRY,
+			StageFlag::COMPUTE
+		};
+		return shaderTypeToStageFlag[static_cast<unsigned int>(_type)];
+	}
+
+	ProgramPipeline::ProgramPipeline()
+	{
+		GL_CALL(glCreateProgramPipelines, 1, &m_pipeline);
+		for (Stage& stage : m_stages)
+		{
+			stage.shaderObject = nullptr;
+			stage.program = 0;
+			stage.programGeneration = 0;
+		}
+	}
+
+	ProgramPipeline::ProgramPipeline(ProgramPipeline&& _moved) :
+		m_pipeline(_moved.m_pipeline)
+	{
+		for (unsigned int i = 0; i < static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES); ++i)
+			m_stages[i] = _moved.m_stages[i];
+		_moved.m_pipeline = 0;
+	}
+
+	ProgramPipeline::~ProgramPipeline()
+	{
+		if (m_pipeline != 0)
+		{
+			if (Context::GetCurrent().boundProgramPipeline == m_pipeline)
+				ResetBinding();
+
+			GL_CALL(glDeleteProgramPipelines, 1, &m_pipeline);
+		}
+	}
+
+	void ProgramPipeline::UseProgramStages(const ShaderObject& _program, StageFlag _stages)
+	{
+		GLHELPER_ASSERT(_program.IsSeparable(), "Program \"" + _program.GetName() + "\" was not linked as separable program. Call SetSeparable before CreateProgram!");
+#ifdef _DEBUG
+		for (unsigned int i = 0; i < static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES); ++i)
+		{
+			ShaderObject::ShaderType type = static_cast<ShaderObject::ShaderType>(i);
+			GLHELPER_ASSERT(!any(_stages & GetStageFlag(type)) || _program.HasShaderStage(type), "Program \"" + _program.GetName() + "\" does not contain all requested stages!");
+		}
+#endif
+
+		UseProgramStages(&_program, _stages);
+	}
+
+	void ProgramPipeline::UseProgramStages(const ShaderObject& _program)
+	{
+		StageFlag stages = StageFlag::NONE;
+		for (unsigned int i = 0; i < static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES); ++i)
+		{
+			ShaderObject::ShaderType type = static_cast<ShaderObject::ShaderType>(i);
+			if (_program.HasShaderStage(type))
+				stages = stages | GetStageFlag(type);
+		}
+
+		UseProgramStages(_program, stages);
+	}
+
+	void ProgramPipeline::ResetProgramStages(StageFlag _stages)
+	{
+		UseProgramStages(nullptr, _stages);
+	}
+
+	void ProgramPipeline::UseProgramStages(const ShaderObject* _shaderObject, StageFlag _stages) const
+	{
+		ProgramId program = _shaderObject ? _shaderObject->GetProgram() : 0;
+		unsigned int programGeneration = _shaderObject ? _shaderObject->GetProgramGeneration() : 0;
+
+		// Only change stages that actually differ.
+		StageFlag changedStages = StageFlag::NONE;
+		for (unsigned int i = 0; i < static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES); ++i)
+		{
+			StageFlag stageFlag = GetStageFlag(static_cast<ShaderObject::ShaderType>(i));
+			Stage& stage = m_stages[i];
+			if (any(_stages & stageFlag) && (stage.shaderObject != _shaderObject || stage.programGeneration != programGeneration))
+			{
+				changedStages = changedStages | stageFlag;
+				stage.shaderObject = _shaderObject;
+				stage.program = program;
+				stage.programGeneration = programGeneration;
+			}
+		}
+
+		if (any(changedStages))
+			GL_CALL(glUseProgramStages, m_pipeline, static_cast<GLbitfield>(changedStages), program);
+	}
+
+	void ProgramPipeline::UpdateRelinkedStages() const
+	{
+		for (unsigned int i = 0; i < static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES); ++i)
+		{
+			const ShaderObject* shaderObject = m_stages[i].shaderObject;
+			if (!shaderObject || shaderObject->GetProgramGeneration() == m_stages[i].programGeneration)
+				continue;
+
+			// Attach all stages of the relinked ShaderObject at once.
+			StageFlag stages = StageFlag::NONE;
+			for (unsigned int j = i; j < static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES); ++j)
+			{
+				if (m_stages[j].shaderObject == shaderObject)
+					stages = stages | GetStageFlag(static_cast<ShaderObject::ShaderType>(j));
+			}
+			UseProgramStages(shaderObject, stages);
+		}
+	}
+
+	void ProgramPipeline::Bind() const
+	{
+		ShaderObject::ResetBinding();
+		UpdateRelinkedStages();
+
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(PROGRAM_PIPELINE);
+		ProgramPipelineId& boundProgramPipeline = Context::GetCurrent().boundProgramPipeline;
+		if (boundProgramPipeline != m_pipeline)
+		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(PROGRAM_PIPELINE);
+			GL_CALL(glBindProgramPipeline, m_pipeline);
+			boundProgramPipeline = m_pipeline;
+		}
+	}
+
+	void ProgramPipeline::ResetBinding()
+	{
+		ProgramPipelineId& boundProgramPipeline = Context::GetCurrent().boundProgramPipeline;
+		if (boundProgramPipeline != 0)
+		{
+			GL_CALL(glBindProgramPipeline, 0);
+			boundProgramPipeline = 0;
+		}
+	}
+}
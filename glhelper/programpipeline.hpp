@@ -0,0 +1,101 @@
+#pragma once
+
+#include "gl.hpp"
+#include "shaderobject.hpp"
+
+namespace gl
+{
+	/// Wrapper for OpenGL program pipeline objects.
+	///
+	/// Combines stages of several separable ShaderObjects without relinking (see ShaderObject::SetSeparable).
+	/// This way a fragment shader can for example be swapped for a debug variant while keeping the vertex stage.
+	/// Both setting of stages and binding check for redundant calls.
+	/// If a used ShaderObject is relinked (CreateProgram, hot reload), its stages are attached again on the next Bind.
+	///
+	/// \attention A program activated via ShaderObject::Activate always takes precedence over the bound pipeline. Bind takes care of this by resetting the program binding.
+	class ProgramPipeline
+	{
+	public:
+		ProgramPipeline(const ProgramPipeline&) = delete;
+		void operator = (const ProgramPipeline&) = delete;
+		void operator = (ProgramPipeline&&) = delete;
+
+		/// Stage bits for UseProgramStages.
+		///
+		/// See http://docs.gl/gl4/glUseProgramStages
+		enum class StageFlag
+		{
+			NONE = 0,
+
+			VERTEX = GL_VERTEX_SHADER_BIT,
+			FRAGMENT = GL_FRAGMENT_SHADER_BIT,
+			EVALUATION = GL_TESS_EVALUATION_SHADER_BIT,
+			CONTROL = GL_TESS_CONTROL_SHADER_BIT,
+			GEOMETRY = GL_GEOMETRY_SHADER_BIT,
+			COMPUTE = GL_COMPUTE_SHADER_BIT,
+
+			ALL = VERTEX | FRAGMENT | EVALUATION | CONTROL | GEOMETRY | COMPUTE
+		};
+
+		/// Returns the stage flag corresponding to a single shader type.
+		static StageFlag GetStageFlag(ShaderObject::ShaderType _type);
+
+		/// Creates an empty program pipeline.
+		ProgramPipeline();
+		ProgramPipeline(ProgramPipeline&& _moved);
+		~ProgramPipeline();
+
+		/// Uses the given stages of a separable program for this pipeline.
+		///
+		/// Only stages that are not already set to the given program are changed.
+		/// The ShaderObject needs to stay alive (and must not be moved) until its stages are reset or replaced.
+		/// \param _stages
+		///		Combination of one or more StageFlag. All stages need to be contained in _program.
+		void UseProgramStages(const ShaderObject& _program, StageFlag _stages);
+
+		/// Uses all stages of a separable program for this pipeline.
+		void UseProgramStages(const ShaderObject& _program);
+
+		/// Removes the programs of the given stages from the pipeline.
+		void ResetProgramStages(StageFlag _stages);
+
+		/// Returns the ShaderObject that is used for the given stage. nullptr if none.
+		const ShaderObject* GetStageShaderObject(ShaderObject::ShaderType _type) const { return m_stages[static_cast<unsigned int>(_type)].shaderObject; }
+
+		/// Returns the program that is currently attached for the given stage. Zero if none.
+		///
+		/// May be outdated if the stage's ShaderObject was relinked since the last Bind.
+		ProgramId GetStageProgram(ShaderObject::ShaderType _type) const { return m_stages[static_cast<unsigned int>(_type)].program; }
+
+		/// Binds the pipeline if not already bound.
+		///
+		/// Attaches the new programs of relinked ShaderObjects first.
+		/// Resets a program activated via ShaderObject::Activate, since it would override the pipeline otherwise.
+		void Bind() const;
+
+		/// Resets the pipeline binding to zero if a pipeline is bound.
+		static void ResetBinding();
+
+		/// Returns intern OpenGL program pipeline handle.
+		ProgramPipelineId GetInternHandle() const { return m_pipeline; }
+
+	private:
+		/// Sets the given stages to a ShaderObject (nullptr for reset) and sends all stages that actually changed.
+		void UseProgramStages(const ShaderObject* _shaderObject, StageFlag _stages) const;
+
+		/// Attaches programs of all stages whose ShaderObject was relinked since they were attached.
+		void UpdateRelinkedStages() const;
+
+		ProgramPipelineId m_pipeline;
+
+		/// Attached program per stage, to avoid redundant glUseProgramStages calls and to detect relinks.
+		/// Mutable since relinked stages are updated lazily by Bind.
+		struct Stage
+		{
+			const ShaderObject* shaderObject;
+			ProgramId program;
+			unsigned int programGeneration;
+		};
+		mutable Stage m_stages[static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES)];
+	};
+}
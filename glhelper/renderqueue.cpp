@@ -0,0 +1,222 @@
+#include "renderqueue.hpp"
+#include "shaderobject.hpp"
+#include "vertexarrayobject.hpp"
+#include "buffer.hpp"
+#include "texture.hpp"
+#include "utils/hash.hpp"
+
+#include <cstring>
+
+namespace gl
+{
+	namespace
+	{
+		const unsigned int s_depthBits = 18;
+		const unsigned int s_textureSetBits = 12;
+		const unsigned int s_vertexArrayBits = 10;
+		const unsigned int s_pipelineStateBits = 12;
+		const unsigned int s_programBits = 12;
+		static_assert(s_depthBits + s_textureSetBits + s_vertexArrayBits + s_pipelineStateBits + s_programBits == 64, "Sort key needs to use exactly 64 bit.");
+
+		const unsigned int s_textureSetShift = s_depthBits;
+		const unsigned int s_vertexArrayShift = s_textureSetShift + s_textureSetBits;
+		const unsigned int s_pipelineStateShift = s_vertexArrayShift + s_vertexArrayBits;
+		const unsigned int s_programShift = s_pipelineStateShift + s_pipelineStateBits;
+
+		/// Quantizes a depth value preserving order. The bit pattern of non-negative IEEE floats is monotonic.
+		std::uint64_t QuantizeDepth(float _depth)
+		{
+			if (!(_depth > 0.0f))
+				return 0;
+			std::uint32_t bits;
+			memcpy(&bits, &_depth, sizeof(bits));
+			return bits >> (32 - s_depthBits);
+		}
+	}
+
+	RenderQueue::DrawPacket::DrawPacket() :
+		program(nullptr),
+		vertexArray(nullptr),
+		vertexBuffer(nullptr),
+		indexBuffer(nullptr),
+		pipelineState(InvalidPipelineStateId),
+		depth(0.0f),
+		primitiveType(GL_TRIANGLES),
+		count(0),
+		first(0),
+		instanceCount(1),
+		indexType(GL_UNSIGNED_INT)
+	{
+		for (unsigned int i = 0; i < s_maxTexturesPerDraw; ++i)
+			textures[i] = nullptr;
+	}
+
+	unsigned int RenderQueue::Statistics::GetNumStateChanges() const
+	{
+		return numProgramChanges + numPipelineStateChanges + numVertexArrayChanges + numVertexBufferChanges + numIndexBufferChanges + numTextureChanges;
+	}
+
+	RenderQueue::RenderQueue() :
+		m_keyOverflowWarned(false)
+	{
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_packets.clear();
+		m_sortEntries.clear();
+
+		// Keys only need to be consistent within one frame. Keeping old assignments would only accumulate stale pointers.
+		m_programIndices.clear();
+		m_pipelineStateIndices.clear();
+		m_vertexArrayIndices.clear();
+		m_textureSetIndices.clear();
+		m_keyOverflowWarned = false;
+	}
+
+	std::uint32_t RenderQueue::GetIndex(std::unordered_map<std::uint64_t, std::uint32_t>& _indexMap, std::uint64_t _value, unsigned int _numBits, const char* _fieldName)
+	{
+		auto it = _indexMap.find(_value);
+		if (it != _indexMap.end())
+			return it->second;
+
+		if (_indexMap.size() == (1u << _numBits) && !m_keyOverflowWarned)
+		{
+			GLHELPER_LOG_WARNING("RenderQueue has more than " + std::to_string(1u << _numBits) + " distinct " + _fieldName + " since the last Clear. Sort keys alias, sorting becomes less effective.");
+			m_keyOverflowWarned = true;
+		}
+
+		std::uint32_t index = static_cast<std::uint32_t>(_indexMap.size()) & ((1u << _numBits) - 1);
+		_indexMap.emplace(_value, index);
+		return index;
+	}
+
+	std::uint64_t RenderQueue::ComputeSortKey(const DrawPacket& _packet)
+	{
+		std::uint64_t textureSetHash = HashUtils::FNV1a(_packet.textures, sizeof(_packet.textures));
+
+		std::uint64_t programIndex = GetIndex(m_programIndices, reinterpret_cast<std::uintptr_t>(_packet.program), s_programBits, "programs");
+		// Pipeline state ids go up to 16 bit, only the ones used in this frame need to fit.
+		std::uint64_t pipelineStateIndex = GetIndex(m_pipelineStateIndices, _packet.pipelineState, s_pipelineStateBits, "pipeline states");
+		std::uint64_t vertexArrayIndex = GetIndex(m_vertexArrayIndices, reinterpret_cast<std::uintptr_t>(_packet.vertexArray), s_vertexArrayBits, "vertex arrays");
+		std::uint64_t textureSetIndex = GetIndex(m_textureSetIndices, textureSetHash, s_textureSetBits, "texture sets");
+
+		return (programIndex << s_programShift) |
+				(pipelineStateIndex << s_pipelineStateShift) |
+				(vertexArrayIndex << s_vertexArrayShift) |
+				(textureSetIndex << s_textureSetShift) |
+				QuantizeDepth(_packet.depth);
+	}
+
+	void RenderQueue::Submit(const DrawPacket& _packet)
+	{
+		GLHELPER_ASSERT(_packet.program != nullptr, "Draw packet without program!");
+		GLHELPER_ASSERT(_packet.vertexArray != nullptr, "Draw packet without vertex array!");
+
+		SortEntry entry = { ComputeSortKey(_packet), static_cast<std::uint32_t>(m_packets.size()) };
+		m_sortEntries.push_back(entry);
+		m_packets.push_back(_packet);
+	}
+
+	void RenderQueue::Sort()
+	{
+		const size_t numEntries = m_sortEntries.size();
+		if (numEntries < 2)
+			return;
+		m_sortScratch.resize(numEntries);
+
+		// LSD radix sort with 8 bit digits. Stable, so equal keys keep their submission order.
+		SortEntry* source = m_sortEntries.data();
+		SortEntry* destination = m_sortScratch.data();
+		for (unsigned int shift = 0; shift < 64; shift += 8)
+		{
+			size_t histogram[256] = {};
+			for (size_t i = 0; i < numEntries; ++i)
+				++histogram[(source[i].key >> shift) & 0xFF];
+
+			// All keys have the same digit, nothing to do for this pass.
+			if (histogram[(source[0].key >> shift) & 0xFF] == numEntries)
+				continue;
+
+			size_t offset = 0;
+			for (size_t& bucket : histogram)
+			{
+				size_t bucketSize = bucket;
+				bucket = offset;
+				offset += bucketSize;
+			}
+			for (size_t i = 0; i < numEntries; ++i)
+				destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+
+			std::swap(source, destination);
+		}
+
+		if (source != m_sortEntries.data())
+			m_sortEntries.swap(m_sortScratch);
+	}
+
+	template<typename Visitor>
+	RenderQueue::Statistics RenderQueue::VisitPackets(const Visitor& _visitor) const
+	{
+		Statistics statistics;
+		memset(&statistics, 0, sizeof(statistics));
+
+		const DrawPacket* previous = nullptr;
+		for (const SortEntry& entry : m_sortEntries)
+		{
+			const DrawPacket& packet = m_packets[entry.packetIndex];
+
+			bool changedProgram = !previous || previous->program != packet.program;
+			bool changedPipelineState = !previous || previous->pipelineState != packet.pipelineState;
+			bool changedVertexArray = !previous || previous->vertexArray != packet.vertexArray;
+			bool changedVertexBuffer = !previous || previous->vertexBuffer != packet.vertexBuffer;
+			bool changedIndexBuffer = !previous || previous->indexBuffer != packet.indexBuffer;
+
+			statistics.numProgramChanges += changedProgram ? 1 : 0;
+			statistics.numPipelineStateChanges += changedPipelineState ? 1 : 0;
+			statistics.numVertexArrayChanges += changedVertexArray ? 1 : 0;
+			statistics.numVertexBufferChanges += changedVertexBuffer ? 1 : 0;
+			statistics.numIndexBufferChanges += changedIndexBuffer ? 1 : 0;
+			for (unsigned int i = 0; i < s_maxTexturesPerDraw; ++i)
+				statistics.numTextureChanges += (packet.textures[i] && (!previous || previous->textures[i] != packet.textures[i])) ? 1 : 0;
+			++statistics.numDraws;
+
+			_visitor(packet);
+			previous = &packet;
+		}
+
+		return statistics;
+	}
+
+	RenderQueue::Statistics RenderQueue::Execute() const
+	{
+		return VisitPackets([](const DrawPacket& _packet)
+		{
+			// All binding functions check for redundancy themselves.
+			if (_packet.pipelineState != InvalidPipelineStateId)
+				ApplyPipelineState(_packet.pipelineState);
+			_packet.program->Activate();
+			_packet.vertexArray->Bind();
+			if (_packet.vertexBuffer)
+				_packet.vertexBuffer->BindVertexBuffer(0, 0, _packet.vertexArray->GetVertexStride(0));
+			for (unsigned int i = 0; i < s_maxTexturesPerDraw; ++i)
+			{
+				if (_packet.textures[i])
+					_packet.textures[i]->Bind(i);
+			}
+
+			if (_packet.indexBuffer)
+			{
+				_packet.indexBuffer->BindIndexBuffer();
+				GL_CALL(glDrawElementsInstanced, _packet.primitiveType, _packet.count, _packet.indexType, reinterpret_cast<const void*>(static_cast<std::intptr_t>(_packet.first)), _packet.instanceCount);
+			}
+			else
+				GL_CALL(glDrawArraysInstanced, _packet.primitiveType, _packet.first, _packet.count, _packet.instanceCount);
+		});
+	}
+
+	RenderQueue::Statistics RenderQueue::CountStateChanges() const
+	{
+		return VisitPackets([](const DrawPacket&) {});
+	}
+}
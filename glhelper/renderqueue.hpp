@@ -0,0 +1,125 @@
+#pragma once
+
+#include "gl.hpp"
+#include "pipelinestate.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace gl
+{
+	class ShaderObject;
+	class VertexArrayObject;
+	class Buffer;
+	class Texture;
+
+	/// Collects draw calls and executes them in an order that minimizes state changes.
+	///
+	/// Each submitted packet is assigned a 64 bit sort key. From most to least significant bits:
+	/// program (12 bit), pipeline state (12 bit), vertex array (10 bit), texture set (12 bit), depth (18 bit, front to back).
+	/// Programs, pipeline states, vertex arrays and texture sets are mapped to small indices in order of first appearance since the last Clear.
+	/// If there are more distinct values than bits, indices wrap around and a warning is logged: sorting becomes less effective, but all packets are still executed correctly.
+	///
+	/// Packets are sorted with an LSD radix sort and executed through the redundancy checked binding functions
+	/// (ShaderObject::Activate, VertexArrayObject::Bind, Texture::Bind, ApplyPipelineState ...), so only actual changes reach OpenGL.
+	/// Meant for opaque geometry, transparent geometry needs a back to front order which is not provided.
+	class RenderQueue
+	{
+	public:
+		/// Maximum number of textures per draw packet, bound to the slots 0 to s_maxTexturesPerDraw-1.
+		static const unsigned int s_maxTexturesPerDraw = 4;
+
+		/// All information needed for a single draw call.
+		struct DrawPacket
+		{
+			DrawPacket();
+
+			const ShaderObject* program;
+			VertexArrayObject* vertexArray;
+			/// Bound to vertex binding 0 with the stride of the vertex array. May be nullptr.
+			Buffer* vertexBuffer;
+			/// If not nullptr, glDrawElementsInstanced is used, otherwise glDrawArraysInstanced.
+			Buffer* indexBuffer;
+			/// Textures for the slots 0 to s_maxTexturesPerDraw-1. Unused slots are nullptr.
+			const Texture* textures[s_maxTexturesPerDraw];
+			PipelineStateId pipelineState;
+			/// View space depth (or any other non-negative distance measure) for front to back ordering.
+			float depth;
+
+			GLenum primitiveType;
+			GLsizei count;
+			/// First vertex for non-indexed draws, offset in bytes into the index buffer for indexed draws.
+			GLint first;
+			GLsizei instanceCount;
+			/// GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+			GLenum indexType;
+		};
+
+		/// Number of bindings & state changes for a sequence of packets.
+		///
+		/// Counts changes as seen by the queue, i.e. calls that reach the redundancy checked binding functions.
+		struct Statistics
+		{
+			unsigned int numDraws;
+			unsigned int numProgramChanges;
+			unsigned int numPipelineStateChanges;
+			unsigned int numVertexArrayChanges;
+			unsigned int numVertexBufferChanges;
+			unsigned int numIndexBufferChanges;
+			unsigned int numTextureChanges;
+
+			unsigned int GetNumStateChanges() const;
+		};
+
+		RenderQueue();
+
+		/// Removes all packets and index assignments. Call once per frame.
+		void Clear();
+
+		/// Adds a draw packet and computes its sort key.
+		void Submit(const DrawPacket& _packet);
+
+		/// Sorts all packets by their sort keys. Without a call to Sort, packets are executed in submission order.
+		void Sort();
+
+		/// Executes all packets in the current order.
+		///
+		/// \return
+		///		Statistics of the executed sequence.
+		Statistics Execute() const;
+
+		/// Computes the statistics Execute would have for the current order, without issuing any GL calls.
+		///
+		/// Comparing the result before and after Sort shows how many state changes sorting saves.
+		Statistics CountStateChanges() const;
+
+		size_t GetNumPackets() const { return m_packets.size(); }
+
+	private:
+		struct SortEntry
+		{
+			std::uint64_t key;
+			std::uint32_t packetIndex;
+		};
+
+		std::uint64_t ComputeSortKey(const DrawPacket& _packet);
+
+		template<typename Visitor>
+		Statistics VisitPackets(const Visitor& _visitor) const;
+
+		/// Assigns indices in order of first appearance, wrapping at _numBits. Warns once per Clear on the first wrap.
+		std::uint32_t GetIndex(std::unordered_map<std::uint64_t, std::uint32_t>& _indexMap, std::uint64_t _value, unsigned int _numBits, const char* _fieldName);
+
+		std::vector<DrawPacket> m_packets;
+		std::vector<SortEntry> m_sortEntries;
+		std::vector<SortEntry> m_sortScratch;
+
+		std::unordered_map<std::uint64_t, std::uint32_t> m_programIndices;
+		std::unordered_map<std::uint64_t, std::uint32_t> m_pipelineStateIndices;
+		std::unordered_map<std::uint64_t, std::uint32_t> m_vertexArrayIndices;
+		std::unordered_map<std::uint64_t, std::uint32_t> m_textureSetIndices;
+		/// True if any index wrapped since the last Clear.
+		bool m_keyOverflowWarned;
+	};
+}
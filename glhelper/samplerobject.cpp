@@ -1,9 +1,9 @@
 #include "samplerobject.hpp"
+#include "context.hpp"
 
 namespace gl
 {
 	std::unordered_map<SamplerObject::Desc, SamplerObject, SamplerObject::Desc::GetHash> SamplerObject::s_existingSamplerObjects;
-	const SamplerObject* SamplerObject::s_samplerBindings[gl::Texture::s_numTextureBindings];
 
 	SamplerObject::Desc::Desc(Filter minFilter, Filter magFilter, Filter mipFilter,
 		Border borderHandling, unsigned int maxAnisotropy, const gl::Vec4& borderColor, CompareMode compareMode, 
@@ -76,10 +76,11 @@ namespace gl
 			// http://docs.gl/gl4/glDeleteSamplers
 			// However this means, that glhelper's saved bindings are wrong.
 			// Iterating over all bindings is rather costly but reliable, easy and zero overhead for all other operations.
+			const SamplerObject** samplerBindings = Context::GetCurrent().samplerBindings;
 			for (unsigned int i = 0; i < Texture::s_numTextureBindings; ++i)
 			{
-				if (s_samplerBindings[i] == this)
-					s_samplerBindings[i] = nullptr;
+				if (samplerBindings[i] == this)
+					samplerBindings[i] = nullptr;
 			}
 
 			GL_CALL(glDeleteSamplers, 1, &m_samplerId);
@@ -100,18 +101,21 @@ namespace gl
 
 	void SamplerObject::BindSampler(GLuint _textureStage) const
 	{
-		GLHELPER_ASSERT(_textureStage < sizeof(s_samplerBindings) / sizeof(SamplerObject*), "Can't bind sampler to slot " << _textureStage << " .Maximum number of slots is " << sizeof(s_samplerBindings) / sizeof(SamplerObject*));
-		if (s_samplerBindings[_textureStage] != this)
+		GLHELPER_ASSERT(_textureStage < Texture::s_numTextureBindings, "Can't bind sampler to slot " << _textureStage << " .Maximum number of slots is " << Texture::s_numTextureBindings);
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(SAMPLER);
+		const SamplerObject*& samplerBinding = Context::GetCurrent().samplerBindings[_textureStage];
+		if (samplerBinding != this)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(SAMPLER);
 			GL_CALL(glBindSampler, _textureStage, m_samplerId);
-			s_samplerBindings[_textureStage] = this;
+			samplerBinding = this;
 		}
 	}
 
 	void SamplerObject::ResetBinding(GLuint _textureStage)
 	{
-		GLHELPER_ASSERT(_textureStage < sizeof(s_samplerBindings) / sizeof(SamplerObject*), "Can't bind sampler to slot " << _textureStage << " .Maximum number of slots is " << sizeof(s_samplerBindings) / sizeof(SamplerObject*));
+		GLHELPER_ASSERT(_textureStage < Texture::s_numTextureBindings, "Can't bind sampler to slot " << _textureStage << " .Maximum number of slots is " << Texture::s_numTextureBindings);
 		GL_CALL(glBindSampler, _textureStage, 0);
-		s_samplerBindings[_textureStage] = nullptr;
+		Context::GetCurrent().samplerBindings[_textureStage] = nullptr;
 	}
 }
\ No newline at end of file
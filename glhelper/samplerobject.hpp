@@ -109,7 +109,6 @@ namespace gl
 	private:
 		SamplerObject(const Desc& samplerDesc);
 
-		static const SamplerObject* s_samplerBindings[Texture::s_numTextureBindings];
 		static std::unordered_map<Desc, SamplerObject, Desc::GetHash> s_existingSamplerObjects;
 
 		SamplerId m_samplerId;
@@ -0,0 +1,127 @@
+#include "shaderbuildprofiler.hpp"
+
+#ifdef SHADER_BUILD_PROFILING
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+namespace gl
+{
+	ShaderBuildProfiler::Timings ShaderBuildProfiler::s_globalTimings;
+	std::map<std::string, ShaderBuildProfiler::Timings> ShaderBuildProfiler::s_shaderObjectTimings;
+	const std::string* ShaderBuildProfiler::s_currentShaderObjectName = nullptr;
+	unsigned int ShaderBuildProfiler::s_activeTimers[static_cast<unsigned int>(Step::NUM_STEPS)] = {};
+
+	const char* ShaderBuildProfiler::GetStepName(Step _step)
+	{
+		static const char* stepNames[static_cast<unsigned int>(Step::NUM_STEPS)] =
+		{
+			"AddShaderFromFile",
+			"ReadShaderFromFile",
+			"FileIO",
+			"AddShader",
+			"CreateProgram",
+			"QueryProgramInformations"
+		};
+		return stepNames[static_cast<unsigned int>(_step)];
+	}
+
+	ShaderBuildProfiler::Timings::Timings()
+	{
+		for (unsigned int i = 0; i < static_cast<unsigned int>(Step::NUM_STEPS); ++i)
+		{
+			totalMilliseconds[i] = 0.0;
+			numCalls[i] = 0;
+		}
+	}
+
+	std::string ShaderBuildProfiler::GetReport()
+	{
+		std::ostringstream report;
+		report << std::fixed << std::setprecision(3);
+
+		auto writeTimings = [&report](const std::string& _name, const Timings& _timings)
+		{
+			report << _name << "\n";
+			for (unsigned int i = 0; i < static_cast<unsigned int>(Step::NUM_STEPS); ++i)
+			{
+				if (_timings.numCalls[i] == 0)
+					continue;
+				report << "  " << std::left << std::setw(28) << GetStepName(static_cast<Step>(i))
+					<< std::right << std::setw(12) << _timings.totalMilliseconds[i] << "ms"
+					<< std::setw(8) << _timings.numCalls[i] << " calls\n";
+			}
+		};
+
+		writeTimings("Shader build timings (global)", s_globalTimings);
+		for (auto it = s_shaderObjectTimings.begin(); it != s_shaderObjectTimings.end(); ++it)
+			writeTimings("ShaderObject \"" + it->first + "\"", it->second);
+
+		return report.str();
+	}
+
+	Result ShaderBuildProfiler::WriteCSV(const std::string& _filename)
+	{
+		std::ofstream file(_filename.c_str());
+		if (file.bad() || file.fail())
+		{
+			GLHELPER_LOG_ERROR("Unable to open " + _filename + " for writing shader build timings.");
+			return Result::FAILURE;
+		}
+
+		auto writeTimings = [&file](const std::string& _name, const Timings& _timings)
+		{
+			for (unsigned int i = 0; i < static_cast<unsigned int>(Step::NUM_STEPS); ++i)
+				file << "\"" << _name << "\"," << GetStepName(static_cast<Step>(i)) << "," << _timings.totalMilliseconds[i] << "," << _timings.numCalls[i] << "\n";
+		};
+
+		file << "ShaderObject,Step,TotalMilliseconds,NumCalls\n";
+		writeTimings("<global>", s_globalTimings);
+		for (auto it = s_shaderObjectTimings.begin(); it != s_shaderObjectTimings.end(); ++it)
+			writeTimings(it->first, it->second);
+
+		return file.fail() ? Result::FAILURE : Result::SUCCEEDED;
+	}
+
+	void ShaderBuildProfiler::Reset()
+	{
+		s_globalTimings = Timings();
+		s_shaderObjectTimings.clear();
+	}
+
+	ShaderBuildProfiler::ScopedTimer::ScopedTimer(Step _step, const std::string* _shaderObjectName) :
+		m_step(_step),
+		m_outermost(s_activeTimers[static_cast<unsigned int>(_step)] == 0),
+		m_previousShaderObjectName(s_currentShaderObjectName)
+	{
+		++s_activeTimers[static_cast<unsigned int>(m_step)];
+		if (_shaderObjectName != nullptr)
+			s_currentShaderObjectName = _shaderObjectName;
+
+		m_start = std::chrono::high_resolution_clock::now();
+	}
+
+	ShaderBuildProfiler::ScopedTimer::~ScopedTimer()
+	{
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_start).count();
+
+		--s_activeTimers[static_cast<unsigned int>(m_step)];
+		if (m_outermost)
+		{
+			s_globalTimings.totalMilliseconds[static_cast<unsigned int>(m_step)] += milliseconds;
+			++s_globalTimings.numCalls[static_cast<unsigned int>(m_step)];
+
+			if (s_currentShaderObjectName != nullptr)
+			{
+				Timings& timings = s_shaderObjectTimings[*s_currentShaderObjectName];
+				timings.totalMilliseconds[static_cast<unsigned int>(m_step)] += milliseconds;
+				++timings.numCalls[static_cast<unsigned int>(m_step)];
+			}
+		}
+
+		s_currentShaderObjectName = m_previousShaderObjectName;
+	}
+}
+
+#endif
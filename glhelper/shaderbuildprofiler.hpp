@@ -0,0 +1,103 @@
+#pragma once
+
+#include "gl.hpp"
+
+#ifdef SHADER_BUILD_PROFILING
+
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace gl
+{
+	/// Collects timings of the shader build pipeline (file I/O, #include expansion, compile, link and reflection).
+	///
+	/// Timings are aggregated globally and per ShaderObject name. Only available if SHADER_BUILD_PROFILING is defined,
+	/// otherwise all instrumentation compiles to nothing.
+	/// \remarks Not thread safe, like everything else that touches OpenGL.
+	class ShaderBuildProfiler
+	{
+	public:
+		/// Measured steps. Times are inclusive, e.g. ADD_SHADER_FROM_FILE contains READ_SHADER_FROM_FILE and ADD_SHADER.
+		enum class Step
+		{
+			ADD_SHADER_FROM_FILE,		///< ShaderObject::AddShaderFromFile
+			READ_SHADER_FROM_FILE,		///< Reading a shader file including all its #includes. Time minus FILE_IO is the #include expansion.
+			FILE_IO,					///< Opening and reading single files from disk
+			ADD_SHADER,					///< Creating & compiling a single shader stage (glCompileShader)
+			CREATE_PROGRAM,				///< Linking (glLinkProgram)
+			QUERY_PROGRAM_INFORMATIONS,	///< Program reflection
+
+			NUM_STEPS
+		};
+
+		/// Returns a readable name for a step.
+		static const char* GetStepName(Step _step);
+
+		/// Aggregated timings of all steps.
+		struct Timings
+		{
+			Timings();
+
+			double totalMilliseconds[static_cast<unsigned int>(Step::NUM_STEPS)];
+			std::uint32_t numCalls[static_cast<unsigned int>(Step::NUM_STEPS)];
+		};
+
+		/// Timings over all ShaderObjects and shader files.
+		static const Timings& GetGlobalTimings() { return s_globalTimings; }
+
+		/// Timings per ShaderObject name. Steps that did not happen on behalf of a ShaderObject are only in the global timings.
+		static const std::map<std::string, Timings>& GetTimingsPerShaderObject() { return s_shaderObjectTimings; }
+
+		/// Returns a human readable table of all timings.
+		static std::string GetReport();
+
+		/// Writes all timings into a csv file.
+		///
+		/// One line per ShaderObject and step, global timings use the name "<global>".
+		static Result WriteCSV(const std::string& _filename);
+
+		/// Clears all timings.
+		static void Reset();
+
+		/// Measures the time until it goes out of scope.
+		///
+		/// Nested timers of the same step (recursive calls) are not counted twice, only the outermost one is measured.
+		class ScopedTimer
+		{
+		public:
+			/// \param _shaderObjectName
+			///		Name under which the timing is recorded. If nullptr, the name of the enclosing timer is used.
+			ScopedTimer(Step _step, const std::string* _shaderObjectName);
+			~ScopedTimer();
+
+		private:
+			ScopedTimer(const ScopedTimer&) = delete;
+			void operator = (const ScopedTimer&) = delete;
+
+			Step m_step;
+			bool m_outermost;
+			const std::string* m_previousShaderObjectName;
+			std::chrono::high_resolution_clock::time_point m_start;
+		};
+
+	private:
+		static Timings s_globalTimings;
+		static std::map<std::string, Timings> s_shaderObjectTimings;
+
+		/// Name of the ShaderObject of the outermost active timer.
+		static const std::string* s_currentShaderObjectName;
+		/// Number of active timers per step.
+		static unsigned int s_activeTimers[static_cast<unsigned int>(Step::NUM_STEPS)];
+	};
+}
+
+/// Measures the time of the current scope as given ShaderBuildProfiler::Step.
+#define GLHELPER_PROFILE_SHADER_BUILD(step, shaderObjectName) \
+	::gl::ShaderBuildProfiler::ScopedTimer shaderBuildProfilerTimer(::gl::ShaderBuildProfiler::Step::step, shaderObjectName)
+
+#else
+
+#define GLHELPER_PROFILE_SHADER_BUILD(step, shaderObjectName) do { } while(false)
+
+#endif
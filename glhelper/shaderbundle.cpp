@@ -0,0 +1,280 @@
+#include "shaderbundle.hpp"
+#include "shaderobject.hpp"
+#include "utils/hash.hpp"
+#include "utils/pathutils.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <unordered_set>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace gl
+{
+	const char ShaderBundle::s_magic[4] = { 'G', 'L', 'S', 'B' };
+
+	std::string ShaderBundle::CanonicalizeEntryName(const std::string& _filename)
+	{
+		std::string name = PathUtils::CanonicalizePath(_filename);
+		for (char& c : name)
+		{
+			if (c >= 'A' && c <= 'Z')
+				c = c - 'A' + 'a';
+		}
+		return name;
+	}
+
+	ShaderBundle::ShaderBundle() :
+		m_data(nullptr),
+		m_size(0)
+#ifdef _WIN32
+		, m_fileHandle(INVALID_HANDLE_VALUE),
+		m_mappingHandle(nullptr)
+#endif
+	{
+	}
+
+	ShaderBundle::ShaderBundle(ShaderBundle&& _moved) :
+		m_filename(std::move(_moved.m_filename)),
+		m_data(_moved.m_data),
+		m_size(_moved.m_size)
+#ifdef _WIN32
+		, m_fileHandle(_moved.m_fileHandle),
+		m_mappingHandle(_moved.m_mappingHandle)
+#endif
+	{
+		_moved.m_data = nullptr;
+		_moved.m_size = 0;
+#ifdef _WIN32
+		_moved.m_fileHandle = INVALID_HANDLE_VALUE;
+		_moved.m_mappingHandle = nullptr;
+#endif
+	}
+
+	ShaderBundle::~ShaderBundle()
+	{
+		Close();
+	}
+
+	Result ShaderBundle::Open(const std::string& _bundleFilename)
+	{
+		Close();
+
+		// Map whole file.
+#ifdef _WIN32
+		m_fileHandle = CreateFileA(_bundleFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (m_fileHandle == INVALID_HANDLE_VALUE)
+		{
+			GLHELPER_LOG_ERROR("Unable to open shader bundle " + _bundleFilename);
+			return Result::FAILURE;
+		}
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(m_fileHandle, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header)))
+		{
+			GLHELPER_LOG_ERROR("Shader bundle " + _bundleFilename + " is too small.");
+			Close();
+			return Result::FAILURE;
+		}
+		m_size = static_cast<size_t>(fileSize.QuadPart);
+		m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_mappingHandle != nullptr)
+			m_data = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+		int fileDescriptor = open(_bundleFilename.c_str(), O_RDONLY);
+		if (fileDescriptor < 0)
+		{
+			GLHELPER_LOG_ERROR("Unable to open shader bundle " + _bundleFilename);
+			return Result::FAILURE;
+		}
+		struct stat fileStatus;
+		if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size < static_cast<off_t>(sizeof(Header)))
+		{
+			GLHELPER_LOG_ERROR("Shader bundle " + _bundleFilename + " is too small.");
+			close(fileDescriptor);
+			return Result::FAILURE;
+		}
+		m_size = static_cast<size_t>(fileStatus.st_size);
+		void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		close(fileDescriptor); // The mapping stays valid.
+		if (mapping != MAP_FAILED)
+			m_data = static_cast<const char*>(mapping);
+#endif
+		if (m_data == nullptr)
+		{
+			GLHELPER_LOG_ERROR("Unable to map shader bundle " + _bundleFilename + " into memory.");
+			Close();
+			return Result::FAILURE;
+		}
+		m_filename = _bundleFilename;
+
+		// Validate header and offset table once, so that accessing entries needs no further checks.
+		const Header& header = GetHeader();
+		if (memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 || header.version != s_version)
+		{
+			GLHELPER_LOG_ERROR("File " + _bundleFilename + " is not a shader bundle or has an unsupported version.");
+			Close();
+			return Result::FAILURE;
+		}
+		if (header.numEntries > (m_size - sizeof(Header)) / sizeof(Entry))
+		{
+			GLHELPER_LOG_ERROR("Shader bundle " + _bundleFilename + " is truncated.");
+			Close();
+			return Result::FAILURE;
+		}
+		for (std::uint32_t i = 0; i < header.numEntries; ++i)
+		{
+			const Entry& entry = GetEntries()[i];
+			if (static_cast<std::uint64_t>(entry.nameOffset) + entry.nameLength > m_size || entry.dataOffset > m_size || entry.dataSize > m_size - entry.dataOffset)
+			{
+				GLHELPER_LOG_ERROR("Shader bundle " + _bundleFilename + " contains invalid entry offsets.");
+				Close();
+				return Result::FAILURE;
+			}
+		}
+
+		return Result::SUCCEEDED;
+	}
+
+	void ShaderBundle::Close()
+	{
+#ifdef _WIN32
+		if (m_data != nullptr)
+			UnmapViewOfFile(m_data);
+		if (m_mappingHandle != nullptr)
+			CloseHandle(m_mappingHandle);
+		if (m_fileHandle != INVALID_HANDLE_VALUE)
+			CloseHandle(m_fileHandle);
+		m_mappingHandle = nullptr;
+		m_fileHandle = INVALID_HANDLE_VALUE;
+#else
+		if (m_data != nullptr)
+			munmap(const_cast<char*>(m_data), m_size);
+#endif
+		m_data = nullptr;
+		m_size = 0;
+		m_filename.clear();
+	}
+
+	const ShaderBundle::Entry& ShaderBundle::GetEntry(std::uint32_t _index) const
+	{
+		GLHELPER_ASSERT(_index < GetNumEntries(), "Shader bundle entry index out of range!");
+		return GetEntries()[_index];
+	}
+
+	bool ShaderBundle::VerifyEntry(const Entry& _entry) const
+	{
+		return HashUtils::FNV1a(GetEntrySource(_entry), static_cast<size_t>(_entry.dataSize)) == _entry.hash;
+	}
+
+	const ShaderBundle::Entry* ShaderBundle::FindEntry(const std::string& _name) const
+	{
+		if (!IsOpen())
+			return nullptr;
+
+		std::string name = CanonicalizeEntryName(_name);
+
+		// Entries are sorted by name.
+		const Entry* begin = GetEntries();
+		const Entry* end = begin + GetHeader().numEntries;
+		const Entry* entry = std::lower_bound(begin, end, name, [this](const Entry& _entry, const std::string& _searchedName) {
+			return _searchedName.compare(0, std::string::npos, m_data + _entry.nameOffset, _entry.nameLength) > 0;
+		});
+
+		if (entry == end || name.compare(0, std::string::npos, m_data + entry->nameOffset, entry->nameLength) != 0)
+			return nullptr;
+
+		// Offsets were validated on Open, but the content might still be corrupted.
+		if (!VerifyEntry(*entry))
+		{
+			GLHELPER_LOG_ERROR("Shader bundle " + m_filename + " entry \"" + name + "\" is corrupted (hash mismatch).");
+			return nullptr;
+		}
+		return entry;
+	}
+
+
+	Result ShaderBundleWriter::AddShaderFile(const std::string& _filename)
+	{
+		std::unordered_set<std::string> includingFiles, allFiles;
+		std::string sourceCode = ShaderObject::ReadShaderFromFile(_filename, "", 0, includingFiles, allFiles);
+		if (sourceCode == "")
+			return Result::FAILURE;
+
+		std::string name = ShaderBundle::CanonicalizeEntryName(_filename);
+		auto existingEntry = std::find_if(m_entries.begin(), m_entries.end(), [&name](const SourceEntry& _entry) { return _entry.name == name; });
+		if (existingEntry != m_entries.end())
+			existingEntry->source = std::move(sourceCode);
+		else
+		{
+			SourceEntry entry;
+			entry.name = std::move(name);
+			entry.source = std::move(sourceCode);
+			m_entries.push_back(std::move(entry));
+		}
+
+		return Result::SUCCEEDED;
+	}
+
+	Result ShaderBundleWriter::Write(const std::string& _bundleFilename) const
+	{
+		// Sorted entries allow binary search when reading.
+		std::vector<const SourceEntry*> sortedEntries;
+		for (const SourceEntry& entry : m_entries)
+			sortedEntries.push_back(&entry);
+		std::sort(sortedEntries.begin(), sortedEntries.end(), [](const SourceEntry* _a, const SourceEntry* _b) { return _a->name < _b->name; });
+
+		ShaderBundle::Header header;
+		memcpy(header.magic, ShaderBundle::s_magic, sizeof(header.magic));
+		header.version = ShaderBundle::s_version;
+		header.numEntries = static_cast<std::uint32_t>(sortedEntries.size());
+		header.reserved = 0;
+
+		// Compute offset table.
+		std::vector<ShaderBundle::Entry> table(sortedEntries.size());
+		std::uint64_t offset = sizeof(ShaderBundle::Header) + sizeof(ShaderBundle::Entry) * table.size();
+		for (size_t i = 0; i < sortedEntries.size(); ++i)
+		{
+			table[i].nameOffset = static_cast<std::uint32_t>(offset);
+			table[i].nameLength = static_cast<std::uint32_t>(sortedEntries[i]->name.size());
+			offset += sortedEntries[i]->name.size();
+		}
+		for (size_t i = 0; i < sortedEntries.size(); ++i)
+		{
+			table[i].dataOffset = offset;
+			table[i].dataSize = sortedEntries[i]->source.size();
+			table[i].hash = HashUtils::FNV1a(sortedEntries[i]->source.data(), sortedEntries[i]->source.size());
+			offset += sortedEntries[i]->source.size();
+		}
+
+		// Write.
+		std::ofstream file(_bundleFilename.c_str(), std::ios::binary);
+		if (file.bad() || file.fail())
+		{
+			GLHELPER_LOG_ERROR("Unable to open " + _bundleFilename + " for writing.");
+			return Result::FAILURE;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (!table.empty())
+			file.write(reinterpret_cast<const char*>(table.data()), sizeof(ShaderBundle::Entry) * table.size());
+		for (const SourceEntry* entry : sortedEntries)
+			file.write(entry->name.data(), entry->name.size());
+		for (const SourceEntry* entry : sortedEntries)
+			file.write(entry->source.data(), entry->source.size());
+
+		if (file.fail())
+		{
+			GLHELPER_LOG_ERROR("Failed to write shader bundle " + _bundleFilename);
+			return Result::FAILURE;
+		}
+		return Result::SUCCEEDED;
+	}
+}
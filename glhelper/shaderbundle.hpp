@@ -0,0 +1,134 @@
+#pragma once
+
+#include "gl.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace gl
+{
+	/// Read-only view of a shader bundle file, a single archive containing shader sources with all #includes already resolved.
+	///
+	/// Bundles are created offline with ShaderBundleWriter (see tools/shaderpack). The whole file is memory mapped on Open,
+	/// entries are accessed without any further file operations. Use ShaderObject::AddShaderFromBundle to compile an entry.
+	///
+	/// File layout (native byte order):
+	/// - Header
+	/// - Entry table, sorted by name
+	/// - Name data (not null terminated)
+	/// - Source data (not null terminated)
+	class ShaderBundle
+	{
+	public:
+		ShaderBundle(const ShaderBundle&) = delete;
+		void operator = (const ShaderBundle&) = delete;
+		void operator = (ShaderBundle&&) = delete;
+
+		/// File header.
+		struct Header
+		{
+			char magic[4];				///< Always s_magic.
+			std::uint32_t version;		///< Always s_version.
+			std::uint32_t numEntries;
+			std::uint32_t reserved;
+		};
+
+		/// Entry of the offset table. All offsets are in bytes from the start of the file.
+		struct Entry
+		{
+			std::uint32_t nameOffset;
+			std::uint32_t nameLength;
+			std::uint64_t dataOffset;
+			std::uint64_t dataSize;
+			std::uint64_t hash;			///< FNV1a hash of the source data. \see HashUtils::FNV1a
+		};
+
+		static const char s_magic[4];
+		static const std::uint32_t s_version = 2;
+
+		/// Canonicalizes a filename to the name of its entry: Canonicalized path (see PathUtils::CanonicalizePath) in ASCII lower case.
+		///
+		/// Used by both ShaderBundleWriter and FindEntry, so that entries are found regardless of slash style and case.
+		static std::string CanonicalizeEntryName(const std::string& _filename);
+
+		/// Creates an empty bundle, call Open to map a file.
+		ShaderBundle();
+		ShaderBundle(ShaderBundle&& _moved);
+		~ShaderBundle();
+
+		/// Maps the given bundle file into memory and validates its header and offset table.
+		///
+		/// Closes any previously opened file.
+		Result Open(const std::string& _bundleFilename);
+
+		/// Unmaps the bundle file. All pointers obtained from this bundle become invalid.
+		void Close();
+
+		bool IsOpen() const { return m_data != nullptr; }
+		const std::string& GetFilename() const { return m_filename; }
+
+		/// Number of contained shader sources.
+		std::uint32_t GetNumEntries() const { return IsOpen() ? GetHeader().numEntries : 0; }
+
+		/// Returns the entry with the given index.
+		const Entry& GetEntry(std::uint32_t _index) const;
+
+		/// Returns the name of an entry. This is the filename given to the ShaderBundleWriter, canonicalized with CanonicalizeEntryName.
+		std::string GetEntryName(const Entry& _entry) const { return std::string(m_data + _entry.nameOffset, _entry.nameLength); }
+
+		/// Returns a pointer to the source code of an entry. Not null terminated, see Entry::dataSize.
+		const char* GetEntrySource(const Entry& _entry) const { return m_data + _entry.dataOffset; }
+
+		/// Returns true if the hash of the entry's source data matches the hash stored on packing.
+		bool VerifyEntry(const Entry& _entry) const;
+
+		/// Searches for an entry by name via binary search and verifies its source data.
+		///
+		/// \param _name
+		///		Filename of the entry, is canonicalized with CanonicalizeEntryName.
+		/// \return
+		///		nullptr if there is no such entry or if its source data is corrupted (logs an error).
+		const Entry* FindEntry(const std::string& _name) const;
+
+	private:
+		const Header& GetHeader() const { return *reinterpret_cast<const Header*>(m_data); }
+		const Entry* GetEntries() const { return reinterpret_cast<const Entry*>(m_data + sizeof(Header)); }
+
+		std::string m_filename;
+
+		const char* m_data;
+		size_t m_size;
+
+#ifdef _WIN32
+		void* m_fileHandle;
+		void* m_mappingHandle;
+#endif
+	};
+
+	/// Collects shader files with all #includes resolved and writes them into a ShaderBundle file.
+	///
+	/// Uses the same #include handling as ShaderObject::AddShaderFromFile. Does not require an OpenGL context.
+	class ShaderBundleWriter
+	{
+	public:
+		/// Reads a shader file, resolves all its #includes and adds it to the bundle.
+		///
+		/// The entry name is the filename canonicalized with ShaderBundle::CanonicalizeEntryName. Adding a file twice replaces the previous entry.
+		Result AddShaderFile(const std::string& _filename);
+
+		/// Number of shader files added so far.
+		size_t GetNumEntries() const { return m_entries.size(); }
+
+		/// Writes all added shader files into a bundle file.
+		Result Write(const std::string& _bundleFilename) const;
+
+	private:
+		struct SourceEntry
+		{
+			std::string name;
+			std::string source;
+		};
+		std::vector<SourceEntry> m_entries;
+	};
+}
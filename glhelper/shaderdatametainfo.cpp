@@ -0,0 +1,96 @@
+#include "shaderdatametainfo.hpp"
+
+#include <vector>
+
+namespace gl
+{
+	bool GetShaderVariableTypeLayout(ShaderVariableType _type, ShaderVariableTypeLayout& _layout)
+	{
+		typedef ShaderVariableTypeLayout::ComponentType ComponentType;
+
+		// matCxR: C columns, R rows
+		switch (_type)
+		{
+		case ShaderVariableType::FLOAT:				_layout = { ComponentType::FLOAT, 4, 1, 1 }; return true;
+		case ShaderVariableType::FLOAT_VEC2:		_layout = { ComponentType::FLOAT, 4, 2, 1 }; return true;
+		case ShaderVariableType::FLOAT_VEC3:		_layout = { ComponentType::FLOAT, 4, 3, 1 }; return true;
+		case ShaderVariableType::FLOAT_VEC4:		_layout = { ComponentType::FLOAT, 4, 4, 1 }; return true;
+		case ShaderVariableType::DOUBLE:			_layout = { ComponentType::DOUBLE, 8, 1, 1 }; return true;
+		case ShaderVariableType::DOUBLE_VEC2:		_layout = { ComponentType::DOUBLE, 8, 2, 1 }; return true;
+		case ShaderVariableType::DOUBLE_VEC3:		_layout = { ComponentType::DOUBLE, 8, 3, 1 }; return true;
+		case ShaderVariableType::DOUBLE_VEC4:		_layout = { ComponentType::DOUBLE, 8, 4, 1 }; return true;
+		case ShaderVariableType::INT:				_layout = { ComponentType::INT, 4, 1, 1 }; return true;
+		case ShaderVariableType::INT_VEC2:			_layout = { ComponentType::INT, 4, 2, 1 }; return true;
+		case ShaderVariableType::INT_VEC3:			_layout = { ComponentType::INT, 4, 3, 1 }; return true;
+		case ShaderVariableType::INT_VEC4:			_layout = { ComponentType::INT, 4, 4, 1 }; return true;
+		case ShaderVariableType::UNSIGNED_INT:		_layout = { ComponentType::UNSIGNED_INT, 4, 1, 1 }; return true;
+		case ShaderVariableType::UNSIGNED_INT_VEC2:	_layout = { ComponentType::UNSIGNED_INT, 4, 2, 1 }; return true;
+		case ShaderVariableType::UNSIGNED_INT_VEC3:	_layout = { ComponentType::UNSIGNED_INT, 4, 3, 1 }; return true;
+		case ShaderVariableType::UNSIGNED_INT_VEC4:	_layout = { ComponentType::UNSIGNED_INT, 4, 4, 1 }; return true;
+		case ShaderVariableType::BOOL:				_layout = { ComponentType::BOOL, 4, 1, 1 }; return true;
+		case ShaderVariableType::BOOL_VEC2:			_layout = { ComponentType::BOOL, 4, 2, 1 }; return true;
+		case ShaderVariableType::BOOL_VEC3:			_layout = { ComponentType::BOOL, 4, 3, 1 }; return true;
+		case ShaderVariableType::BOOL_VEC4:			_layout = { ComponentType::BOOL, 4, 4, 1 }; return true;
+		case ShaderVariableType::FLOAT_MAT2:		_layout = { ComponentType::FLOAT, 4, 2, 2 }; return true;
+		case ShaderVariableType::FLOAT_MAT3:		_layout = { ComponentType::FLOAT, 4, 3, 3 }; return true;
+		case ShaderVariableType::FLOAT_MAT4:		_layout = { ComponentType::FLOAT, 4, 4, 4 }; return true;
+		case ShaderVariableType::FLOAT_MAT2x3:		_layout = { ComponentType::FLOAT, 4, 3, 2 }; return true;
+		case ShaderVariableType::FLOAT_MAT2x4:		_layout = { ComponentType::FLOAT, 4, 4, 2 }; return true;
+		case ShaderVariableType::FLOAT_MAT3x2:		_layout = { ComponentType::FLOAT, 4, 2, 3 }; return true;
+		case ShaderVariableType::FLOAT_MAT3x4:		_layout = { ComponentType::FLOAT, 4, 4, 3 }; return true;
+		case ShaderVariableType::FLOAT_MAT4x2:		_layout = { ComponentType::FLOAT, 4, 2, 4 }; return true;
+		case ShaderVariableType::FLOAT_MAT4x3:		_layout = { ComponentType::FLOAT, 4, 3, 4 }; return true;
+		case ShaderVariableType::DOUBLE_MAT2:		_layout = { ComponentType::DOUBLE, 8, 2, 2 }; return true;
+		case ShaderVariableType::DOUBLE_MAT3:		_layout = { ComponentType::DOUBLE, 8, 3, 3 }; return true;
+		case ShaderVariableType::DOUBLE_MAT4:		_layout = { ComponentType::DOUBLE, 8, 4, 4 }; return true;
+		case ShaderVariableType::DOUBLE_MAT2x3:		_layout = { ComponentType::DOUBLE, 8, 3, 2 }; return true;
+		case ShaderVariableType::DOUBLE_MAT2x4:		_layout = { ComponentType::DOUBLE, 8, 4, 2 }; return true;
+		case ShaderVariableType::DOUBLE_MAT3x2:		_layout = { ComponentType::DOUBLE, 8, 2, 3 }; return true;
+		case ShaderVariableType::DOUBLE_MAT3x4:		_layout = { ComponentType::DOUBLE, 8, 4, 3 }; return true;
+		case ShaderVariableType::DOUBLE_MAT4x2:		_layout = { ComponentType::DOUBLE, 8, 2, 4 }; return true;
+		case ShaderVariableType::DOUBLE_MAT4x3:		_layout = { ComponentType::DOUBLE, 8, 3, 4 }; return true;
+		default:
+			return false;
+		}
+	}
+
+	namespace
+	{
+		/// Expands strided elements into a temporary that covers the whole destination range, including the padding in between.
+		void ExpandStrided(std::vector<std::uint8_t>& _expanded, const void* _data, GLsizei _elementSize, GLsizei _sourceStride, GLsizei _numElements, GLsizei _destinationStride)
+		{
+			_expanded.assign((_numElements - 1) * _destinationStride + _elementSize, 0);
+			StridedCopyUtils::StridedCopy(_expanded.data(), _destinationStride, _data, _sourceStride, _elementSize, _numElements);
+		}
+	}
+
+	void FunctionWritePolicy::WriteStrided(const void* _data, GLsizei _elementSize, GLsizei _sourceStride, GLsizei _numElements, std::int32_t _offset, GLsizei _destinationStride) const
+	{
+		if (_numElements <= 0)
+			return;
+		if (_numElements == 1 || (_elementSize == _destinationStride && _elementSize == _sourceStride))
+		{
+			m_setVariableFunction(_data, _numElements * _elementSize, _offset);
+			return;
+		}
+
+		std::vector<std::uint8_t> expanded;
+		ExpandStrided(expanded, _data, _elementSize, _sourceStride, _numElements, _destinationStride);
+		m_setVariableFunction(expanded.data(), static_cast<GLsizei>(expanded.size()), _offset);
+	}
+
+	void BufferSetWritePolicy::WriteStrided(const void* _data, GLsizei _elementSize, GLsizei _sourceStride, GLsizei _numElements, std::int32_t _offset, GLsizei _destinationStride) const
+	{
+		if (_numElements <= 0)
+			return;
+		if (_numElements == 1 || (_elementSize == _destinationStride && _elementSize == _sourceStride))
+		{
+			m_buffer.Set(_data, m_bufferOffset + _offset, _numElements * _elementSize);
+			return;
+		}
+
+		std::vector<std::uint8_t> expanded;
+		ExpandStrided(expanded, _data, _elementSize, _sourceStride, _numElements, _destinationStride);
+		m_buffer.Set(expanded.data(), m_bufferOffset + _offset, expanded.size());
+	}
+}
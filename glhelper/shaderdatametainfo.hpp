@@ -1,9 +1,16 @@
 #pragma once
 
 #include "gl.hpp"
+#include "buffer.hpp"
+#include "utils/stridedcopy.hpp"
+#include "utils/floatconversion.hpp"
 #include <unordered_map>
+#include <vector>
 #include <cstdint>
 #include <functional>
+#include <algorithm>
+#include <limits>
+#include <cstring>
 
 namespace gl
 {
@@ -125,6 +132,33 @@ namespace gl
 		UNSIGNED_INT_ATOMIC_COUNTER = GL_UNSIGNED_INT_ATOMIC_COUNTER
 	};
 
+	/// Memory layout of a single (non-array) shader variable type as used in buffer blocks.
+	struct ShaderVariableTypeLayout
+	{
+		enum class ComponentType
+		{
+			FLOAT,
+			DOUBLE,
+			INT,
+			UNSIGNED_INT,
+			BOOL ///< Occupies 32 bit in buffers.
+		};
+
+		ComponentType componentType;
+		unsigned int componentSize;		///< Size of a single component in bytes.
+		unsigned int numRows;			///< Number of vector components, or number of rows of a matrix.
+		unsigned int numColumns;		///< Number of matrix columns, 1 for scalars and vectors.
+
+		/// Size of a tightly packed CPU-side equivalent (e.g. gl::Vec3 or gl::Mat3) in bytes.
+		unsigned int GetPackedSize() const { return componentSize * numRows * numColumns; }
+	};
+
+	/// Retrieves the memory layout of a shader variable type.
+	///
+	/// \return
+	///		False for types that can not be part of a buffer block (samplers, images, atomic counters).
+	bool GetShaderVariableTypeLayout(ShaderVariableType _type, ShaderVariableTypeLayout& _layout);
+
 	/// Basic information block for Buffer information
 	template<typename VariableType>
 	struct BufferInfo
@@ -175,13 +209,35 @@ namespace gl
 
 	typedef BufferInfo<BufferVariableInfo> ShaderStorageBufferMetaInfo;
 	typedef BufferInfo<UniformVariableInfo> UniformBufferMetaInfo;
+	/// Atomic counter buffers have no name, variables are the contained atomic counters.
+	typedef BufferInfo<UniformVariableInfo> AtomicCounterBufferMetaInfo;
 
+	/// Information block for a subroutine uniform.
+	struct SubroutineUniformInfo
+	{
+		GLint location;					///< First subroutine uniform location.
+		std::int32_t arrayElementCount;	///< Number of array elements, each occupies one location.
+		std::vector<GLuint> compatibleSubroutines; ///< Indices of all subroutines that can be assigned to this uniform.
+	};
 
-	/// Helper for easy use of buffer meta info.
+	/// Subroutine information of a single shader stage.
+	struct SubroutineStageInfo
+	{
+		SubroutineStageInfo() : numUniformLocations(0) {}
+
+		/// Subroutine uniforms by name.
+		std::unordered_map<std::string, SubroutineUniformInfo> uniforms;
+		/// Subroutine indices by function name.
+		std::unordered_map<std::string, GLuint> subroutines;
+		/// Number of active subroutine uniform locations. glUniformSubroutinesuiv always needs to set all of them.
+		GLint numUniformLocations;
+	};
+
+
+	/// Write policy for BufferInfoView that calls an arbitrary function for each set command.
 	///
-	/// Can be used to set memory in a buffer by given variables. Note however, that it is always much more efficient to write manually to the corresponding memory.
-	template<typename VariableInfoType>
-	class BufferInfoView
+	/// Most flexible, but every write is an indirect call that cannot be inlined.
+	class FunctionWritePolicy
 	{
 	public:
 		/// Function called for each set command. 
@@ -190,28 +246,200 @@ namespace gl
 		/// 3) offset of the data within the buffer
 		typedef std::function<void(const void* _data, GLsizei _sizeInBytes, std::int32_t _offset)> SetVariableFunction;
 
-		/// Creates a buffer view from buffer meta info and a set variable function.
-		BufferInfoView(const BufferInfo<VariableInfoType>& _bufferInfo, const SetVariableFunction& _setVariableFunction) : 
-				m_bufferInfo(_bufferInfo), m_setVariableFunction(_setVariableFunction) {}
+		template<typename Function>
+		FunctionWritePolicy(const Function& _setVariableFunction) : m_setVariableFunction(_setVariableFunction) {}
+
+		void Write(const void* _data, GLsizei _sizeInBytes, std::int32_t _offset) const { m_setVariableFunction(_data, _sizeInBytes, _offset); }
+
+		/// Expands the elements into a temporary and calls the function once for the whole range.
+		void WriteStrided(const void* _data, GLsizei _elementSize, GLsizei _sourceStride, GLsizei _numElements, std::int32_t _offset, GLsizei _destinationStride) const;
+
+	private:
+		const SetVariableFunction m_setVariableFunction;
+	};
+
+	/// Write policy for BufferInfoView that copies directly into a piece of mapped memory.
+	///
+	/// Since all Set overloads pass fixed sizes, each write compiles down to plain stores.
+	class MappedMemoryWritePolicy
+	{
+	public:
+		/// \param _mappedMemory
+		///		Pointer to the mapped memory.
+		/// \param _mapOffset
+		///		Offset of the mapped memory within the buffer.
+		MappedMemoryWritePolicy(void* _mappedMemory, GLsizei _mapOffset = 0) : m_mappedMemory(reinterpret_cast<char*>(_mappedMemory)), m_mapOffset(_mapOffset) {}
+
+		void Write(const void* _data, GLsizei _sizeInBytes, std::int32_t _offset) const
+		{
+			GLHELPER_ASSERT(_offset >= m_mapOffset, "Variable is outside of mapped memory area!");
+			// TODO: Overflow check!
+			memcpy(m_mappedMemory + (_offset - m_mapOffset), _data, _sizeInBytes);
+		}
+
+		void WriteStrided(const void* _data, GLsizei _elementSize, GLsizei _sourceStride, GLsizei _numElements, std::int32_t _offset, GLsizei _destinationStride) const
+		{
+			GLHELPER_ASSERT(_offset >= m_mapOffset, "Variable is outside of mapped memory area!");
+			StridedCopyUtils::StridedCopy(m_mappedMemory + (_offset - m_mapOffset), _destinationStride, _data, _sourceStride, _elementSize, _numElements);
+		}
+
+	private:
+		char* const m_mappedMemory;
+		const GLsizei m_mapOffset;
+	};
+
+	/// Write policy for BufferInfoView that updates a buffer with Buffer::Set (glNamedBufferSubData) for each write.
+	///
+	/// Only suitable for few writes, consider StagingWritePolicy for many variables.
+	class BufferSetWritePolicy
+	{
+	public:
+		/// \param _bufferOffset
+		///		Offset of the block within the buffer.
+		BufferSetWritePolicy(Buffer& _buffer, GLintptr _bufferOffset = 0) : m_buffer(_buffer), m_bufferOffset(_bufferOffset) {}
+
+		void Write(const void* _data, GLsizei _sizeInBytes, std::int32_t _offset) const { m_buffer.Set(_data, m_bufferOffset + _offset, _sizeInBytes); }
+
+		/// Expands the elements into a temporary and updates the whole range with a single Buffer::Set.
+		void WriteStrided(const void* _data, GLsizei _elementSize, GLsizei _sourceStride, GLsizei _numElements, std::int32_t _offset, GLsizei _destinationStride) const;
+
+	private:
+		Buffer& m_buffer;
+		const GLintptr m_bufferOffset;
+	};
+
+	/// Write policy for BufferInfoView that writes into CPU side staging memory and tracks the written range.
+	///
+	/// Call Upload to transfer all changes with a single Buffer::Set.
+	class StagingWritePolicy
+	{
+	public:
+		/// \param _stagingMemory
+		///		Memory block that mirrors the buffer block. Needs to be at least bufferDataSizeByte large.
+		StagingWritePolicy(void* _stagingMemory) : m_stagingMemory(reinterpret_cast<char*>(_stagingMemory)), m_dirtyBegin(std::numeric_limits<std::int32_t>::max()), m_dirtyEnd(0) {}
+
+		void Write(const void* _data, GLsizei _sizeInBytes, std::int32_t _offset) const
+		{
+			memcpy(m_stagingMemory + _offset, _data, _sizeInBytes);
+			m_dirtyBegin = std::min(m_dirtyBegin, _offset);
+			m_dirtyEnd = std::max(m_dirtyEnd, _offset + _sizeInBytes);
+		}
+
+		void WriteStrided(const void* _data, GLsizei _elementSize, GLsizei _sourceStride, GLsizei _numElements, std::int32_t _offset, GLsizei _destinationStride) const
+		{
+			if (_numElements <= 0)
+				return;
+			StridedCopyUtils::StridedCopy(m_stagingMemory + _offset, _destinationStride, _data, _sourceStride, _elementSize, _numElements);
+			m_dirtyBegin = std::min(m_dirtyBegin, _offset);
+			m_dirtyEnd = std::max(m_dirtyEnd, _offset + (_numElements - 1) * _destinationStride + _elementSize);
+		}
+
+		/// Returns true if anything was written since the last upload.
+		bool IsDirty() const { return m_dirtyEnd > m_dirtyBegin; }
+
+		/// Uploads the written range (including unchanged bytes in between) to a buffer and resets the dirty range.
+		///
+		/// \param _bufferOffset
+		///		Offset of the block within the buffer.
+		void Upload(Buffer& _buffer, GLintptr _bufferOffset = 0)
+		{
+			if (!IsDirty())
+				return;
+			_buffer.Set(m_stagingMemory + m_dirtyBegin, _bufferOffset + m_dirtyBegin, m_dirtyEnd - m_dirtyBegin);
+			m_dirtyBegin = std::numeric_limits<std::int32_t>::max();
+			m_dirtyEnd = 0;
+		}
+
+	private:
+		char* const m_stagingMemory;
+		mutable std::int32_t m_dirtyBegin;
+		mutable std::int32_t m_dirtyEnd;
+	};
+
+	namespace Details
+	{
+		/// Maps CPU types to shader variable types, used for type checks in BufferInfoView::SetableVariable::SetArray.
+		template<typename T> struct ShaderVariableTypeOf;
+		template<> struct ShaderVariableTypeOf<float>			{ static const ShaderVariableType value = ShaderVariableType::FLOAT; };
+		template<> struct ShaderVariableTypeOf<gl::Vec2>		{ static const ShaderVariableType value = ShaderVariableType::FLOAT_VEC2; };
+		template<> struct ShaderVariableTypeOf<gl::Vec3>		{ static const ShaderVariableType value = ShaderVariableType::FLOAT_VEC3; };
+		template<> struct ShaderVariableTypeOf<gl::Vec4>		{ static const ShaderVariableType value = ShaderVariableType::FLOAT_VEC4; };
+		template<> struct ShaderVariableTypeOf<gl::Mat3>		{ static const ShaderVariableType value = ShaderVariableType::FLOAT_MAT3; };
+		template<> struct ShaderVariableTypeOf<gl::Mat4>		{ static const ShaderVariableType value = ShaderVariableType::FLOAT_MAT4; };
+		template<> struct ShaderVariableTypeOf<double>			{ static const ShaderVariableType value = ShaderVariableType::DOUBLE; };
+		template<> struct ShaderVariableTypeOf<gl::DVec2>		{ static const ShaderVariableType value = ShaderVariableType::DOUBLE_VEC2; };
+		template<> struct ShaderVariableTypeOf<gl::DVec3>		{ static const ShaderVariableType value = ShaderVariableType::DOUBLE_VEC3; };
+		template<> struct ShaderVariableTypeOf<gl::DVec4>		{ static const ShaderVariableType value = ShaderVariableType::DOUBLE_VEC4; };
+		template<> struct ShaderVariableTypeOf<gl::DMat3>		{ static const ShaderVariableType value = ShaderVariableType::DOUBLE_MAT3; };
+		template<> struct ShaderVariableTypeOf<gl::DMat4>		{ static const ShaderVariableType value = ShaderVariableType::DOUBLE_MAT4; };
+		template<> struct ShaderVariableTypeOf<std::uint32_t>	{ static const ShaderVariableType value = ShaderVariableType::UNSIGNED_INT; };
+		template<> struct ShaderVariableTypeOf<gl::UVec2>		{ static const ShaderVariableType value = ShaderVariableType::UNSIGNED_INT_VEC2; };
+		template<> struct ShaderVariableTypeOf<gl::UVec3>		{ static const ShaderVariableType value = ShaderVariableType::UNSIGNED_INT_VEC3; };
+		template<> struct ShaderVariableTypeOf<gl::UVec4>		{ static const ShaderVariableType value = ShaderVariableType::UNSIGNED_INT_VEC4; };
+		template<> struct ShaderVariableTypeOf<std::int32_t>	{ static const ShaderVariableType value = ShaderVariableType::INT; };
+		template<> struct ShaderVariableTypeOf<gl::IVec2>		{ static const ShaderVariableType value = ShaderVariableType::INT_VEC2; };
+		template<> struct ShaderVariableTypeOf<gl::IVec3>		{ static const ShaderVariableType value = ShaderVariableType::INT_VEC3; };
+		template<> struct ShaderVariableTypeOf<gl::IVec4>		{ static const ShaderVariableType value = ShaderVariableType::INT_VEC4; };
+	}
+
+	/// Helper for easy use of buffer meta info.
+	///
+	/// Can be used to set memory in a buffer by given variables. Note however, that it is always much more efficient to write manually to the corresponding memory.
+	/// How data is written is determined by the WritePolicy, which needs to provide the const methods
+	/// Write(const void* _data, GLsizei _sizeInBytes, std::int32_t _offset) and
+	/// WriteStrided(const void* _data, GLsizei _elementSize, GLsizei _sourceStride, GLsizei _numElements, std::int32_t _offset, GLsizei _destinationStride).
+	/// \see FunctionWritePolicy, MappedMemoryWritePolicy, BufferSetWritePolicy, StagingWritePolicy
+	template<typename VariableInfoType, typename WritePolicy = FunctionWritePolicy>
+	class BufferInfoView
+	{
+	public:
+		typedef FunctionWritePolicy::SetVariableFunction SetVariableFunction;
+
+		/// Creates a buffer view from buffer meta info and a write policy.
+		///
+		/// For the default FunctionWritePolicy any function object with the signature of SetVariableFunction can be passed.
+		BufferInfoView(const BufferInfo<VariableInfoType>& _bufferInfo, const WritePolicy& _writePolicy) : 
+				m_bufferInfo(_bufferInfo), m_writePolicy(_writePolicy) {}
+
+		/// Resolved variable, optionally pointing to a single element of an array.
+		///
+		/// Resolving a name costs a hash lookup and for names with array index also string operations. Resolve names once and store the handle.
+		struct VariableHandle
+		{
+			VariableHandle() : metaInfo(nullptr), offset(0), arrayIndex(0) {}
+			bool IsValid() const { return metaInfo != nullptr; }
+
+			const VariableInfoType* metaInfo;
+			std::int32_t offset;		///< Offset of the first array element. Differs from the blockOffset for elements of top level arrays in shader storage blocks.
+			std::int32_t arrayIndex;	///< Array element the handle points to.
+		};
 
 		class SetableVariable
 		{
 		public:
-			SetableVariable(const VariableInfoType& _metaInfo, const BufferInfoView<VariableInfoType>& _parentBuffer) : m_MetaInfo(_metaInfo), m_parentBuffer(_parentBuffer) {}
+			SetableVariable(const VariableInfoType& _metaInfo, const BufferInfoView<VariableInfoType, WritePolicy>& _parentBuffer) :
+				m_MetaInfo(_metaInfo), m_parentBuffer(_parentBuffer), m_offset(_metaInfo.blockOffset), m_arrayIndex(0) {}
+			SetableVariable(const VariableHandle& _handle, const BufferInfoView<VariableInfoType, WritePolicy>& _parentBuffer) :
+				m_MetaInfo(*_handle.metaInfo), m_parentBuffer(_parentBuffer), m_offset(_handle.offset), m_arrayIndex(_handle.arrayIndex) {}
 
 			void Set(float f);
 			void Set(const gl::Vec2& v);
 			void Set(const gl::Vec3& v);
 			void Set(const gl::Vec4& v);
+			/// Respects matrixStride and rowMajor. Expects column-major input.
 			void Set(const gl::Mat3& m);
+			/// Respects matrixStride and rowMajor. Expects column-major input.
 			void Set(const gl::Mat4& m);
 
+			/// Double precision setters store doubles if the shader variable has a double type, or convert to float if it has the corresponding float type.
 			void Set(double f);
-			//void Set(const gl::Vecd& v);
-			//void Set(const gl::Vec3d& v);
-			//void Set(const gl::Vec4d& v);
-			//void Set(const gl::Mat3d& m);
-			//void Set(const gl::Mat4d& m);
+			void Set(const gl::DVec2& v);
+			void Set(const gl::DVec3& v);
+			void Set(const gl::DVec4& v);
+			/// Respects matrixStride and rowMajor. Expects column-major input.
+			void Set(const gl::DMat3& m);
+			/// Respects matrixStride and rowMajor. Expects column-major input.
+			void Set(const gl::DMat4& m);
 
 			void Set(std::uint32_t ui);
 			void Set(const gl::UVec2& v);
@@ -224,30 +452,61 @@ namespace gl
 
 			// add more type implementations here if necessary
 
+			/// Sets a range of array elements from a tightly packed array.
+			///
+			/// Respects arrayStride, matrixStride and rowMajor, matrices are expected in column-major order.
+			/// Supported are all types that have a Set overload. Double precision data is converted in bulk if the shader variable has the corresponding float type.
+			/// \param _firstIndex
+			///		Array index of the first element, relative to the element this variable points to.
+			template<typename T>
+			void SetArray(const T* _data, std::int32_t _count, std::int32_t _firstIndex = 0);
+
 		private:
 			void Set(const void* _data, GLsizei _sizeInBytes);
+			void SetArray(const void* _data, ShaderVariableType _type, std::int32_t _count, std::int32_t _firstIndex);
+			/// Converts double precision data to the variable's float type and sets it.
+			void SetArrayDoubleToFloat(const double* _data, ShaderVariableType _type, std::int32_t _count, std::int32_t _firstIndex);
 
 			const VariableInfoType& m_MetaInfo;
-			const BufferInfoView<VariableInfoType>& m_parentBuffer;
+			const BufferInfoView<VariableInfoType, WritePolicy>& m_parentBuffer;
+			const std::int32_t m_offset;
+			const std::int32_t m_arrayIndex;
 		};
 
-		bool ContainsVariable(const std::string& _variableName) const   { return m_bufferInfo.variables.find(_variableName) != m_bufferInfo.variables.end(); }
-		SetableVariable operator[] (const std::string& _variableName)	{ return SetableVariable(m_bufferInfo.variables.find(_variableName)->second, *this); }
+		bool ContainsVariable(const std::string& _variableName) const   { return GetHandle(_variableName).IsValid(); }
 
+		/// Resolves a variable name.
+		///
+		/// Names of array elements like "lights[3].color" or "weights[2]" are resolved as well, if there is no reflected variable of this name
+		/// but one for the first array element ("weights[0]").
+		/// \return
+		///		Invalid handle if there is no such variable.
+		VariableHandle GetHandle(const std::string& _variableName) const;
+
+		SetableVariable operator[] (const std::string& _variableName)	{ return (*this)[GetHandle(_variableName)]; }
+		SetableVariable operator[] (const VariableHandle& _handle)
+		{
+			GLHELPER_ASSERT(_handle.IsValid(), "Invalid variable handle!");
+			return SetableVariable(_handle, *this);
+		}
+
+		WritePolicy& GetWritePolicy()				{ return m_writePolicy; }
+		const WritePolicy& GetWritePolicy() const	{ return m_writePolicy; }
 
 	private:
 		friend class SetableVariable;
 
 		const BufferInfo<VariableInfoType>& m_bufferInfo;
-		const SetVariableFunction m_setVariableFunction;
+		WritePolicy m_writePolicy;
 	};
 
 	/// A buffer info view, preconfigured for setting variables within a piece of mapped memory.
 	template<typename VariableInfoType>
-	class MappedMemoryView : public BufferInfoView<VariableInfoType>
+	class MappedMemoryView : public BufferInfoView<VariableInfoType, MappedMemoryWritePolicy>
 	{
 	public:
-		MappedMemoryView(const BufferInfo<VariableInfoType>& _bufferInfo, void* _mappedMemory, GLsizei _mapOffset = 0);
+		MappedMemoryView(const BufferInfo<VariableInfoType>& _bufferInfo, void* _mappedMemory, GLsizei _mapOffset = 0) :
+			BufferInfoView<VariableInfoType, MappedMemoryWritePolicy>(_bufferInfo, MappedMemoryWritePolicy(_mappedMemory, _mapOffset)) {}
 	};
 	
 	typedef MappedMemoryView<BufferVariableInfo> MappedBufferView;
@@ -1,110 +1,308 @@
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(float f)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(float f)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::FLOAT, "Variable type does not match!");
 	Set(&f, sizeof(f));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::Vec2& v)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::Vec2& v)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::FLOAT_VEC2, "Variable type does not match!");
 	Set(&v, sizeof(v));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::Vec3& v)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::Vec3& v)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::FLOAT_VEC3, "Variable type does not match!");
 	Set(&v, sizeof(v));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::Vec4& v)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::Vec4& v)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::FLOAT_VEC4, "Variable type does not match!");
 	Set(&v, sizeof(v));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::Mat3& m)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::Mat3& m)
 {
-	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::FLOAT_MAT3, "Variable type does not match!");
-	Set(&m, sizeof(m));
+	SetArray(&m, 1);
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::Mat4& m)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::Mat4& m)
 {
-	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::FLOAT_MAT4, "Variable type does not match!");
-	Set(&m, sizeof(m));
+	SetArray(&m, 1);
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(double f)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(double f)
 {
-	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::DOUBLE, "Variable type does not match!");
-	Set(&f, sizeof(f));
+	if (m_MetaInfo.type == ShaderVariableType::DOUBLE)
+		Set(&f, sizeof(f));
+	else
+		SetArray(&f, 1);
+}
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::DVec2& v)
+{
+	if (m_MetaInfo.type == ShaderVariableType::DOUBLE_VEC2)
+		Set(&v, sizeof(v));
+	else
+		SetArray(&v, 1);
+}
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::DVec3& v)
+{
+	if (m_MetaInfo.type == ShaderVariableType::DOUBLE_VEC3)
+		Set(&v, sizeof(v));
+	else
+		SetArray(&v, 1);
+}
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::DVec4& v)
+{
+	if (m_MetaInfo.type == ShaderVariableType::DOUBLE_VEC4)
+		Set(&v, sizeof(v));
+	else
+		SetArray(&v, 1);
+}
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::DMat3& m)
+{
+	SetArray(&m, 1);
+}
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::DMat4& m)
+{
+	SetArray(&m, 1);
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(std::uint32_t ui)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(std::uint32_t ui)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::UNSIGNED_INT, "Variable type does not match!");
 	Set(&ui, sizeof(ui));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::UVec2& v)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::UVec2& v)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::UNSIGNED_INT_VEC2, "Variable type does not match!");
 	Set(&v, sizeof(v));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::UVec3& v)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::UVec3& v)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::UNSIGNED_INT_VEC3, "Variable type does not match!");
 	Set(&v, sizeof(v));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::UVec4& v)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::UVec4& v)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::UNSIGNED_INT_VEC4, "Variable type does not match!");
 	Set(&v, sizeof(v));
 }
 
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(std::int32_t i)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(std::int32_t i)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::INT, "Variable type does not match!");
 	Set(&i, sizeof(i));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::IVec2 &v)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::IVec2 &v)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::INT_VEC2, "Variable type does not match!");
 	Set(&v, sizeof(v));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::IVec3& v)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::IVec3& v)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::INT_VEC3, "Variable type does not match!");
 	Set(&v, sizeof(v));
 }
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const gl::IVec4& v)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const gl::IVec4& v)
 {
 	GLHELPER_ASSERT(m_MetaInfo.type == ShaderVariableType::INT_VEC4, "Variable type does not match!");
 	Set(&v, sizeof(v));
 }
 
-template<typename VariableType>
-inline void BufferInfoView<VariableType>::SetableVariable::Set(const void* _data, GLsizei _sizeInBytes)
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::Set(const void* _data, GLsizei _sizeInBytes)
 {
 	GLHELPER_ASSERT(_sizeInBytes != 0, "Given size to set for buffer memory is 0.");
 	GLHELPER_ASSERT(_data != NULL, "Data to set for buffer variable is nullptr.");
-	GLHELPER_ASSERT(m_parentBuffer.m_bufferInfo.bufferDataSizeByte >= m_MetaInfo.blockOffset + _sizeInBytes, "Data to set for buffer variable is out of buffer's memory range");
+	std::int32_t offset = m_offset + m_arrayIndex * m_MetaInfo.arrayStride;
+	GLHELPER_ASSERT(m_parentBuffer.m_bufferInfo.bufferDataSizeByte >= offset + _sizeInBytes || m_parentBuffer.m_bufferInfo.bufferDataSizeByte == 0, "Data to set for buffer variable is out of buffer's memory range");
+
+	m_parentBuffer.m_writePolicy.Write(_data, _sizeInBytes, offset);
+}
+
+template<typename VariableType, typename WritePolicy>
+template<typename T>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::SetArray(const T* _data, std::int32_t _count, std::int32_t _firstIndex)
+{
+	const ShaderVariableType type = Details::ShaderVariableTypeOf<T>::value;
+	if (m_MetaInfo.type == type)
+		SetArray(_data, type, _count, _firstIndex);
+	else
+		SetArrayDoubleToFloat(reinterpret_cast<const double*>(_data), type, _count, _firstIndex);
+}
+
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::SetArrayDoubleToFloat(const double* _data, ShaderVariableType _type, std::int32_t _count, std::int32_t _firstIndex)
+{
+	// Only double to float of the same shape is allowed.
+	ShaderVariableTypeLayout sourceLayout, destinationLayout;
+	if (!GetShaderVariableTypeLayout(_type, sourceLayout) || !GetShaderVariableTypeLayout(m_MetaInfo.type, destinationLayout) ||
+		sourceLayout.componentType != ShaderVariableTypeLayout::ComponentType::DOUBLE || destinationLayout.componentType != ShaderVariableTypeLayout::ComponentType::FLOAT ||
+		sourceLayout.numRows != destinationLayout.numRows || sourceLayout.numColumns != destinationLayout.numColumns)
+	{
+		GLHELPER_ASSERT(false, "Variable type does not match!");
+		return;
+	}
+	if (_count <= 0)
+		return;
+
+	size_t numComponents = static_cast<size_t>(_count) * sourceLayout.numRows * sourceLayout.numColumns;
+	std::vector<float> converted(numComponents);
+	FloatConversionUtils::DoubleToFloat(converted.data(), _data, numComponents);
+	SetArray(converted.data(), m_MetaInfo.type, _count, _firstIndex);
+}
+
+template<typename VariableType, typename WritePolicy>
+inline void BufferInfoView<VariableType, WritePolicy>::SetableVariable::SetArray(const void* _data, ShaderVariableType _type, std::int32_t _count, std::int32_t _firstIndex)
+{
+	GLHELPER_ASSERT(_data != NULL, "Data to set for buffer variable is nullptr.");
+	if (_count <= 0)
+		return;
+
+	ShaderVariableTypeLayout layout;
+	if (!GetShaderVariableTypeLayout(_type, layout))
+	{
+		GLHELPER_ASSERT(false, "Type can not be set via SetArray!");
+		return;
+	}
+
+	std::int32_t firstIndex = m_arrayIndex + _firstIndex;
+	// Runtime sized arrays have an element count of 0.
+	GLHELPER_ASSERT(firstIndex >= 0 && (m_MetaInfo.arrayElementCount == 0 || firstIndex + _count <= std::max(m_MetaInfo.arrayElementCount, 1)), "Array range is out of bounds!");
+
+	const GLsizei elementSize = static_cast<GLsizei>(layout.GetPackedSize());
+	const GLsizei elementStride = m_MetaInfo.arrayStride > 0 ? m_MetaInfo.arrayStride : elementSize;
+	const std::int32_t offset = m_offset + firstIndex * elementStride;
+	GLHELPER_ASSERT(m_parentBuffer.m_bufferInfo.bufferDataSizeByte >= offset + (_count - 1) * elementStride + elementSize || m_parentBuffer.m_bufferInfo.bufferDataSizeByte == 0,
+					"Data to set for buffer variable is out of buffer's memory range");
+
+	// Scalars & vectors.
+	if (layout.numColumns == 1)
+	{
+		m_parentBuffer.m_writePolicy.WriteStrided(_data, elementSize, elementSize, _count, offset, elementStride);
+		return;
+	}
+
+	// Matrices are sets of column vectors, or row vectors for row-major matrices.
+	const std::uint8_t* source = static_cast<const std::uint8_t*>(_data);
+	GLsizei numVectors = layout.numColumns;
+	GLsizei vectorSize = layout.componentSize * layout.numRows;
+	std::vector<std::uint8_t> transposed;
+	if (m_MetaInfo.rowMajor)
+	{
+		numVectors = layout.numRows;
+		vectorSize = layout.componentSize * layout.numColumns;
+
+		transposed.resize(_count * elementSize);
+		for (std::int32_t matrix = 0; matrix < _count; ++matrix)
+		{
+			for (unsigned int column = 0; column < layout.numColumns; ++column)
+			{
+				for (unsigned int row = 0; row < layout.numRows; ++row)
+				{
+					memcpy(&transposed[matrix * elementSize + (row * layout.numColumns + column) * layout.componentSize],
+							source + matrix * elementSize + (column * layout.numRows + row) * layout.componentSize, layout.componentSize);
+				}
+			}
+		}
+		source = transposed.data();
+	}
+	const GLsizei vectorStride = m_MetaInfo.matrixStride > 0 ? m_MetaInfo.matrixStride : vectorSize;
+
+	// Usually the array stride is a multiple of the matrix stride, in which case all vectors of all matrices can be written at once.
+	if (elementStride == numVectors * vectorStride || _count == 1)
+		m_parentBuffer.m_writePolicy.WriteStrided(source, vectorSize, vectorSize, _count * numVectors, offset, vectorStride);
+	else
+	{
+		for (std::int32_t matrix = 0; matrix < _count; ++matrix)
+			m_parentBuffer.m_writePolicy.WriteStrided(source + matrix * elementSize, vectorSize, vectorSize, numVectors, offset + matrix * elementStride, vectorStride);
+	}
+}
+
+namespace Details
+{
+	/// Replaces the first or last array index "[N]" of a variable name by "[0]".
+	///
+	/// \return
+	///		False if there is no such array index.
+	inline bool ReplaceArrayIndexByZero(const std::string& _name, bool _last, std::string& _outName, std::int32_t& _outIndex)
+	{
+		size_t open = _last ? _name.rfind('[') : _name.find('[');
+		if (open == std::string::npos)
+			return false;
+		size_t close = _name.find(']', open);
+		if (close == std::string::npos || close == open + 1)
+			return false;
 
-	m_parentBuffer.m_setVariableFunction(_data, _sizeInBytes, m_MetaInfo.blockOffset);
+		_outIndex = 0;
+		for (size_t i = open + 1; i < close; ++i)
+		{
+			if (_name[i] < '0' || _name[i] > '9')
+				return false;
+			_outIndex = _outIndex * 10 + (_name[i] - '0');
+		}
+		_outName = _name.substr(0, open + 1) + "0" + _name.substr(close);
+		return true;
+	}
+
+	inline std::int32_t GetTopLevelArrayStride(const BufferVariableInfo& _info)	{ return _info.topLevelArrayStride; }
+	inline std::int32_t GetTopLevelArrayStride(const UniformVariableInfo&)		{ return 0; }
 }
 
-template<typename VariableType>
-inline MappedMemoryView<VariableType>::MappedMemoryView(const BufferInfo<VariableType>& _bufferInfo, void* _mappedMemory, GLsizei _mapOffset) :
-	BufferInfoView<VariableType>(_bufferInfo, [_mappedMemory, _mapOffset](const void* _data, GLsizei _sizeInBytes, std::int32_t _offset) {
-		GLHELPER_ASSERT(_offset >= _mapOffset, "Variable is outside of mapped memory area!");
-		// TODO: Overflow check!
-		memcpy(reinterpret_cast<char*>(_mappedMemory)+(_offset - _mapOffset), _data, _sizeInBytes);
-	})
-{}
+template<typename VariableType, typename WritePolicy>
+inline typename BufferInfoView<VariableType, WritePolicy>::VariableHandle BufferInfoView<VariableType, WritePolicy>::GetHandle(const std::string& _variableName) const
+{
+	VariableHandle handle;
+
+	auto variableIt = m_bufferInfo.variables.find(_variableName);
+	if (variableIt != m_bufferInfo.variables.end())
+	{
+		handle.metaInfo = &variableIt->second;
+		handle.offset = variableIt->second.blockOffset;
+		return handle;
+	}
+
+	// Element of an array, e.g. "weights[2]" or "lights[3].colors[1]".
+	std::string baseName;
+	std::int32_t index;
+	if (Details::ReplaceArrayIndexByZero(_variableName, true, baseName, index))
+	{
+		variableIt = m_bufferInfo.variables.find(baseName);
+		if (variableIt != m_bufferInfo.variables.end())
+		{
+			handle.metaInfo = &variableIt->second;
+			handle.offset = variableIt->second.blockOffset;
+			handle.arrayIndex = index;
+			return handle;
+		}
+	}
+
+	// Element of a top level array of a shader storage block, e.g. "particles[42].position". Only the first element is reflected.
+	if (Details::ReplaceArrayIndexByZero(_variableName, false, baseName, index))
+	{
+		variableIt = m_bufferInfo.variables.find(baseName);
+		if (variableIt != m_bufferInfo.variables.end() && Details::GetTopLevelArrayStride(variableIt->second) > 0)
+		{
+			handle.metaInfo = &variableIt->second;
+			handle.offset = variableIt->second.blockOffset + index * Details::GetTopLevelArrayStride(variableIt->second);
+			return handle;
+		}
+	}
+
+	return handle;
+}
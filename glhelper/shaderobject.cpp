@@ -1,30 +1,75 @@
 ﻿#include "shaderobject.hpp"
 #include "utils/pathutils.hpp"
+#include "shaderbuildprofiler.hpp"
+#include "shaderbundle.hpp"
+#include "shaderstagecache.hpp"
 
 #include "buffer.hpp"
+#include "context.hpp"
 
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <algorithm>
 
 namespace gl
 {
+	namespace
+	{
+		const GLenum s_shaderTypeToGLShaderType[static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES)] =
+		{
+			GL_VERTEX_SHADER,
+			GL_FRAGMENT_SHADER,
+			GL_TESS_EVALUATION_SHADER,
+			GL_TESS_CONTROL_SHADER,
+			GL_GEOMETRY_SHADER,
+			GL_COMPUTE_SHADER
+		};
+
+		const GLenum s_shaderTypeToSubroutineInterface[static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES)] =
+		{
+			GL_VERTEX_SUBROUTINE,
+			GL_FRAGMENT_SUBROUTINE,
+			GL_TESS_EVALUATION_SUBROUTINE,
+			GL_TESS_CONTROL_SUBROUTINE,
+			GL_GEOMETRY_SUBROUTINE,
+			GL_COMPUTE_SUBROUTINE
+		};
+
+		const GLenum s_shaderTypeToSubroutineUniformInterface[static_cast<unsigned int>(ShaderObject::ShaderType::NUM_SHADER_TYPES)] =
+		{
+			GL_VERTEX_SUBROUTINE_UNIFORM,
+			GL_FRAGMENT_SUBROUTINE_UNIFORM,
+			GL_TESS_EVALUATION_SUBROUTINE_UNIFORM,
+			GL_TESS_CONTROL_SUBROUTINE_UNIFORM,
+			GL_GEOMETRY_SUBROUTINE_UNIFORM,
+			GL_COMPUTE_SUBROUTINE_UNIFORM
+		};
+	}
+
 	/// Global event for changed shader files.
 	/// All Shader Objects will register upon this event. If any shader file is changed, just brodcast here!
 	//ezEvent<const std::string&> ShaderObject::s_shaderFileChangedEvent;
 
-	const ShaderObject* ShaderObject::s_currentlyActiveShaderObject = NULL;
-
 	ShaderObject::ShaderObject(const std::string& _name) :
 		m_name(_name),
 		m_program(0),
-		m_containsAssembledProgram(false)
+		m_containsAssembledProgram(false),
+		m_separable(false),
+		m_programGeneration(0),
+		m_programInformationsQueried(false),
+		m_hasSubroutineUniforms(false),
+		m_totalProgramInputCount(0),
+		m_totalProgramOutputCount(0)
 	{
+		m_computeWorkGroupSize[0] = m_computeWorkGroupSize[1] = m_computeWorkGroupSize[2] = 0;
 		for (Shader& shader : m_shader)
 		{
 			shader.shaderObject = 0;
 			shader.origin = "";
 			shader.loaded = false;
+			shader.spirV = false;
+			shader.stageCache = nullptr;
 		}
 	}
 
@@ -32,11 +77,16 @@ namespace gl
 		m_name(std::move(_moved.m_name)),
 		m_program(_moved.m_program),
 		m_containsAssembledProgram(_moved.m_containsAssembledProgram),
+		m_separable(_moved.m_separable),
+		m_programGeneration(_moved.m_programGeneration),
 		m_filesPerShaderType(std::move(_moved.m_filesPerShaderType)),
 
+		m_programInformationsQueried(_moved.m_programInformationsQueried),
 		m_globalUniformInfo(std::move(_moved.m_globalUniformInfo)),
 		m_uniformBlockInfos(std::move(_moved.m_uniformBlockInfos)),
 		m_shaderStorageInfos(std::move(_moved.m_shaderStorageInfos)),
+		m_atomicCounterBufferInfos(std::move(_moved.m_atomicCounterBufferInfos)),
+		m_hasSubroutineUniforms(_moved.m_hasSubroutineUniforms),
 
 		m_totalProgramInputCount(_moved.m_totalProgramInputCount),
 		m_totalProgramOutputCount(_moved.m_totalProgramOutputCount)
@@ -45,7 +95,12 @@ namespace gl
 		{
 			m_shader[i] = std::move(_moved.m_shader[i]);
 			_moved.m_shader[i].shaderObject = 0;
+			m_subroutineInfos[i] = std::move(_moved.m_subroutineInfos[i]);
+			m_subroutineSelections[i] = std::move(_moved.m_subroutineSelections[i]);
+			m_subroutineNameSelections[i] = std::move(_moved.m_subroutineNameSelections[i]);
 		}
+		for (unsigned int i = 0; i < 3; ++i)
+			m_computeWorkGroupSize[i] = _moved.m_computeWorkGroupSize[i];
 		_moved.m_program = 0;
 	}
 
@@ -53,27 +108,31 @@ namespace gl
 	{
 		if(m_program)
 		{
-			if(s_currentlyActiveShaderObject == this)
+			const ShaderObject*& activeShaderObject = Context::GetCurrent().activeShaderObject;
+			if(activeShaderObject == this)
 			{
 				// Program must be detached to be able to delete it!
 				// http://docs.gl/gl4/glDeleteShader
 				GL_CALL(glUseProgram, 0);
-				s_currentlyActiveShaderObject = NULL;
-			}
-
-			for(Shader& shader : m_shader)
-			{
-				if(shader.loaded)
-					GL_CALL(glDeleteShader, shader.shaderObject);
+				activeShaderObject = NULL;
 			}
 
 			if(m_containsAssembledProgram)
 				GL_CALL(glDeleteProgram, m_program);
 		}
+
+		// Shaders may be shared with other programs.
+		for (unsigned int i = 0; i < static_cast<unsigned int>(ShaderType::NUM_SHADER_TYPES); ++i)
+		{
+			if (m_shader[i].loaded && m_shader[i].shaderObject != 0)
+				ReleaseShader(static_cast<ShaderType>(i));
+		}
 	}
 
 	Result ShaderObject::AddShaderFromFile(ShaderType _type, const std::string& _filename, const std::string& _prefixCode)
 	{
+		GLHELPER_PROFILE_SHADER_BUILD(ADD_SHADER_FROM_FILE, &m_name);
+
 		// load new code
 		std::unordered_set<std::string> includingFiles, allFiles;
 		std::string sourceCode = ReadShaderFromFile(_filename, _prefixCode, 0, includingFiles, allFiles);
@@ -97,25 +156,31 @@ namespace gl
 	std::string ShaderObject::ReadShaderFromFile(const std::string& _shaderFilename, const std::string& _prefixCode,
 												 unsigned int _fileIndex, std::unordered_set<std::string>& _beforeIncludedFiles, std::unordered_set<std::string>& _allReadFiles)
 	{
-		// open file
-		std::ifstream file(_shaderFilename.c_str());
-		if (file.bad() || file.fail())
+		GLHELPER_PROFILE_SHADER_BUILD(READ_SHADER_FROM_FILE, nullptr);
+
+		std::string sourceCode;
 		{
-			GLHELPER_LOG_ERROR("Unable to open shader file " + _shaderFilename);
-			return "";
-		}
+			GLHELPER_PROFILE_SHADER_BUILD(FILE_IO, nullptr);
 
-		_allReadFiles.insert(_shaderFilename);
+			// open file
+			std::ifstream file(_shaderFilename.c_str());
+			if (file.bad() || file.fail())
+			{
+				GLHELPER_LOG_ERROR("Unable to open shader file " + _shaderFilename);
+				return "";
+			}
 
-		// Reserve
-		std::string sourceCode;
-		file.seekg(0, std::ios::end);
-		sourceCode.reserve(static_cast<size_t>(file.tellg()));
-		file.seekg(0, std::ios::beg);
+			_allReadFiles.insert(_shaderFilename);
 
-		// Read
-		sourceCode.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-		file.close();
+			// Reserve
+			file.seekg(0, std::ios::end);
+			sourceCode.reserve(static_cast<size_t>(file.tellg()));
+			file.seekg(0, std::ios::beg);
+
+			// Read
+			sourceCode.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			file.close();
+		}
 
 		std::string insertionBuffer;
 		size_t parseCursorPos = 0;
@@ -140,19 +205,9 @@ namespace gl
 		{
 			if (versionPos != std::string::npos)
 			{
-				// Insert after version and surround by #line macro for proper error output.
-				size_t nextLineIdx = sourceCode.find_first_of("\n", versionPos);
-				size_t numLinesBeforeVersion = std::count(sourceCode.begin(), sourceCode.begin() + versionPos, '\n');
-
-				insertionBuffer = "\n#line 1 " + std::to_string(++lastFileIndex) + "\n";
-				insertionBuffer += _prefixCode;
-				insertionBuffer += "\n#line " + std::to_string(numLinesBeforeVersion + 1) + " " + std::to_string(_fileIndex) + "\n";
-
-				sourceCode.insert(nextLineIdx, insertionBuffer);
-
 				// parse cursor moves on
-				parseCursorPos = nextLineIdx + insertionBuffer.size(); // This is the main reason why currently no #include files in prefix code is supported. Changing these has a lot of side effects in line numbering!
-				parseCursorOriginalFileNumber = numLinesBeforeVersion + 1; // jumped over #version!
+				parseCursorPos = InsertPrefixCode(sourceCode, versionPos, _prefixCode, ++lastFileIndex, _fileIndex); // This is the main reason why currently no #include files in prefix code is supported. Changing these has a lot of side effects in line numbering!
+				parseCursorOriginalFileNumber = std::count(sourceCode.begin(), sourceCode.begin() + versionPos, '\n') + 1; // jumped over #version!
 			}
 		}
 
@@ -216,108 +271,254 @@ namespace gl
 		return sourceCode;
 	}
 
+	size_t ShaderObject::InsertPrefixCode(std::string& _sourceCode, size_t _versionPos, const std::string& _prefixCode, unsigned int _prefixFileIndex, unsigned int _sourceFileIndex)
+	{
+		// Insert after version and surround by #line macro for proper error output.
+		size_t nextLineIdx = _sourceCode.find_first_of("\n", _versionPos);
+		if (nextLineIdx == std::string::npos)
+		{
+			_sourceCode += "\n";
+			nextLineIdx = _sourceCode.size() - 1;
+		}
+		size_t numLinesBeforeVersion = std::count(_sourceCode.begin(), _sourceCode.begin() + _versionPos, '\n');
+
+		std::string insertionBuffer = "\n#line 1 " + std::to_string(_prefixFileIndex) + "\n";
+		insertionBuffer += _prefixCode;
+		insertionBuffer += "\n#line " + std::to_string(numLinesBeforeVersion + 1) + " " + std::to_string(_sourceFileIndex) + "\n";
+
+		_sourceCode.insert(nextLineIdx, insertionBuffer);
+
+		return nextLineIdx + insertionBuffer.size();
+	}
+
 	Result ShaderObject::AddShaderFromSource(ShaderType _type, const std::string& _sourceCode, const std::string& _originName)
 	{
 		return AddShader(_type, _sourceCode, _originName, "");
 	}
 
+	Result ShaderObject::AddShaderFromBundle(ShaderType _type, const ShaderBundle& _bundle, const std::string& _entryName, const std::string& _prefixCode)
+	{
+		const ShaderBundle::Entry* entry = _bundle.FindEntry(_entryName);
+		if (entry == nullptr)
+		{
+			GLHELPER_LOG_ERROR("Shader bundle " + _bundle.GetFilename() + " does not contain an entry \"" + _entryName + "\"");
+			return Result::FAILURE;
+		}
+
+		std::string sourceCode(_bundle.GetEntrySource(*entry), static_cast<size_t>(entry->dataSize));
+		if (!_prefixCode.empty())
+		{
+			size_t versionPos = sourceCode.find("#version");
+			if (versionPos != std::string::npos)
+				InsertPrefixCode(sourceCode, versionPos, _prefixCode, s_prefixCodeFileIndex, 0);
+		}
+
+		return AddShader(_type, sourceCode, _entryName, _prefixCode);
+	}
+
 	Result ShaderObject::AddShader(ShaderType _type, const std::string& _sourceCode, const std::string& _originName, const std::string& _prefixCode)
 	{
+		GLHELPER_PROFILE_SHADER_BUILD(ADD_SHADER, &m_name);
+
 		GLHELPER_ASSERT(_sourceCode != "", "Shader source code is empty!");
 		GLHELPER_ASSERT(_originName != "", "No shader origin given!");
 
-		Shader& shader = m_shader[static_cast<std::uint32_t>(_type)];
+		Result result;
+
+		// Identical stage already compiled by any ShaderObject?
+		ShaderId shaderObjectTemp = ShaderStageCache::GetCurrent().Acquire(_type, _sourceCode);
+		if (shaderObjectTemp != 0)
+		{
+			ReplaceShader(_type, shaderObjectTemp, _originName);
+			result = Result::SUCCEEDED;
+		}
+		else
+		{
+			shaderObjectTemp = CreateShader(_type);
+
+			// compile shader
+			const char* sourceRaw = _sourceCode.c_str();
+			GL_CALL(glShaderSource, shaderObjectTemp, 1, &sourceRaw, nullptr);	// attach shader code
+
+			result = gl::CheckGLError("glShaderSource");
+			if (result == Result::SUCCEEDED)
+			{
+				glCompileShader(shaderObjectTemp);								    // compile
+
+				result = gl::CheckGLError("glCompileShader");
+			}
+
+			result = FinalizeShader(_type, shaderObjectTemp, result, _originName);
+			if (result == Result::SUCCEEDED)
+				ShaderStageCache::GetCurrent().Insert(_type, _sourceCode, shaderObjectTemp);
+		}
 
-		// create shader
-		GLuint shaderObjectTemp = 0;
-		switch (_type)
-		{
-		case ShaderObject::ShaderType::VERTEX:
-			shaderObjectTemp = GL_RET_CALL(glCreateShader, GL_VERTEX_SHADER);
-			break;
-		case ShaderObject::ShaderType::FRAGMENT:
-			shaderObjectTemp = GL_RET_CALL(glCreateShader, GL_FRAGMENT_SHADER);
-			break;
-		case ShaderObject::ShaderType::EVALUATION:
-			shaderObjectTemp = GL_RET_CALL(glCreateShader, GL_TESS_EVALUATION_SHADER);
-			break;
-		case ShaderObject::ShaderType::CONTROL:
-			shaderObjectTemp = GL_RET_CALL(glCreateShader, GL_TESS_CONTROL_SHADER);
-			break;
-		case ShaderObject::ShaderType::GEOMETRY:
-			shaderObjectTemp = GL_RET_CALL(glCreateShader, GL_GEOMETRY_SHADER);
-			break;
-		case ShaderObject::ShaderType::COMPUTE:
-			shaderObjectTemp = GL_RET_CALL(glCreateShader, GL_COMPUTE_SHADER);
-			break;
-
-		default:
-			GLHELPER_ASSERT(false, "Unknown shader type");
-			break;
-		}
-
-		// compile shader
-		const char* sourceRaw = _sourceCode.c_str();
-		GL_CALL(glShaderSource, shaderObjectTemp, 1, &sourceRaw, nullptr);	// attach shader code
-
-		Result result = gl::CheckGLError("glShaderSource");
 		if (result == Result::SUCCEEDED)
 		{
-			glCompileShader(shaderObjectTemp);								    // compile
+			Shader& shader = m_shader[static_cast<std::uint32_t>(_type)];
+			shader.prefixCode = _prefixCode;
+			shader.spirV = false;
+			shader.entryPoint.clear();
+			shader.specializationConstants.clear();
+		}
 
-			result = gl::CheckGLError("glCompileShader");
+		return result;
+	}
+
+	Result ShaderObject::AddShaderFromSpirV(ShaderType _type, const void* _binary, size_t _binarySizeInBytes, const std::string& _originName,
+											const std::string& _entryPoint, const std::vector<SpecializationConstant>& _specializationConstants)
+	{
+		GLHELPER_PROFILE_SHADER_BUILD(ADD_SHADER, &m_name);
+
+		GLHELPER_ASSERT(_binary != nullptr && _binarySizeInBytes > 0, "SPIR-V binary is empty!");
+		GLHELPER_ASSERT(_binarySizeInBytes % 4 == 0, "SPIR-V binary size needs to be a multiple of 4!");
+		GLHELPER_ASSERT(_originName != "", "No shader origin given!");
+
+		if (!CheckGLFunctionExistsAndReport("glSpecializeShader", reinterpret_cast<const void*>(glSpecializeShader)))
+			return Result::FAILURE;
+
+		ShaderId shaderObjectTemp = CreateShader(_type);
+
+		// upload binary
+		glShaderBinary(1, &shaderObjectTemp, GL_SHADER_BINARY_FORMAT_SPIR_V, _binary, static_cast<GLsizei>(_binarySizeInBytes));
+		Result result = gl::CheckGLError("glShaderBinary");
+
+		// specialize - this replaces the compile step
+		if (result == Result::SUCCEEDED)
+		{
+			std::vector<GLuint> constantIndices(_specializationConstants.size());
+			std::vector<GLuint> constantValues(_specializationConstants.size());
+			for (size_t i = 0; i < _specializationConstants.size(); ++i)
+			{
+				constantIndices[i] = _specializationConstants[i].constantID;
+				constantValues[i] = _specializationConstants[i].value;
+			}
+			glSpecializeShader(shaderObjectTemp, _entryPoint.c_str(), static_cast<GLuint>(_specializationConstants.size()),
+								constantIndices.empty() ? nullptr : constantIndices.data(), constantValues.empty() ? nullptr : constantValues.data());
+
+			result = gl::CheckGLError("glSpecializeShader");
 		}
 
-		// gl get error seems to be unreliable - another check!
+		result = FinalizeShader(_type, shaderObjectTemp, result, _originName);
 		if (result == Result::SUCCEEDED)
+		{
+			Shader& shader = m_shader[static_cast<std::uint32_t>(_type)];
+			shader.prefixCode.clear();
+			shader.spirV = true;
+			shader.entryPoint = _entryPoint;
+			shader.specializationConstants = _specializationConstants;
+		}
+
+		return result;
+	}
+
+	Result ShaderObject::AddShaderFromSpirVFile(ShaderType _type, const std::string& _filename,
+												const std::string& _entryPoint, const std::vector<SpecializationConstant>& _specializationConstants)
+	{
+		std::vector<char> binary;
+		{
+			GLHELPER_PROFILE_SHADER_BUILD(FILE_IO, &m_name);
+
+			std::ifstream file(_filename.c_str(), std::ios::binary);
+			if (file.bad() || file.fail())
+			{
+				GLHELPER_LOG_ERROR("Unable to open SPIR-V file " + _filename);
+				return Result::FAILURE;
+			}
+
+			file.seekg(0, std::ios::end);
+			binary.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0, std::ios::beg);
+			file.read(binary.data(), binary.size());
+			if (binary.empty() || file.fail())
+			{
+				GLHELPER_LOG_ERROR("Failed to read SPIR-V file " + _filename);
+				return Result::FAILURE;
+			}
+		}
+
+		Result result = AddShaderFromSpirV(_type, binary.data(), binary.size(), _filename, _entryPoint, _specializationConstants);
+		if (result != Result::FAILURE)
+			m_filesPerShaderType.emplace(_filename, _type);
+
+		return result;
+	}
+
+	ShaderId ShaderObject::CreateShader(ShaderType _type)
+	{
+		GLHELPER_ASSERT(static_cast<unsigned int>(_type) < static_cast<unsigned int>(ShaderType::NUM_SHADER_TYPES), "Unknown shader type");
+
+		return GL_RET_CALL(glCreateShader, s_shaderTypeToGLShaderType[static_cast<unsigned int>(_type)]);
+	}
+
+	Result ShaderObject::FinalizeShader(ShaderType _type, ShaderId _newShader, Result _result, const std::string& _originName)
+	{
+		// gl get error seems to be unreliable - another check!
+		if (_result == Result::SUCCEEDED)
 		{
 			GLint shaderCompiled;
-			GL_CALL(glGetShaderiv, shaderObjectTemp, GL_COMPILE_STATUS, &shaderCompiled);
+			GL_CALL(glGetShaderiv, _newShader, GL_COMPILE_STATUS, &shaderCompiled);
 
 			if (shaderCompiled == GL_FALSE)
-				result = Result::FAILURE;
+				_result = Result::FAILURE;
 		}
 
 		// log output
-		PrintShaderInfoLog(shaderObjectTemp, _originName);
+		PrintShaderInfoLog(_newShader, _originName);
 
 		// check result
-		if (result == Result::SUCCEEDED)
+		if (_result == Result::SUCCEEDED)
+			ReplaceShader(_type, _newShader, _originName);
+		else
+			GL_CALL(glDeleteShader, _newShader);
+
+		return _result;
+	}
+
+	void ShaderObject::ReplaceShader(ShaderType _type, ShaderId _newShader, const std::string& _originName)
+	{
+		Shader& shader = m_shader[static_cast<std::uint32_t>(_type)];
+
+		// release old shader
+		if (shader.loaded)
 		{
-			// destroy old shader
-			if (shader.loaded)
-			{
-				glDeleteShader(shader.shaderObject);
-				shader.origin = "";
-			}
+			ReleaseShader(_type);
+			shader.origin = "";
+		}
 
-			// memorize new data only if loading successful - this way a failed reload won't affect anything
-			shader.shaderObject = shaderObjectTemp;
-			shader.origin = _originName;
-			shader.prefixCode = _prefixCode;
+		// memorize new data only if loading successful - this way a failed reload won't affect anything
+		shader.shaderObject = _newShader;
+		shader.origin = _originName;
+		shader.stageCache = &ShaderStageCache::GetCurrent();
 
-			// remove old associated files
-			for (auto it = m_filesPerShaderType.begin(); it != m_filesPerShaderType.end(); ++it)
+		// remove old associated files
+		for (auto it = m_filesPerShaderType.begin(); it != m_filesPerShaderType.end(); ++it)
+		{
+			if (it->second == _type)
 			{
-				if (it->second == _type)
-				{
-					it = m_filesPerShaderType.erase(it);
-					if (it == m_filesPerShaderType.end())
-						break;
-				}
+				it = m_filesPerShaderType.erase(it);
+				if (it == m_filesPerShaderType.end())
+					break;
 			}
-
-			shader.loaded = true;
 		}
-		else
-			GL_CALL(glDeleteShader, shaderObjectTemp);
 
-		return result;
+		shader.loaded = true;
 	}
 
+	void ShaderObject::ReleaseShader(ShaderType _type)
+	{
+		Shader& shader = m_shader[static_cast<std::uint32_t>(_type)];
+
+		// Releasing into the cache of another context would delete the shader (or a different one with the same name) in the wrong context.
+		GLHELPER_ASSERT(shader.stageCache == &ShaderStageCache::GetCurrent(), "Shader stage of " + m_name + " is released while a different gl::Context is current than the one it was loaded in!");
+		shader.stageCache->Release(shader.shaderObject);
+		shader.stageCache = nullptr;
+	}
 
 	Result ShaderObject::CreateProgram()
 	{
+		GLHELPER_PROFILE_SHADER_BUILD(CREATE_PROGRAM, &m_name);
+
 		// Create shader program
 		GLuint tempProgram = GL_RET_CALL(glCreateProgram);
 
@@ -333,6 +534,9 @@ namespace gl
 		}
 		GLHELPER_ASSERT(numAttachedShader > 0, "Need at least one shader to link a gl program!");
 
+		if (m_separable)
+			GL_CALL(glProgramParameteri, tempProgram, GL_PROGRAM_SEPARABLE, GL_TRUE);
+
 		// Link program
 		glLinkProgram(tempProgram);
 		Result result = gl::CheckGLError("glLinkProgram");
@@ -356,27 +560,39 @@ namespace gl
 			// already a program there? destroy old one!
 			if (m_containsAssembledProgram)
 			{
-				if(s_currentlyActiveShaderObject == this)
+				const ShaderObject*& activeShaderObject = Context::GetCurrent().activeShaderObject;
+				if(activeShaderObject == this)
 				{
 					GL_CALL(glUseProgram, 0);
-					s_currentlyActiveShaderObject = nullptr;
+					activeShaderObject = nullptr;
 				}
 				GL_CALL(glDeleteProgram, m_program);
-
-				// clear meta information
-				m_totalProgramInputCount = 0;
-				m_totalProgramOutputCount = 0;
-				m_globalUniformInfo.clear();
-				m_uniformBlockInfos.clear();
-				m_shaderStorageInfos.clear();
 			}
 
 			// memorize new data only if loading successful - this way a failed reload won't affect anything
 			m_program = tempProgram;
 			m_containsAssembledProgram = true;
+			++m_programGeneration;
 
-			// get informations about the program
-			QueryProgramInformations();
+			// informations about the program are queried on first access
+			m_programInformationsQueried = false;
+
+			// ... except for the work group size which is needed for every dispatch
+			if (m_shader[static_cast<unsigned int>(ShaderType::COMPUTE)].loaded)
+				GL_CALL(glGetProgramiv, m_program, GL_COMPUTE_WORK_GROUP_SIZE, m_computeWorkGroupSize);
+			else
+				m_computeWorkGroupSize[0] = m_computeWorkGroupSize[1] = m_computeWorkGroupSize[2] = 0;
+
+			// ... and whether there are any subroutine uniforms whose selection needs to be sent on Activate.
+			m_hasSubroutineUniforms = false;
+			for (unsigned int stage = 0; stage < static_cast<unsigned int>(ShaderType::NUM_SHADER_TYPES) && !m_hasSubroutineUniforms; ++stage)
+			{
+				if (!m_shader[stage].loaded)
+					continue;
+				GLint numUniformLocations = 0;
+				GL_CALL(glGetProgramStageiv, m_program, s_shaderTypeToGLShaderType[stage], GL_ACTIVE_SUBROUTINE_UNIFORM_LOCATIONS, &numUniformLocations);
+				m_hasSubroutineUniforms = numUniformLocations > 0;
+			}
 
 			return Result::SUCCEEDED;
 		}
@@ -387,130 +603,301 @@ namespace gl
 		return result;
 	}
 
-	void ShaderObject::QueryProgramInformations()
+	void ShaderObject::QueryProgramInformations() const
 	{
+		GLHELPER_PROFILE_SHADER_BUILD(QUERY_PROGRAM_INFORMATIONS, &m_name);
+
+		m_globalUniformInfo.clear();
+		m_uniformBlockInfos.clear();
+		m_shaderStorageInfos.clear();
+		m_atomicCounterBufferInfos.clear();
+		m_totalProgramInputCount = 0;
+		m_totalProgramOutputCount = 0;
+		m_programInformationsQueried = true;
+		if (!m_containsAssembledProgram)
+			return;
+
+		// All names are read into a single scratch buffer that is reused for every interface.
+		std::vector<char> nameBuffer;
+
 		// query basic uniform & shader storage block infos
-		QueryBlockInformations(m_uniformBlockInfos, GL_UNIFORM_BLOCK);
-		QueryBlockInformations(m_shaderStorageInfos, GL_SHADER_STORAGE_BLOCK);
+		std::vector<UniformBufferMetaInfo*> uniformBlocks;
+		std::vector<ShaderStorageBufferMetaInfo*> storageBlocks;
+		QueryBlockInformations(m_uniformBlockInfos, GL_UNIFORM_BLOCK, uniformBlocks, nameBuffer);
+		QueryBlockInformations(m_shaderStorageInfos, GL_SHADER_STORAGE_BLOCK, storageBlocks, nameBuffer);
+
+		// atomic counter buffers have no names, they are identified by their index
+		GLint totalNumAtomicCounterBuffers = 0;
+		GL_CALL(glGetProgramInterfaceiv, m_program, GL_ATOMIC_COUNTER_BUFFER, GL_ACTIVE_RESOURCES, &totalNumAtomicCounterBuffers);
+		m_atomicCounterBufferInfos.resize(std::max(totalNumAtomicCounterBuffers, 0));
+		for (GLint bufferIndex = 0; bufferIndex < totalNumAtomicCounterBuffers; ++bufferIndex)
+		{
+			const GLenum queriedAtomicCounterBufferProps[] = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE };
+			GLint rawData[2];
+			GL_CALL(glGetProgramResourceiv, m_program, GL_ATOMIC_COUNTER_BUFFER, bufferIndex, 2, queriedAtomicCounterBufferProps, 2, nullptr, rawData);
+			m_atomicCounterBufferInfos[bufferIndex].internalBufferIndex = bufferIndex;
+			m_atomicCounterBufferInfos[bufferIndex].bufferBinding = rawData[0];
+			m_atomicCounterBufferInfos[bufferIndex].bufferDataSizeByte = rawData[1];
+		}
 
 		// informations about uniforms ...
 		GLint totalNumUniforms = 0;
 		GL_CALL(glGetProgramInterfaceiv, m_program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &totalNumUniforms);
-		const GLuint iNumQueriedUniformProps = 10;
-		const GLenum pQueriedUniformProps[] = { GL_NAME_LENGTH, GL_TYPE, GL_ARRAY_SIZE, GL_OFFSET, GL_BLOCK_INDEX, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE, GL_IS_ROW_MAJOR, GL_ATOMIC_COUNTER_BUFFER_INDEX, GL_LOCATION };
-		GLint _rawUniformBlockInfoData[iNumQueriedUniformProps] = {};
-		for (int blockIndex = 0; blockIndex < totalNumUniforms; ++blockIndex)
-		{
-			// general data
-			GLsizei length = 0;
-			GL_CALL(glGetProgramResourceiv, m_program, GL_UNIFORM, blockIndex, iNumQueriedUniformProps, pQueriedUniformProps, iNumQueriedUniformProps, &length, _rawUniformBlockInfoData);
-			UniformVariableInfo uniformInfo;
-			uniformInfo.type = static_cast<gl::ShaderVariableType>(_rawUniformBlockInfoData[1]);
-			uniformInfo.arrayElementCount = static_cast<std::int32_t>(_rawUniformBlockInfoData[2]);
-			uniformInfo.blockOffset = static_cast<std::int32_t>(_rawUniformBlockInfoData[3]);
-			uniformInfo.arrayStride = static_cast<std::int32_t>(_rawUniformBlockInfoData[5]) * 4;
-			uniformInfo.matrixStride = static_cast<std::int32_t>(_rawUniformBlockInfoData[6]);
-			uniformInfo.rowMajor = _rawUniformBlockInfoData[7] > 0;
-			uniformInfo.atomicCounterbufferIndex = _rawUniformBlockInfoData[8];
-			uniformInfo.location = _rawUniformBlockInfoData[9];
-
-			// name
-			GLint actualNameLength = 0;
-			std::string name;
-			name.resize(_rawUniformBlockInfoData[0] + 1);
-			GL_CALL(glGetProgramResourceName, m_program, GL_UNIFORM, static_cast<GLuint>(blockIndex), static_cast<GLsizei>(name.size()), &actualNameLength, &name[0]);
-			name.resize(actualNameLength);
-
-			// where to store (to which ubo block does this variable belong)
-			if (_rawUniformBlockInfoData[4] < 0)
-				m_globalUniformInfo.emplace(name, uniformInfo);
-			else
+		if (totalNumUniforms > 0)
+		{
+			const GLuint numQueriedUniformProps = 9;
+			const GLenum queriedUniformProps[] = { GL_TYPE, GL_ARRAY_SIZE, GL_OFFSET, GL_BLOCK_INDEX, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE, GL_IS_ROW_MAJOR, GL_ATOMIC_COUNTER_BUFFER_INDEX, GL_LOCATION };
+			std::vector<GLint> rawUniformData(totalNumUniforms * numQueriedUniformProps);
+			for (GLint uniformIndex = 0; uniformIndex < totalNumUniforms; ++uniformIndex)
+				GL_CALL(glGetProgramResourceiv, m_program, GL_UNIFORM, uniformIndex, numQueriedUniformProps, queriedUniformProps, numQueriedUniformProps, nullptr, &rawUniformData[uniformIndex * numQueriedUniformProps]);
+			std::vector<std::string> names = QueryResourceNames(GL_UNIFORM, totalNumUniforms, nameBuffer);
+
+			m_globalUniformInfo.reserve(totalNumUniforms);
+			for (GLint uniformIndex = 0; uniformIndex < totalNumUniforms; ++uniformIndex)
 			{
-				for (auto it = m_uniformBlockInfos.begin(); it != m_uniformBlockInfos.end(); ++it)
-				{
-					if (it->second.internalBufferIndex == _rawUniformBlockInfoData[4])
-					{
-						it->second.variables.emplace(name, uniformInfo);
-						break;
-					}
-				}
+				const GLint* rawData = &rawUniformData[uniformIndex * numQueriedUniformProps];
+				UniformVariableInfo uniformInfo;
+				uniformInfo.type = static_cast<gl::ShaderVariableType>(rawData[0]);
+				uniformInfo.arrayElementCount = static_cast<std::int32_t>(rawData[1]);
+				uniformInfo.blockOffset = static_cast<std::int32_t>(rawData[2]);
+				uniformInfo.arrayStride = static_cast<std::int32_t>(rawData[4]);
+				uniformInfo.matrixStride = static_cast<std::int32_t>(rawData[5]);
+				uniformInfo.rowMajor = rawData[6] > 0;
+				uniformInfo.atomicCounterbufferIndex = rawData[7];
+				uniformInfo.location = rawData[8];
+
+				// where to store (to which ubo block does this variable belong)
+				GLint blockIndex = rawData[3];
+				std::string& name = names[uniformIndex];
+				if (name.empty())
+					name = blockIndex < 0 ? "__location" + std::to_string(uniformInfo.location) : "__offset" + std::to_string(uniformInfo.blockOffset);
+
+				if (uniformInfo.atomicCounterbufferIndex >= 0 && uniformInfo.atomicCounterbufferIndex < static_cast<GLint>(m_atomicCounterBufferInfos.size()))
+					m_atomicCounterBufferInfos[uniformInfo.atomicCounterbufferIndex].variables.emplace(name, uniformInfo);
+				if (blockIndex < 0)
+					m_globalUniformInfo.emplace(std::move(name), uniformInfo);
+				else if (blockIndex < static_cast<GLint>(uniformBlocks.size()))
+					uniformBlocks[blockIndex]->variables.emplace(std::move(name), uniformInfo);
 			}
 		}
 
 		// informations about shader storage variables 
 		GLint totalNumStorages = 0;
 		GL_CALL(glGetProgramInterfaceiv, m_program, GL_BUFFER_VARIABLE, GL_ACTIVE_RESOURCES, &totalNumStorages);
-		const GLuint numQueriedStorageProps = 10;
-		const GLenum queriedStorageProps[] = { GL_NAME_LENGTH, GL_TYPE, GL_ARRAY_SIZE, GL_OFFSET, GL_BLOCK_INDEX, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE, GL_IS_ROW_MAJOR, GL_TOP_LEVEL_ARRAY_SIZE, GL_TOP_LEVEL_ARRAY_STRIDE };
-		GLint rawStorageBlockInfoData[numQueriedStorageProps];
-		for (GLint blockIndex = 0; blockIndex < totalNumStorages; ++blockIndex)
-		{
-			// general data
-			GL_CALL(glGetProgramResourceiv, m_program, GL_BUFFER_VARIABLE, blockIndex, numQueriedStorageProps, queriedStorageProps, numQueriedStorageProps, nullptr, rawStorageBlockInfoData);
-			BufferVariableInfo storageInfo;
-			storageInfo.type = static_cast<gl::ShaderVariableType>(rawStorageBlockInfoData[1]);
-			storageInfo.arrayElementCount = static_cast<std::int32_t>(rawStorageBlockInfoData[2]);
-			storageInfo.blockOffset = static_cast<std::int32_t>(rawStorageBlockInfoData[3]);
-			storageInfo.arrayStride = static_cast<std::int32_t>(rawStorageBlockInfoData[5]);
-			storageInfo.matrixStride = static_cast<std::int32_t>(rawStorageBlockInfoData[6]);
-			storageInfo.rowMajor = rawStorageBlockInfoData[7] > 0;
-			storageInfo.topLevelArraySize = rawStorageBlockInfoData[8];
-			storageInfo.topLevelArrayStride = rawStorageBlockInfoData[9];
-
-			// name
-			GLint iActualNameLength = 0;
-			std::string name;
-			name.resize(rawStorageBlockInfoData[0] + 1);
-			GL_CALL(glGetProgramResourceName, m_program, GL_BUFFER_VARIABLE, blockIndex, static_cast<GLsizei>(name.size()), &iActualNameLength, &name[0]);
-			name.resize(iActualNameLength);
-
-			// where to store (to which shader storage block does this variable belong)
-			for (auto it = m_shaderStorageInfos.begin(); it != m_shaderStorageInfos.end(); ++it)
+		if (totalNumStorages > 0)
+		{
+			const GLuint numQueriedStorageProps = 9;
+			const GLenum queriedStorageProps[] = { GL_TYPE, GL_ARRAY_SIZE, GL_OFFSET, GL_BLOCK_INDEX, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE, GL_IS_ROW_MAJOR, GL_TOP_LEVEL_ARRAY_SIZE, GL_TOP_LEVEL_ARRAY_STRIDE };
+			std::vector<GLint> rawStorageData(totalNumStorages * numQueriedStorageProps);
+			for (GLint variableIndex = 0; variableIndex < totalNumStorages; ++variableIndex)
+				GL_CALL(glGetProgramResourceiv, m_program, GL_BUFFER_VARIABLE, variableIndex, numQueriedStorageProps, queriedStorageProps, numQueriedStorageProps, nullptr, &rawStorageData[variableIndex * numQueriedStorageProps]);
+			std::vector<std::string> names = QueryResourceNames(GL_BUFFER_VARIABLE, totalNumStorages, nameBuffer);
+
+			for (GLint variableIndex = 0; variableIndex < totalNumStorages; ++variableIndex)
 			{
-				if (it->second.internalBufferIndex == rawStorageBlockInfoData[4])
+				const GLint* rawData = &rawStorageData[variableIndex * numQueriedStorageProps];
+				BufferVariableInfo storageInfo;
+				storageInfo.type = static_cast<gl::ShaderVariableType>(rawData[0]);
+				storageInfo.arrayElementCount = static_cast<std::int32_t>(rawData[1]);
+				storageInfo.blockOffset = static_cast<std::int32_t>(rawData[2]);
+				storageInfo.arrayStride = static_cast<std::int32_t>(rawData[4]);
+				storageInfo.matrixStride = static_cast<std::int32_t>(rawData[5]);
+				storageInfo.rowMajor = rawData[6] > 0;
+				storageInfo.topLevelArraySize = rawData[7];
+				storageInfo.topLevelArrayStride = rawData[8];
+
+				// where to store (to which shader storage block does this variable belong)
+				GLint blockIndex = rawData[3];
+				if (blockIndex >= 0 && blockIndex < static_cast<GLint>(storageBlocks.size()))
 				{
-					it->second.variables.emplace(name, storageInfo);
-					break;
+					std::string& name = names[variableIndex];
+					if (name.empty())
+						name = "__offset" + std::to_string(storageInfo.blockOffset);
+					storageBlocks[blockIndex]->variables.emplace(std::move(name), storageInfo);
 				}
 			}
 		}
 
+		QuerySubroutineInformations(nameBuffer);
+
 		// other informations
 		GL_CALL(glGetProgramInterfaceiv, m_program, GL_PROGRAM_INPUT, GL_ACTIVE_RESOURCES, &m_totalProgramInputCount);
 		GL_CALL(glGetProgramInterfaceiv, m_program, GL_PROGRAM_OUTPUT, GL_ACTIVE_RESOURCES, &m_totalProgramOutputCount);
 	}
 
-	template<typename BufferVariableType>
-	void ShaderObject::QueryBlockInformations(std::unordered_map<std::string, BufferInfo<BufferVariableType>>& _bufferToFill, GLenum _interfaceName)
+	void ShaderObject::QuerySubroutineInformations(std::vector<char>& _nameBuffer) const
 	{
-		_bufferToFill.clear();
+		for (unsigned int stage = 0; stage < static_cast<unsigned int>(ShaderType::NUM_SHADER_TYPES); ++stage)
+		{
+			SubroutineStageInfo& stageInfo = m_subroutineInfos[stage];
+			stageInfo = SubroutineStageInfo();
+			m_subroutineSelections[stage].clear();
+			if (!m_shader[stage].loaded)
+				continue;
+
+			GL_CALL(glGetProgramStageiv, m_program, s_shaderTypeToGLShaderType[stage], GL_ACTIVE_SUBROUTINE_UNIFORM_LOCATIONS, &stageInfo.numUniformLocations);
+			if (stageInfo.numUniformLocations <= 0)
+				continue;
+
+			// subroutine functions
+			GLint numSubroutines = 0;
+			GL_CALL(glGetProgramInterfaceiv, m_program, s_shaderTypeToSubroutineInterface[stage], GL_ACTIVE_RESOURCES, &numSubroutines);
+			std::vector<std::string> subroutineNames = QueryResourceNames(s_shaderTypeToSubroutineInterface[stage], numSubroutines, _nameBuffer);
+			for (GLint subroutineIndex = 0; subroutineIndex < numSubroutines; ++subroutineIndex)
+				stageInfo.subroutines.emplace(std::move(subroutineNames[subroutineIndex]), static_cast<GLuint>(subroutineIndex));
+
+			// subroutine uniforms
+			GLint numSubroutineUniforms = 0;
+			GL_CALL(glGetProgramInterfaceiv, m_program, s_shaderTypeToSubroutineUniformInterface[stage], GL_ACTIVE_RESOURCES, &numSubroutineUniforms);
+			std::vector<std::string> uniformNames = QueryResourceNames(s_shaderTypeToSubroutineUniformInterface[stage], numSubroutineUniforms, _nameBuffer);
+
+			m_subroutineSelections[stage].resize(stageInfo.numUniformLocations, 0);
+			const GLuint numQueriedUniformProps = 3;
+			const GLenum queriedUniformProps[] = { GL_LOCATION, GL_ARRAY_SIZE, GL_NUM_COMPATIBLE_SUBROUTINES };
+			for (GLint uniformIndex = 0; uniformIndex < numSubroutineUniforms; ++uniformIndex)
+			{
+				GLint rawData[numQueriedUniformProps];
+				GL_CALL(glGetProgramResourceiv, m_program, s_shaderTypeToSubroutineUniformInterface[stage], uniformIndex, numQueriedUniformProps, queriedUniformProps, numQueriedUniformProps, nullptr, rawData);
+
+				SubroutineUniformInfo uniformInfo;
+				uniformInfo.location = rawData[0];
+				uniformInfo.arrayElementCount = rawData[1];
+				if (rawData[2] > 0)
+				{
+					const GLenum compatibleSubroutinesProp = GL_COMPATIBLE_SUBROUTINES;
+					uniformInfo.compatibleSubroutines.resize(rawData[2]);
+					GL_CALL(glGetProgramResourceiv, m_program, s_shaderTypeToSubroutineUniformInterface[stage], uniformIndex, 1, &compatibleSubroutinesProp,
+							rawData[2], nullptr, reinterpret_cast<GLint*>(uniformInfo.compatibleSubroutines.data()));
 
-		GLint iTotalNumBlocks = 0;
-		GL_CALL(glGetProgramInterfaceiv, m_program, _interfaceName, GL_ACTIVE_RESOURCES, &iTotalNumBlocks);
+					// Every location needs a valid subroutine, default to the first compatible one.
+					for (GLint element = 0; element < std::max(uniformInfo.arrayElementCount, 1); ++element)
+					{
+						if (uniformInfo.location + element < stageInfo.numUniformLocations)
+							m_subroutineSelections[stage][uniformInfo.location + element] = uniformInfo.compatibleSubroutines[0];
+					}
+				}
+
+				std::string& name = uniformNames[uniformIndex];
+				if (name.empty())
+					name = "__location" + std::to_string(uniformInfo.location);
+				stageInfo.uniforms.emplace(std::move(name), std::move(uniformInfo));
+			}
+
+			// restore previous selections
+			for (auto it = m_subroutineNameSelections[stage].begin(); it != m_subroutineNameSelections[stage].end(); ++it)
+			{
+				auto uniformIt = stageInfo.uniforms.find(it->first.first);
+				auto subroutineIt = stageInfo.subroutines.find(it->second);
+				if (uniformIt != stageInfo.uniforms.end() && subroutineIt != stageInfo.subroutines.end())
+				{
+					GLint location = uniformIt->second.location + static_cast<GLint>(it->first.second);
+					if (location < stageInfo.numUniformLocations)
+						m_subroutineSelections[stage][location] = subroutineIt->second;
+				}
+			}
+		}
+	}
 
-		// gather infos about uniform blocks
-		const GLuint iNumQueriedBlockProps = 4;
-		const GLenum pQueriedBlockProps[] = { GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES };
-		GLint pRawUniformBlockInfoData[iNumQueriedBlockProps];
-		for (int blockIndex = 0; blockIndex < iTotalNumBlocks; ++blockIndex)
+	void ShaderObject::SendSubroutineSelections() const
+	{
+		for (unsigned int stage = 0; stage < static_cast<unsigned int>(ShaderType::NUM_SHADER_TYPES); ++stage)
 		{
-			// general data
-			GLsizei length = 0;
-			GL_CALL(glGetProgramResourceiv, m_program, _interfaceName, blockIndex, iNumQueriedBlockProps, pQueriedBlockProps, iNumQueriedBlockProps, &length, pRawUniformBlockInfoData);
-			BufferInfo<BufferVariableType> BlockInfo;
-			BlockInfo.internalBufferIndex = blockIndex;
-			BlockInfo.bufferBinding = pRawUniformBlockInfoData[1];
-			BlockInfo.bufferDataSizeByte = pRawUniformBlockInfoData[2];// * sizeof(float);
-			//BlockInfo.Variables.Reserve(pRawUniformBlockInfoData[3]);
+			if (!m_subroutineSelections[stage].empty())
+				GL_CALL(glUniformSubroutinesuiv, s_shaderTypeToGLShaderType[stage], static_cast<GLsizei>(m_subroutineSelections[stage].size()), m_subroutineSelections[stage].data());
+		}
+	}
 
-			// name
-			GLint actualNameLength = 0;
-			std::string name;
-			name.resize(pRawUniformBlockInfoData[0] + 1);
-			GL_CALL(glGetProgramResourceName, m_program, _interfaceName, blockIndex, static_cast<GLsizei>(name.size()), &actualNameLength, &name[0]);
-			name.resize(actualNameLength);
+	Result ShaderObject::SetSubroutine(ShaderType _stage, const std::string& _subroutineUniformName, const std::string& _subroutineName, GLuint _arrayElement)
+	{
+		const SubroutineStageInfo& stageInfo = GetSubroutineInfo(_stage);
+		auto uniformIt = stageInfo.uniforms.find(_subroutineUniformName);
+		if (uniformIt == stageInfo.uniforms.end())
+		{
+			GLHELPER_LOG_ERROR("Shader \"" + GetName() + "\" doesn't contain a subroutine uniform with the name \"" + _subroutineUniformName + "\"!");
+			return Result::FAILURE;
+		}
+		auto subroutineIt = stageInfo.subroutines.find(_subroutineName);
+		if (subroutineIt == stageInfo.subroutines.end())
+		{
+			GLHELPER_LOG_ERROR("Shader \"" + GetName() + "\" doesn't contain a subroutine with the name \"" + _subroutineName + "\"!");
+			return Result::FAILURE;
+		}
+		GLHELPER_ASSERT(static_cast<std::int32_t>(_arrayElement) < std::max(uniformIt->second.arrayElementCount, 1), "Subroutine uniform array element out of range!");
 
-			_bufferToFill.emplace(name, BlockInfo);
+		m_subroutineNameSelections[static_cast<unsigned int>(_stage)][std::make_pair(_subroutineUniformName, _arrayElement)] = _subroutineName;
+
+		std::vector<GLuint>& selections = m_subroutineSelections[static_cast<unsigned int>(_stage)];
+		GLint location = uniformIt->second.location + static_cast<GLint>(_arrayElement);
+		if (location >= static_cast<GLint>(selections.size()) || selections[location] == subroutineIt->second)
+			return Result::SUCCEEDED;
+		selections[location] = subroutineIt->second;
+
+		// Otherwise sent on next Activate.
+		if (Context::GetCurrent().activeShaderObject == this)
+			GL_CALL(glUniformSubroutinesuiv, s_shaderTypeToGLShaderType[static_cast<unsigned int>(_stage)], static_cast<GLsizei>(selections.size()), selections.data());
+
+		return Result::SUCCEEDED;
+	}
+
+	std::vector<std::string> ShaderObject::QueryResourceNames(GLenum _interfaceName, GLint _numResources, std::vector<char>& _nameBuffer) const
+	{
+		std::vector<std::string> names(std::max(_numResources, 0));
+
+		// GL_MAX_NAME_LENGTH includes the null terminator, so every single name fits into this space.
+		// It is zero if there are no names at all, e.g. for SPIR-V without debug info.
+		GLint maxNameLength = 0;
+		GL_CALL(glGetProgramInterfaceiv, m_program, _interfaceName, GL_MAX_NAME_LENGTH, &maxNameLength);
+		if (maxNameLength <= 1)
+			return names;
+		_nameBuffer.resize(std::max<size_t>(_nameBuffer.size(), static_cast<size_t>(maxNameLength)));
+
+		for (GLint resourceIndex = 0; resourceIndex < _numResources; ++resourceIndex)
+		{
+			GLsizei actualNameLength = 0;
+			GL_CALL(glGetProgramResourceName, m_program, _interfaceName, resourceIndex, maxNameLength, &actualNameLength, _nameBuffer.data());
+			names[resourceIndex].assign(_nameBuffer.data(), actualNameLength);
+		}
+
+		return names;
+	}
+
+	template<typename BufferVariableType>
+	void ShaderObject::QueryBlockInformations(std::unordered_map<std::string, BufferInfo<BufferVariableType>>& _bufferToFill, GLenum _interfaceName,
+												std::vector<BufferInfo<BufferVariableType>*>& _blockIndexToInfo, std::vector<char>& _nameBuffer) const
+	{
+		_bufferToFill.clear();
+		_blockIndexToInfo.clear();
+
+		GLint totalNumBlocks = 0;
+		GL_CALL(glGetProgramInterfaceiv, m_program, _interfaceName, GL_ACTIVE_RESOURCES, &totalNumBlocks);
+		if (totalNumBlocks <= 0)
+			return;
+
+		// gather infos about all blocks
+		const GLuint numQueriedBlockProps = 3;
+		const GLenum queriedBlockProps[] = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES };
+		std::vector<GLint> rawBlockData(totalNumBlocks * numQueriedBlockProps);
+		for (GLint blockIndex = 0; blockIndex < totalNumBlocks; ++blockIndex)
+			GL_CALL(glGetProgramResourceiv, m_program, _interfaceName, blockIndex, numQueriedBlockProps, queriedBlockProps, numQueriedBlockProps, nullptr, &rawBlockData[blockIndex * numQueriedBlockProps]);
+		std::vector<std::string> names = QueryResourceNames(_interfaceName, totalNumBlocks, _nameBuffer);
+
+		_bufferToFill.reserve(totalNumBlocks);
+		_blockIndexToInfo.resize(totalNumBlocks, nullptr);
+		for (GLint blockIndex = 0; blockIndex < totalNumBlocks; ++blockIndex)
+		{
+			const GLint* rawData = &rawBlockData[blockIndex * numQueriedBlockProps];
+			BufferInfo<BufferVariableType> blockInfo;
+			blockInfo.internalBufferIndex = blockIndex;
+			blockInfo.bufferBinding = rawData[0];
+			blockInfo.bufferDataSizeByte = rawData[1];
+			blockInfo.variables.reserve(rawData[2]);
+
+			std::string& name = names[blockIndex];
+			if (name.empty())
+				name = "__binding" + std::to_string(blockInfo.bufferBinding);
+
+			// Elements of unordered_map are never moved, the pointer stays valid.
+			_blockIndexToInfo[blockIndex] = &_bufferToFill.emplace(std::move(name), std::move(blockInfo)).first->second;
 		}
 	}
 
@@ -524,17 +911,38 @@ namespace gl
 	{
 		GLHELPER_ASSERT(m_containsAssembledProgram, "No shader program ready yet for ShaderObject \"" + m_name + "\". Call CreateProgram first!");
 		
-		if(s_currentlyActiveShaderObject != this)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(SHADER_OBJECT);
+		const ShaderObject*& activeShaderObject = Context::GetCurrent().activeShaderObject;
+		if(activeShaderObject != this)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(SHADER_OBJECT);
 			GL_CALL(glUseProgram, m_program);
-			s_currentlyActiveShaderObject = this;
+			activeShaderObject = this;
+
+			// Subroutine state is lost with every glUseProgram.
+			// Reflection is needed for the selections, otherwise SetSubroutine would filter a default selection that was never sent.
+			if (m_hasSubroutineUniforms)
+			{
+				EnsureProgramInformations();
+				SendSubroutineSelections();
+			}
+		}
+	}
+
+	void ShaderObject::ResetBinding()
+	{
+		const ShaderObject*& activeShaderObject = Context::GetCurrent().activeShaderObject;
+		if (activeShaderObject != nullptr)
+		{
+			GL_CALL(glUseProgram, 0);
+			activeShaderObject = nullptr;
 		}
 	}
 
 	Result ShaderObject::BindUBO(Buffer& _ubo, const std::string& _UBOName) const
 	{
-		auto it = m_uniformBlockInfos.find(_UBOName);
-		if (it == m_uniformBlockInfos.end())
+		auto it = GetUniformBufferInfo().find(_UBOName);
+		if (it == GetUniformBufferInfo().end())
 			return Result::FAILURE;
 
 		_ubo.BindUniformBuffer(it->second.bufferBinding);
@@ -555,6 +963,63 @@ namespace gl
 		return Result::SUCCEEDED;
 	}
 
+	void ShaderObject::Dispatch(GLuint _totalInvocationsX, GLuint _totalInvocationsY, GLuint _totalInvocationsZ) const
+	{
+		GLHELPER_ASSERT(m_computeWorkGroupSize[0] > 0, "Program \"" + m_name + "\" has no compute shader!");
+
+		Activate();
+		GL_CALL(glDispatchCompute, (_totalInvocationsX + m_computeWorkGroupSize[0] - 1) / m_computeWorkGroupSize[0],
+									(_totalInvocationsY + m_computeWorkGroupSize[1] - 1) / m_computeWorkGroupSize[1],
+									(_totalInvocationsZ + m_computeWorkGroupSize[2] - 1) / m_computeWorkGroupSize[2]);
+	}
+
+	void ShaderObject::DispatchIndirect(Buffer& _indirectBuffer, GLintptr _offset) const
+	{
+		GLHELPER_ASSERT(m_computeWorkGroupSize[0] > 0, "Program \"" + m_name + "\" has no compute shader!");
+		GLHELPER_ASSERT(_offset % 4 == 0 && _offset + 3 * static_cast<GLintptr>(sizeof(GLuint)) <= _indirectBuffer.GetSize(), "Invalid offset for indirect dispatch buffer!");
+
+		Activate();
+		_indirectBuffer.BindIndirectDispatchBuffer();
+		GL_CALL(glDispatchComputeIndirect, _offset);
+	}
+
+	void ShaderObject::DispatchBatch(const DispatchCommand* _commands, size_t _numCommands)
+	{
+		const ShaderObject* previousProgram = nullptr;
+		for (size_t i = 0; i < _numCommands; ++i)
+		{
+			const DispatchCommand& command = _commands[i];
+			const ShaderObject& program = *command.program;
+			GLHELPER_ASSERT(program.m_computeWorkGroupSize[0] > 0, "Program \"" + program.m_name + "\" has no compute shader!");
+
+			if (&program != previousProgram)
+			{
+				program.Activate();
+				previousProgram = &program;
+			}
+
+			GL_CALL(glDispatchCompute, (command.totalInvocationsX + program.m_computeWorkGroupSize[0] - 1) / program.m_computeWorkGroupSize[0],
+										(command.totalInvocationsY + program.m_computeWorkGroupSize[1] - 1) / program.m_computeWorkGroupSize[1],
+										(command.totalInvocationsZ + program.m_computeWorkGroupSize[2] - 1) / program.m_computeWorkGroupSize[2]);
+			if (command.barrierAfter != 0)
+				GL_CALL(glMemoryBarrier, command.barrierAfter);
+		}
+	}
+
+	Result ShaderObject::BindAtomicCounterBuffer(Buffer& _buffer, const std::string& _atomicCounterName) const
+	{
+		auto uniformIt = GetGlobalUniformInfo().find(_atomicCounterName);
+		if (uniformIt == GetGlobalUniformInfo().end() || uniformIt->second.atomicCounterbufferIndex < 0 ||
+			uniformIt->second.atomicCounterbufferIndex >= static_cast<GLint>(m_atomicCounterBufferInfos.size()))
+		{
+			GLHELPER_LOG_ERROR("Shader \"" + GetName() + "\" doesn't contain an atomic counter with the name \"" + _atomicCounterName + "\"!");
+			return Result::FAILURE;
+		}
+		_buffer.BindAtomicCounterBuffer(m_atomicCounterBufferInfos[uniformIt->second.atomicCounterbufferIndex].bufferBinding);
+
+		return Result::SUCCEEDED;
+	}
+
 	void ShaderObject::PrintShaderInfoLog(ShaderId _shader, const std::string& _shaderName)
 	{
 #ifdef SHADER_COMPILE_LOGS
@@ -609,10 +1074,9 @@ namespace gl
 
 			if (shader.loaded)
 			{
-				// Need to copy these strings, since they could be deleted during AddShaderFromFile.
-				std::string origin(shader.origin);
+				// Need to copy this string, since it could be deleted during reload.
 				std::string prefix(shader.prefixCode);
-				if (AddShaderFromFile(it->second, origin, prefix) != Result::FAILURE)
+				if (ReloadShader(it->second, prefix) != Result::FAILURE)
 				{
 					if (m_containsAssembledProgram)
 						CreateProgram();
@@ -632,9 +1096,7 @@ namespace gl
 			auto& shader = m_shader[i];
 			if (shader.loaded)
 			{
-				// Need to copy this string, since it could be deleted during AddShaderFromFile.
-				std::string origin(shader.origin);
-				if (AddShaderFromFile((ShaderType)i, origin, _newPrefixCode) == Result::FAILURE)
+				if (ReloadShader((ShaderType)i, _newPrefixCode) == Result::FAILURE)
 					return Result::FAILURE;
 			}
 		}
@@ -643,6 +1105,23 @@ namespace gl
 		return Result::SUCCEEDED;
 	}
 
+	Result ShaderObject::ReloadShader(ShaderType _type, const std::string& _prefixCode)
+	{
+		const Shader& shader = m_shader[static_cast<unsigned int>(_type)];
+
+		// Need to copy these, since they could be deleted during reload.
+		std::string origin(shader.origin);
+		if (shader.spirV)
+		{
+			// SPIR-V has no prefix code, the specialization stays the same.
+			std::string entryPoint(shader.entryPoint);
+			std::vector<SpecializationConstant> specializationConstants(shader.specializationConstants);
+			return AddShaderFromSpirVFile(_type, origin, entryPoint, specializationConstants);
+		}
+		else
+			return AddShaderFromFile(_type, origin, _prefixCode);
+	}
+
 	std::vector<char> ShaderObject::GetProgramBinary(GLenum& _binaryFormat)
 	{
 		GLHELPER_ASSERT(m_program != 0, "Program not yet compiled.");
@@ -655,10 +1134,4 @@ namespace gl
 		
 		return data;
 	}
-
-	/* void ShaderObject::ResetShaderBinding()
-	 {
-	 glUseProgram(0);
-	 g_pCurrentlyActiveShaderObject == NULL;
-	 } */
 }
\ No newline at end of file
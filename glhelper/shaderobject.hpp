@@ -2,6 +2,8 @@
 
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
+#include <map>
 
 #include "gl.hpp"
 #include "shaderdatametainfo.hpp"
@@ -9,6 +11,8 @@
 namespace gl
 {
 	class Buffer;
+	class ShaderBundle;
+	class ShaderStageCache;
 
 	/// Easy to use wrapper for OpenGL shader. Supports #include and various reflection options.
 	class ShaderObject
@@ -17,6 +21,8 @@ namespace gl
 		typedef std::unordered_map<std::string, UniformVariableInfo> GlobalUniformInfos;
 		typedef std::unordered_map<std::string, ShaderStorageBufferMetaInfo> ShaderStorageInfos;
 		typedef std::unordered_map<std::string, UniformBufferMetaInfo> UniformBlockInfos;
+		/// Indexed by the atomic counter buffer index, see UniformVariableInfo::atomicCounterbufferIndex.
+		typedef std::vector<AtomicCounterBufferMetaInfo> AtomicCounterBufferInfos;
 
 		ShaderObject(const ShaderObject&) = delete;
 		void operator = (const ShaderObject&) = delete;
@@ -34,6 +40,22 @@ namespace gl
 			NUM_SHADER_TYPES
 		};
 
+		/// Value for a SPIR-V specialization constant.
+		///
+		/// The value is stored as raw 32 bit pattern, as expected by glSpecializeShader.
+		/// \see AddShaderFromSpirV
+		struct SpecializationConstant
+		{
+			SpecializationConstant(GLuint _constantID, float _value) : constantID(_constantID) { memcpy(&value, &_value, sizeof(value)); }
+			SpecializationConstant(GLuint _constantID, std::int32_t _value) : constantID(_constantID) { memcpy(&value, &_value, sizeof(value)); }
+			SpecializationConstant(GLuint _constantID, std::uint32_t _value) : constantID(_constantID), value(_value) {}
+			SpecializationConstant(GLuint _constantID, bool _value) : constantID(_constantID), value(_value ? 1 : 0) {}
+
+			/// constant_id as given in the shader's layout qualifier.
+			GLuint constantID;
+			std::uint32_t value;
+		};
+
 		/// Constructs ShaderObject
 		/// 
 		/// To add code use AddShaderFromFile/AddShaderFromSource and call CreateProgram if you are done.
@@ -68,17 +90,83 @@ namespace gl
 		/// \see AddShaderFromSource, CreateProgram
 		Result AddShaderFromSource(ShaderType _type, const std::string& _sourceCode, const std::string& _originName);
 
+		/// Adds a shader from an entry of a shader bundle.
+		///
+		/// The entry's #includes were already resolved when creating the bundle. You need to call CreateProgram in order to link the Shader.
+		/// \param _type
+		///   Type of the added shader.
+		/// \param _bundle
+		///   Opened shader bundle.
+		/// \param _entryName
+		///   Name of the entry, i.e. the filename of the shader when it was added to the bundle. Slash style and case don't matter.
+		/// \param _prefixCode
+		///   Code inserted after the version tag.
+		/// \remarks Bundle entries are not considered by ReloadShaderFile. ReloadAllShaderFiles tries to load the entry name from a loose file.
+		/// \see ShaderBundle, ShaderBundleWriter
+		Result AddShaderFromBundle(ShaderType _type, const ShaderBundle& _bundle, const std::string& _entryName, const std::string& _prefixCode = "");
+
+		/// Adds a precompiled SPIR-V module (ARB_gl_spirv / OpenGL 4.6).
+		///
+		/// The module is specialized directly, the driver does not need to compile any GLSL.
+		/// You need to call CreateProgram in order to link the Shader.
+		/// \param _type
+		///   Type of the added shader.
+		/// \param _binary
+		///   SPIR-V binary.
+		/// \param _binarySizeInBytes
+		///   Size of the SPIR-V binary, a multiple of 4.
+		/// \param _originName
+		///   Origin name used for identifying.
+		/// \param _entryPoint
+		///   Name of the entry point function within the module.
+		/// \param _specializationConstants
+		///   Values for specialization constants. Constants that are not listed keep their default value.
+		/// \remarks SPIR-V modules usually do not contain names of uniforms and blocks (unless compiled with debug info).
+		///   Reflection uses "__binding<N>" for unnamed blocks, "__location<N>" for unnamed global uniforms and "__offset<N>" for unnamed block members in this case.
+		Result AddShaderFromSpirV(ShaderType _type, const void* _binary, size_t _binarySizeInBytes, const std::string& _originName,
+									const std::string& _entryPoint = "main", const std::vector<SpecializationConstant>& _specializationConstants = std::vector<SpecializationConstant>());
+
+		/// Adds a precompiled SPIR-V module from a binary file.
+		///
+		/// The file can be reloaded with ReloadShaderFile, using the same entry point and specialization constants.
+		/// \see AddShaderFromSpirV
+		Result AddShaderFromSpirVFile(ShaderType _type, const std::string& _filename,
+									const std::string& _entryPoint = "main", const std::vector<SpecializationConstant>& _specializationConstants = std::vector<SpecializationConstant>());
+
 		/// Links all previously added shader to an OpenGL program.
 		Result CreateProgram();
 
+		/// Marks the program as separable (GL_PROGRAM_SEPARABLE), so that its stages can be combined with other programs using a ProgramPipeline.
+		///
+		/// Takes effect with the next call of CreateProgram. Default is false.
+		/// \see ProgramPipeline
+		void SetSeparable(bool _separable) { m_separable = _separable; }
+
+		/// Returns true if the program is (or will be on the next CreateProgram) linked as separable program.
+		bool IsSeparable() const { return m_separable; }
+
+		/// Returns true if a shader of the given type was added.
+		bool HasShaderStage(ShaderType _type) const { return m_shader[static_cast<unsigned int>(_type)].loaded; }
+
 		/// Returns raw gl program identifier (you know what you're doing, right?)
 		GLuint GetProgram() const;
 
+		/// Returns the number of successful CreateProgram calls so far.
+		///
+		/// Changes whenever GetProgram changes, users of the raw program identifier can compare it to detect relinks.
+		unsigned int GetProgramGeneration() const { return m_programGeneration; }
+
 		/// Makes program active.
 		/// 
 		/// You can only activate one program at a time. Checks for redundant state changes.
+		/// Subroutine selections (see SetSubroutine) are sent again if the program actually changed, since OpenGL does not keep them.
 		void Activate() const;
 
+		/// Resets the program binding to zero.
+		///
+		/// Has no effect if no ShaderObject is active. Necessary to make a bound ProgramPipeline effective again.
+		static void ResetBinding();
+
 
 
 		/// Binds an ubo by name.
@@ -87,34 +175,96 @@ namespace gl
 		/// Binds a shader storage buffer by name.
 		Result BindSSBO(Buffer& _ssbo, const std::string& _SSBOName) const;
 
+		/// Binds the atomic counter buffer that contains the given atomic counter.
+		Result BindAtomicCounterBuffer(Buffer& _buffer, const std::string& _atomicCounterName) const;
+
+		/// Selects the subroutine for a subroutine uniform.
+		///
+		/// Selections are memorized and only sent if they change or if the program was activated after using another program.
+		/// If the program is active, the selection takes effect immediately. Survives hot reloading as long as the names stay valid.
+		/// \remarks Has no effect if the program is used via a ProgramPipeline.
+		/// \param _arrayElement
+		///		Array element of the subroutine uniform, if it is an array.
+		Result SetSubroutine(ShaderType _stage, const std::string& _subroutineUniformName, const std::string& _subroutineName, GLuint _arrayElement = 0);
+
 		/// The set of active user-defined inputs to the first shader stage in this program. 
 		/// 
 		/// If the first stage is a Vertex Shader, then this is the list of active attributes.
 		/// If the program only contains a Compute Shader, then there are no inputs.
-		GLint GetTotalProgramInputCount() const   { return m_totalProgramInputCount; }
+		GLint GetTotalProgramInputCount() const   { EnsureProgramInformations(); return m_totalProgramInputCount; }
 
 		/// The set of active user-defined outputs from the final shader stage in this program.
 		/// 
 		/// If the final stage is a Fragment Shader, then this represents the fragment outputs that get written to individual color buffers.
 		/// If the program only contains a Compute Shader, then there are no outputs.
-		GLint GetTotalProgramOutputCount() const  { return m_totalProgramOutputCount; }
+		GLint GetTotalProgramOutputCount() const  { EnsureProgramInformations(); return m_totalProgramOutputCount; }
+
 
 
+		// All reflection information is queried lazily on the first access after CreateProgram.
+		// Programs that are never inspected do not pay for it.
 
 		/// Returns infos about global uniforms
 		/// \remarks Deliberately not const so user can use operator[] on the map
-		GlobalUniformInfos& GetGlobalUniformInfo()    { return m_globalUniformInfo; }
+		GlobalUniformInfos& GetGlobalUniformInfo()    { EnsureProgramInformations(); return m_globalUniformInfo; }
 		/// \copydoc GetGlobalUniformInfo
-		const GlobalUniformInfos& GetGlobalUniformInfo() const { return m_globalUniformInfo; }
+		const GlobalUniformInfos& GetGlobalUniformInfo() const { EnsureProgramInformations(); return m_globalUniformInfo; }
 
 		/// Returns infos about used uniform buffer definitions
 		/// \remarks Deliberately not const so user can use operator[] on the map
-		UniformBlockInfos& GetUniformBufferInfo()    { return m_uniformBlockInfos; }
+		UniformBlockInfos& GetUniformBufferInfo()    { EnsureProgramInformations(); return m_uniformBlockInfos; }
 		/// \copydoc GetUniformBufferInfo
-		const UniformBlockInfos& GetUniformBufferInfo() const { return m_uniformBlockInfos; }
+		const UniformBlockInfos& GetUniformBufferInfo() const { EnsureProgramInformations(); return m_uniformBlockInfos; }
 
 		/// Returns infos about used shader storage buffer definitions
-		const ShaderStorageInfos& GetShaderStorageBufferInfo() const    { return m_shaderStorageInfos; }
+		const ShaderStorageInfos& GetShaderStorageBufferInfo() const    { EnsureProgramInformations(); return m_shaderStorageInfos; }
+
+		/// Returns infos about used atomic counter buffers
+		const AtomicCounterBufferInfos& GetAtomicCounterBufferInfo() const    { EnsureProgramInformations(); return m_atomicCounterBufferInfos; }
+
+		/// Returns infos about subroutine uniforms and subroutines of a shader stage
+		const SubroutineStageInfo& GetSubroutineInfo(ShaderType _stage) const { EnsureProgramInformations(); return m_subroutineInfos[static_cast<unsigned int>(_stage)]; }
+
+
+		// ---------------------------------------------------------------------
+		// Compute
+
+		/// Returns the local work group size of a compute program (layout(local_size_x/y/z)). Zero if the program has no compute shader.
+		///
+		/// Queried at link time.
+		IVec3 GetComputeWorkGroupSize() const { return IVec3(m_computeWorkGroupSize[0], m_computeWorkGroupSize[1], m_computeWorkGroupSize[2]); }
+
+		/// Activates the program and dispatches enough work groups to cover the given number of invocations in each dimension.
+		///
+		/// Invocation counts are rounded up to whole work groups, the shader needs to discard out of range invocations itself.
+		void Dispatch(GLuint _totalInvocationsX, GLuint _totalInvocationsY = 1, GLuint _totalInvocationsZ = 1) const;
+
+		/// Activates the program and dispatches with work group counts read from a buffer (glDispatchComputeIndirect).
+		///
+		/// \param _offset
+		///		Offset in bytes to the three GLuint work group counts within _indirectBuffer.
+		void DispatchIndirect(Buffer& _indirectBuffer, GLintptr _offset = 0) const;
+
+		/// A single dispatch within a batch.
+		struct DispatchCommand
+		{
+			DispatchCommand(const ShaderObject& _program, GLuint _totalInvocationsX, GLuint _totalInvocationsY = 1, GLuint _totalInvocationsZ = 1, GLbitfield _barrierAfter = 0) :
+				program(&_program), totalInvocationsX(_totalInvocationsX), totalInvocationsY(_totalInvocationsY), totalInvocationsZ(_totalInvocationsZ), barrierAfter(_barrierAfter) {}
+
+			const ShaderObject* program;
+			GLuint totalInvocationsX;
+			GLuint totalInvocationsY;
+			GLuint totalInvocationsZ;
+			/// Barrier bits for a glMemoryBarrier after the dispatch, zero for none.
+			GLbitfield barrierAfter;
+		};
+
+		/// Executes a list of dispatches in order.
+		///
+		/// Activates programs only when they differ from the previous command. Same rounding as Dispatch.
+		static void DispatchBatch(const DispatchCommand* _commands, size_t _numCommands);
+		/// \copydoc DispatchBatch
+		static void DispatchBatch(const std::vector<DispatchCommand>& _commands) { if (!_commands.empty()) DispatchBatch(_commands.data(), _commands.size()); }
 
 
 		/// Returns a binary representation of the shader.
@@ -140,6 +290,13 @@ namespace gl
 		const std::unordered_map<std::string, ShaderType>& GetShaderFilenames() { return m_filesPerShaderType; }
 
 	private:
+		friend class ShaderVariantSet;
+		friend class ShaderBundleWriter;
+
+		/// #line file index of prefix code that is inserted into already preprocessed source.
+		/// Chosen high so it does not collide with the indices of included files.
+		static const unsigned int s_prefixCodeFileIndex = 1000;
+
 		/// Print information about the compiling step
 		void PrintShaderInfoLog(ShaderId _shader, const std::string& _shaderName);
 		/// Print information about the linking step
@@ -151,16 +308,56 @@ namespace gl
 		static std::string ReadShaderFromFile(const std::string& shaderFilename, const std::string& prefixCode,
 												unsigned int fileIndex, std::unordered_set<std::string>& _beforeIncludedFiles, std::unordered_set<std::string>& _allReadFiles);
 
+		/// Inserts code after the #version tag and surrounds it by #line macros for proper error output.
+		/// \param _versionPos		Position of the #version tag within _sourceCode.
+		/// \param _prefixFileIndex	Second parameter for the #line macro in front of the prefix code.
+		/// \param _sourceFileIndex	Second parameter for the #line macro after the prefix code, identifies the file containing the #version tag.
+		/// \return Position in _sourceCode right after the inserted code.
+		static size_t InsertPrefixCode(std::string& _sourceCode, size_t _versionPos, const std::string& _prefixCode, unsigned int _prefixFileIndex, unsigned int _sourceFileIndex);
+
 		/// Internal function called by AddShaderFromSource and AddShaderFromFile
 		Result AddShader(ShaderType _type, const std::string& _sourceCode, const std::string& _originName, const std::string& _prefixCode);
 
+		/// Creates an empty OpenGL shader of the given type.
+		static ShaderId CreateShader(ShaderType _type);
+
+		/// Checks compile status of a new shader and replaces the current shader of the given type if successful. Deletes it otherwise.
+		/// \param _result	Result of all previous gl calls on _newShader.
+		Result FinalizeShader(ShaderType _type, ShaderId _newShader, Result _result, const std::string& _originName);
+
+		/// Replaces the current shader of the given type with a successfully compiled one. The old shader is released via ReleaseShader.
+		/// The new shader belongs to the ShaderStageCache of the current gl::Context.
+		void ReplaceShader(ShaderType _type, ShaderId _newShader, const std::string& _originName);
+
+		/// Releases the loaded shader of the given type into the ShaderStageCache it belongs to. Its gl::Context needs to be current.
+		void ReleaseShader(ShaderType _type);
+
+		/// Reloads a single shader stage from its origin file. Uses the same prefix code or specialization as before.
+		Result ReloadShader(ShaderType _type, const std::string& _prefixCode);
+
+
+		/// Queries program informations if not already done since the last CreateProgram.
+		void EnsureProgramInformations() const { if (!m_programInformationsQueried) QueryProgramInformations(); }
 
 		/// queries uniform informations from the program
-		void QueryProgramInformations();
+		void QueryProgramInformations() const;
 
 		/// Intern helper function for gather general BufferInformations
+		/// \param _blockIndexToInfo	Filled with a pointer to the info of each block, indexed by the block index.
+		/// \param _nameBuffer			Scratch buffer for resource names, resized if necessary.
 		template<typename BufferVariableType>
-		void QueryBlockInformations(std::unordered_map<std::string, BufferInfo<BufferVariableType>>& BufferToFill, GLenum InterfaceName);
+		void QueryBlockInformations(std::unordered_map<std::string, BufferInfo<BufferVariableType>>& _bufferToFill, GLenum _interfaceName,
+									std::vector<BufferInfo<BufferVariableType>*>& _blockIndexToInfo, std::vector<char>& _nameBuffer) const;
+
+		/// Queries subroutine uniforms and subroutines of all stages and restores memorized subroutine selections.
+		void QuerySubroutineInformations(std::vector<char>& _nameBuffer) const;
+
+		/// Sends subroutine selections of all stages that have subroutine uniforms.
+		void SendSubroutineSelections() const;
+
+		/// Reads the names of all resources of an interface, using _nameBuffer as scratch memory.
+		/// Names may be empty if the program was created from SPIR-V.
+		std::vector<std::string> QueryResourceNames(GLenum _interfaceName, GLint _numResources, std::vector<char>& _nameBuffer) const;
 
 
 		/// Name for identifying at runtime
@@ -169,10 +366,8 @@ namespace gl
 		// the program itself
 		ProgramId m_program;
 		bool m_containsAssembledProgram;
-
-		/// currently active shader object
-		/// As long as no user bypasses the Activate mechanism by calling glUseProgram, this pointer will always point the currently bound program.
-		static const ShaderObject* s_currentlyActiveShaderObject;
+		bool m_separable;
+		unsigned int m_programGeneration;
 
 		/// list of relevant files - if any of these changes a reload can be triggered via ShaderFileChangeHandler.
 		std::unordered_map<std::string, ShaderType> m_filesPerShaderType;
@@ -184,22 +379,40 @@ namespace gl
 			std::string origin;
 			std::string prefixCode;
 			bool loaded;
+			/// Cache of the gl::Context the shader was loaded in. All releases go there, SPIR-V shaders are deleted by it directly.
+			ShaderStageCache* stageCache;
+
+			// SPIR-V only
+			bool spirV;
+			std::string entryPoint;
+			std::vector<SpecializationConstant> specializationConstants;
 		};
 		Shader m_shader[(unsigned int)ShaderType::NUM_SHADER_TYPES];
 
-		// meta information
-		GlobalUniformInfos m_globalUniformInfo;
-		UniformBlockInfos  m_uniformBlockInfos;
-		ShaderStorageInfos m_shaderStorageInfos;
+		// meta information - mutable since it is queried lazily
+		mutable bool m_programInformationsQueried;
+		mutable GlobalUniformInfos m_globalUniformInfo;
+		mutable UniformBlockInfos  m_uniformBlockInfos;
+		mutable ShaderStorageInfos m_shaderStorageInfos;
+		mutable AtomicCounterBufferInfos m_atomicCounterBufferInfos;
+		mutable SubroutineStageInfo m_subroutineInfos[(unsigned int)ShaderType::NUM_SHADER_TYPES];
+
+		/// Subroutine index per subroutine uniform location and stage, as sent with glUniformSubroutinesuiv.
+		mutable std::vector<GLuint> m_subroutineSelections[(unsigned int)ShaderType::NUM_SHADER_TYPES];
+		/// Subroutine selections by name, to restore them after relinking: (uniform name, array element) -> subroutine name.
+		std::map<std::pair<std::string, GLuint>, std::string> m_subroutineNameSelections[(unsigned int)ShaderType::NUM_SHADER_TYPES];
+
+		/// Queried eagerly on link, since it is needed for every Dispatch.
+		GLint m_computeWorkGroupSize[3];
+		/// Queried eagerly on link, since subroutine selections need to be sent on every Activate.
+		bool m_hasSubroutineUniforms;
 
 		// misc
-		GLint m_totalProgramInputCount;  ///< \see GetTotalProgramInputCount
-		GLint m_totalProgramOutputCount; ///< \see GetTotalProgramOutputCount
+		mutable GLint m_totalProgramInputCount;  ///< \see GetTotalProgramInputCount
+		mutable GLint m_totalProgramOutputCount; ///< \see GetTotalProgramOutputCount
 
 		// currently missing meta information
 		// - transform feedback buffer
 		// - transform feedback varying
-		// - subroutines
-		// - atomic counter buffer
 	};
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "shaderstagecache.hpp"
+#include "context.hpp"
+#include "utils/hash.hpp"
+
+namespace gl
+{
+	ShaderStageCache& ShaderStageCache::GetCurrent()
+	{
+		return Context::GetCurrent().shaderStageCache;
+	}
+
+	std::uint64_t ShaderStageCache::ComputeHash(ShaderObject::ShaderType _type, const std::string& _sourceCode)
+	{
+		std::uint32_t type = static_cast<std::uint32_t>(_type);
+		std::uint64_t hash = HashUtils::FNV1a(&type, sizeof(type));
+		return HashUtils::FNV1a(_sourceCode.data(), _sourceCode.size(), hash);
+	}
+
+	ShaderId ShaderStageCache::Acquire(ShaderObject::ShaderType _type, const std::string& _sourceCode)
+	{
+		auto range = m_shadersByHash.equal_range(ComputeHash(_type, _sourceCode));
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			Entry& entry = m_entries[it->second];
+			if (entry.type == _type && entry.sourceCode == _sourceCode)
+			{
+				++entry.referenceCount;
+				++m_statistics.numCompilesAvoided;
+				return it->second;
+			}
+		}
+
+		return 0;
+	}
+
+	void ShaderStageCache::Insert(ShaderObject::ShaderType _type, const std::string& _sourceCode, ShaderId _shader)
+	{
+		GLHELPER_ASSERT(m_entries.find(_shader) == m_entries.end(), "Shader is already in the stage cache!");
+
+		Entry entry;
+		entry.type = _type;
+		entry.hash = ComputeHash(_type, _sourceCode);
+		entry.sourceCode = _sourceCode;
+		entry.referenceCount = 1;
+
+		m_shadersByHash.emplace(entry.hash, _shader);
+		m_entries.emplace(_shader, std::move(entry));
+		++m_statistics.numCompiles;
+	}
+
+	void ShaderStageCache::Release(ShaderId _shader)
+	{
+		auto entryIt = m_entries.find(_shader);
+		if (entryIt != m_entries.end())
+		{
+			GLHELPER_ASSERT(entryIt->second.referenceCount > 0, "Invalid reference count in stage cache!");
+			if (--entryIt->second.referenceCount > 0)
+				return;
+
+			auto range = m_shadersByHash.equal_range(entryIt->second.hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second == _shader)
+				{
+					m_shadersByHash.erase(it);
+					break;
+				}
+			}
+			m_entries.erase(entryIt);
+		}
+
+		GL_CALL(glDeleteShader, _shader);
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "shaderobject.hpp"
+
+#include <unordered_map>
+#include <cstdint>
+
+namespace gl
+{
+	/// Cache of compiled shader stages, shared between all ShaderObjects of one gl::Context.
+	///
+	/// Every gl::Context has its own cache, ShaderObjects use the one of the context that is current on the calling thread.
+	/// Each loaded stage remembers the cache it came from and is released there, with its context current again.
+	/// This way threads with different OpenGL contexts never race on the cache and never get shaders of a context that doesn't share objects with theirs.
+	/// Stages are identified by their type and final source code (after #include resolving and prefix code insertion).
+	/// Byte-identical stages are compiled only once and attached to every program that uses them.
+	/// Shared shaders are reference counted, the GL shader is deleted when the last user releases it.
+	/// Used internally by ShaderObject, SPIR-V stages are not cached.
+	class ShaderStageCache
+	{
+	public:
+		struct Statistics
+		{
+			Statistics() : numCompiles(0), numCompilesAvoided(0) {}
+
+			/// Number of compiled stages that were added to the cache.
+			std::uint64_t numCompiles;
+			/// Number of requests that were served by an already compiled stage.
+			std::uint64_t numCompilesAvoided;
+		};
+
+		ShaderStageCache() {}
+		ShaderStageCache(const ShaderStageCache&) = delete;
+		void operator = (const ShaderStageCache&) = delete;
+
+		/// Returns the cache of the gl::Context that is current on the calling thread.
+		static ShaderStageCache& GetCurrent();
+
+		/// Returns the statistics since the start or the last ResetStatistics.
+		const Statistics& GetStatistics() const { return m_statistics; }
+		void ResetStatistics() { m_statistics = Statistics(); }
+
+		/// Number of unique stages that are currently alive.
+		size_t GetNumCachedStages() const { return m_entries.size(); }
+
+		/// Searches for a compiled stage with the given type and source code.
+		///
+		/// Increments the reference count of the returned shader, release it with Release.
+		/// \return 0 if there is no such stage.
+		ShaderId Acquire(ShaderObject::ShaderType _type, const std::string& _sourceCode);
+
+		/// Adds a successfully compiled shader to the cache with a reference count of one.
+		void Insert(ShaderObject::ShaderType _type, const std::string& _sourceCode, ShaderId _shader);
+
+		/// Decrements the reference count of a shader and deletes it if no reference is left.
+		///
+		/// Shaders that are not in the cache are deleted immediately.
+		void Release(ShaderId _shader);
+
+	private:
+		static std::uint64_t ComputeHash(ShaderObject::ShaderType _type, const std::string& _sourceCode);
+
+		struct Entry
+		{
+			ShaderObject::ShaderType type;
+			std::uint64_t hash;
+			/// Full source to rule out hash collisions.
+			std::string sourceCode;
+			unsigned int referenceCount;
+		};
+		std::unordered_map<ShaderId, Entry> m_entries;
+		/// Shaders by hash of type and source.
+		std::unordered_multimap<std::uint64_t, ShaderId> m_shadersByHash;
+
+		Statistics m_statistics;
+	};
+}
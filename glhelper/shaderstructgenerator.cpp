@@ -0,0 +1,393 @@
+#include "shaderstructgenerator.hpp"
+#include "shaderobject.hpp"
+
+#include <sstream>
+#include <vector>
+#include <map>
+#include <limits>
+#include <algorithm>
+
+namespace gl
+{
+	namespace
+	{
+		const char* GetComponentTypeName(ShaderVariableTypeLayout::ComponentType _componentType)
+		{
+			switch (_componentType)
+			{
+			case ShaderVariableTypeLayout::ComponentType::FLOAT:		return "float";
+			case ShaderVariableTypeLayout::ComponentType::DOUBLE:		return "double";
+			case ShaderVariableTypeLayout::ComponentType::INT:			return "std::int32_t";
+			default:													return "std::uint32_t";
+			}
+		}
+
+		std::string SanitizeIdentifier(const std::string& _name)
+		{
+			std::string identifier;
+			identifier.reserve(_name.size());
+			for (char c : _name)
+			{
+				if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')
+					identifier += c;
+				else if (c != ']')
+					identifier += '_';
+			}
+			if (identifier.empty() || (identifier[0] >= '0' && identifier[0] <= '9'))
+				identifier.insert(0, "_");
+			return identifier;
+		}
+
+		void WritePadding(std::ostringstream& _code, size_t& _currentOffset, size_t _targetOffset, unsigned int& _paddingIndex, const char* _indent)
+		{
+			if (_targetOffset > _currentOffset)
+			{
+				_code << _indent << "std::uint8_t _padding" << _paddingIndex++ << "[" << (_targetOffset - _currentOffset) << "];\n";
+				_currentOffset = _targetOffset;
+			}
+		}
+
+		const BufferVariableInfo* AsBufferVariable(const BufferVariableInfo& _info) { return &_info; }
+		const BufferVariableInfo* AsBufferVariable(const UniformVariableInfo&) { return nullptr; }
+
+		template<typename VariableInfoType> struct TopLevelArray;
+
+		template<typename VariableInfoType>
+		struct Member
+		{
+			const std::string* reflectedName;
+			std::string identifier;
+			const VariableInfoType* info;
+			/// Offset within the generated struct that contains the member.
+			size_t offset;
+			/// Not null if the member is a top-level array of structs, info and reflectedName are unused then.
+			const TopLevelArray<VariableInfoType>* topLevelArray;
+		};
+
+		/// Fixed size top-level array of structs in a shader storage block. Reflection lists only the members of the first element.
+		template<typename VariableInfoType>
+		struct TopLevelArray
+		{
+			std::vector<Member<VariableInfoType>> elementMembers;
+			unsigned int size;
+			size_t stride;
+		};
+
+		/// Code that is collected while writing the members of a block and placed after or at the end of the struct.
+		struct BlockCode
+		{
+			std::ostringstream offsetAsserts;
+			std::ostringstream memberLayouts;
+			std::ostringstream excludedVariables;
+		};
+
+		void ExcludeVariable(BlockCode& _blockCode, const std::string& _reflectedName)
+		{
+			_blockCode.excludedVariables << "\t\t\t\"" << _reflectedName << "\",\n";
+		}
+
+		/// Writes members sorted by offset with explicit padding in between.
+		/// \param _structPath
+		///		Name of the written struct as seen from outside of the block struct, used for offsetof.
+		/// \param _layoutOffset
+		///		Offset expression of the written struct within the block, prepended to the member layouts for CheckLayout.
+		template<typename VariableInfoType>
+		void WriteMembers(std::ostringstream& _code, BlockCode& _blockCode, std::vector<Member<VariableInfoType>>& _members, const std::string& _structPath,
+							const std::string& _layoutOffset, const char* _indent, size_t& _currentOffset, unsigned int& _paddingIndex)
+		{
+			std::sort(_members.begin(), _members.end(), [](const Member<VariableInfoType>& _a, const Member<VariableInfoType>& _b) { return _a.offset < _b.offset; });
+
+			for (const Member<VariableInfoType>& member : _members)
+			{
+				if (member.offset < _currentOffset)
+				{
+					if (member.topLevelArray)
+					{
+						_code << _indent << "// " << member.identifier << ": overlapping offset " << member.offset << ", skipped\n";
+						for (const Member<VariableInfoType>& elementMember : member.topLevelArray->elementMembers)
+							ExcludeVariable(_blockCode, *elementMember.reflectedName);
+					}
+					else
+					{
+						_code << _indent << "// " << *member.reflectedName << ": overlapping offset " << member.offset << ", skipped\n";
+						ExcludeVariable(_blockCode, *member.reflectedName);
+					}
+					continue;
+				}
+
+				if (member.topLevelArray)
+				{
+					// Nested struct for a single element, padded to the array stride.
+					std::string elementStructName = member.identifier + "Element";
+					std::string elementStructPath = _structPath + "::" + elementStructName;
+					std::string elementIndent = std::string(_indent) + "\t";
+					std::vector<Member<VariableInfoType>> elementMembers = member.topLevelArray->elementMembers;
+					size_t elementOffset = 0;
+					unsigned int elementPaddingIndex = 0;
+
+					WritePadding(_code, _currentOffset, member.offset, _paddingIndex, _indent);
+					_code << _indent << "struct " << elementStructName << "\n" << _indent << "{\n";
+					WriteMembers(_code, _blockCode, elementMembers, elementStructPath, _layoutOffset + "offsetof(" + _structPath + ", " + member.identifier + ") + ",
+								elementIndent.c_str(), elementOffset, elementPaddingIndex);
+					WritePadding(_code, elementOffset, member.topLevelArray->stride, elementPaddingIndex, elementIndent.c_str());
+					_code << _indent << "} " << member.identifier << "[" << member.topLevelArray->size << "];\n";
+					_currentOffset += member.topLevelArray->stride * member.topLevelArray->size;
+
+					_blockCode.offsetAsserts << "static_assert(sizeof(" << elementStructPath << ") == " << member.topLevelArray->stride
+											<< ", \"Size of " << elementStructPath << " does not match the array stride of the shader.\");\n";
+					_blockCode.offsetAsserts << "static_assert(offsetof(" << _structPath << ", " << member.identifier << ") == " << member.offset
+											<< ", \"Offset of " << _structPath << "::" << member.identifier << " does not match the shader.\");\n";
+					continue;
+				}
+
+				const VariableInfoType& info = *member.info;
+				ShaderVariableTypeLayout type;
+				if (!GetShaderVariableTypeLayout(info.type, type))
+				{
+					_code << _indent << "// " << *member.reflectedName << ": unsupported type, skipped\n";
+					ExcludeVariable(_blockCode, *member.reflectedName);
+					continue;
+				}
+				WritePadding(_code, _currentOffset, member.offset, _paddingIndex, _indent);
+
+				// Element layout: vectors are plain arrays, matrices arrays of (padded) columns or rows.
+				size_t elementSize;
+				std::string elementDimensions;
+				if (type.numColumns > 1)
+				{
+					unsigned int numVectors = info.rowMajor ? type.numRows : type.numColumns;
+					size_t vectorStride = info.matrixStride > 0 ? info.matrixStride : type.componentSize * (info.rowMajor ? type.numColumns : type.numRows);
+					elementDimensions = "[" + std::to_string(numVectors) + "][" + std::to_string(vectorStride / type.componentSize) + "]";
+					elementSize = numVectors * vectorStride;
+				}
+				else
+				{
+					if (type.numRows > 1)
+						elementDimensions = "[" + std::to_string(type.numRows) + "]";
+					elementSize = type.componentSize * type.numRows;
+				}
+
+				if (info.arrayElementCount > 1)
+				{
+					size_t arrayStride = info.arrayStride > 0 ? info.arrayStride : elementSize;
+					if (arrayStride == elementSize)
+						_code << _indent << GetComponentTypeName(type.componentType) << " " << member.identifier << "[" << info.arrayElementCount << "]" << elementDimensions << ";\n";
+					else
+					{
+						// Wrap element with its padding.
+						_code << _indent << "struct { " << GetComponentTypeName(type.componentType) << " value" << elementDimensions << "; std::uint8_t _padding[" << (arrayStride - elementSize) << "]; } "
+							<< member.identifier << "[" << info.arrayElementCount << "];\n";
+					}
+					_currentOffset += arrayStride * info.arrayElementCount;
+				}
+				else
+				{
+					_code << _indent << GetComponentTypeName(type.componentType) << " " << member.identifier << elementDimensions << ";\n";
+					_currentOffset += elementSize;
+				}
+
+				_blockCode.offsetAsserts << "static_assert(offsetof(" << _structPath << ", " << member.identifier << ") == " << member.offset
+										<< ", \"Offset of " << _structPath << "::" << member.identifier << " does not match the shader.\");\n";
+				_blockCode.memberLayouts << "\t\t\t{ \"" << *member.reflectedName << "\", " << _layoutOffset << "offsetof(" << _structPath << ", " << member.identifier << ") },\n";
+			}
+		}
+
+		std::string StripArrayIndex(std::string _name)
+		{
+			if (_name.size() > 3 && _name.compare(_name.size() - 3, 3, "[0]") == 0)
+				_name.resize(_name.size() - 3);
+			return _name;
+		}
+	}
+
+	template<typename VariableInfoType>
+	std::string ShaderStructGenerator::GenerateStruct(const std::string& _structName, const BufferInfo<VariableInfoType>& _blockInfo)
+	{
+		BlockCode blockCode;
+		std::ostringstream runtimeArrayComment;
+		size_t runtimeArrayOffset = std::numeric_limits<size_t>::max();
+
+		// Ordered by name for deterministic output, values need stable addresses.
+		std::map<std::string, TopLevelArray<VariableInfoType>> topLevelArrays;
+
+		std::vector<Member<VariableInfoType>> members;
+		for (auto it = _blockInfo.variables.begin(); it != _blockInfo.variables.end(); ++it)
+		{
+			const VariableInfoType& info = it->second;
+
+			// Runtime sized arrays cannot be part of a struct.
+			const BufferVariableInfo* bufferVariable = AsBufferVariable(info);
+			if (info.arrayElementCount == 0 || (bufferVariable && bufferVariable->topLevelArraySize == 0))
+			{
+				runtimeArrayComment << "// " << _structName << "::" << it->first << " is a runtime sized array starting at offset " << info.blockOffset
+									<< " with a stride of " << (bufferVariable && bufferVariable->topLevelArrayStride > 0 ? bufferVariable->topLevelArrayStride : info.arrayStride) << " bytes.\n";
+				ExcludeVariable(blockCode, it->first);
+				runtimeArrayOffset = std::min(runtimeArrayOffset, static_cast<size_t>(info.blockOffset));
+				continue;
+			}
+
+			// Flatten struct members.
+			std::string name = it->first;
+			if (name.compare(0, _structName.size() + 1, _structName + ".") == 0)
+				name.erase(0, _structName.size() + 1);
+
+			// Elements of a top-level array of structs (or arrays) go into a nested struct, named by the part after the top-level index.
+			size_t topLevelIndexPos = name.find("[0]");
+			if (bufferVariable && bufferVariable->topLevelArraySize > 1 && topLevelIndexPos != std::string::npos && topLevelIndexPos + 3 < name.size())
+			{
+				std::string elementName = StripArrayIndex(name.substr(topLevelIndexPos + 3));
+				if (!elementName.empty() && elementName[0] == '.')
+					elementName.erase(0, 1);
+
+				TopLevelArray<VariableInfoType>& topLevelArray = topLevelArrays[name.substr(0, topLevelIndexPos)];
+				topLevelArray.size = bufferVariable->topLevelArraySize;
+				topLevelArray.stride = bufferVariable->topLevelArrayStride;
+				Member<VariableInfoType> member = { &it->first, SanitizeIdentifier(elementName.empty() ? "value" : elementName), &info, static_cast<size_t>(info.blockOffset), nullptr };
+				topLevelArray.elementMembers.push_back(member);
+				continue;
+			}
+
+			Member<VariableInfoType> member = { &it->first, SanitizeIdentifier(StripArrayIndex(name)), &info, static_cast<size_t>(info.blockOffset), nullptr };
+			members.push_back(member);
+		}
+
+		// The first element starts with its first member, element offsets become relative to it.
+		for (auto& topLevelArray : topLevelArrays)
+		{
+			size_t arrayOffset = std::numeric_limits<size_t>::max();
+			for (const Member<VariableInfoType>& elementMember : topLevelArray.second.elementMembers)
+				arrayOffset = std::min(arrayOffset, elementMember.offset);
+			for (Member<VariableInfoType>& elementMember : topLevelArray.second.elementMembers)
+				elementMember.offset -= arrayOffset;
+
+			Member<VariableInfoType> member = { nullptr, SanitizeIdentifier(topLevelArray.first), nullptr, arrayOffset, &topLevelArray.second };
+			members.push_back(member);
+		}
+
+		std::ostringstream code;
+		code << "struct " << _structName << "\n{\n";
+
+		size_t currentOffset = 0;
+		unsigned int paddingIndex = 0;
+		WriteMembers(code, blockCode, members, _structName, "", "\t", currentOffset, paddingIndex);
+
+		// Pad to full block size. A runtime sized array at the end is not part of the struct, pad up to its start instead.
+		size_t structSize = runtimeArrayOffset != std::numeric_limits<size_t>::max() ? runtimeArrayOffset : static_cast<size_t>(std::max(_blockInfo.bufferDataSizeByte, 0));
+		WritePadding(code, currentOffset, structSize, paddingIndex, "\t");
+		if (structSize > 0)
+		{
+			blockCode.offsetAsserts << "static_assert(sizeof(" << _structName << ") == " << structSize << ", \"Size of " << _structName << " does not match the "
+									<< (runtimeArrayOffset != std::numeric_limits<size_t>::max() ? "offset of the runtime sized array" : "block size") << " of the shader.\");\n";
+		}
+
+		// Reflection data for ShaderStructGenerator::CheckLayout.
+		code << "\n\tstatic const char* GetBlockName() { return \"" << _structName << "\"; }\n";
+		code << "\tstatic const gl::ShaderStructGenerator::MemberLayout* GetMemberLayouts(size_t& _numMembers)\n\t{\n";
+		if (blockCode.memberLayouts.str().empty())
+			code << "\t\t_numMembers = 0;\n\t\treturn nullptr;\n";
+		else
+		{
+			code << "\t\tstatic const gl::ShaderStructGenerator::MemberLayout memberLayouts[] =\n\t\t{\n" << blockCode.memberLayouts.str() << "\t\t};\n";
+			code << "\t\t_numMembers = sizeof(memberLayouts) / sizeof(memberLayouts[0]);\n\t\treturn memberLayouts;\n";
+		}
+		code << "\t}\n";
+		code << "\t/// Reflected variables that are not part of the struct.\n";
+		code << "\tstatic const char* const* GetExcludedVariables(size_t& _numVariables)\n\t{\n";
+		if (blockCode.excludedVariables.str().empty())
+			code << "\t\t_numVariables = 0;\n\t\treturn nullptr;\n";
+		else
+		{
+			code << "\t\tstatic const char* const excludedVariables[] =\n\t\t{\n" << blockCode.excludedVariables.str() << "\t\t};\n";
+			code << "\t\t_numVariables = sizeof(excludedVariables) / sizeof(excludedVariables[0]);\n\t\treturn excludedVariables;\n";
+		}
+		code << "\t}\n";
+		code << "};\n";
+		code << blockCode.offsetAsserts.str();
+		code << runtimeArrayComment.str();
+
+		return code.str();
+	}
+
+	template std::string ShaderStructGenerator::GenerateStruct(const std::string&, const BufferInfo<UniformVariableInfo>&);
+	template std::string ShaderStructGenerator::GenerateStruct(const std::string&, const BufferInfo<BufferVariableInfo>&);
+
+	std::string ShaderStructGenerator::GenerateHeader(const ShaderObject& _program, const std::string& _namespace)
+	{
+		std::ostringstream code;
+		code << "// Generated by gl::ShaderStructGenerator from program \"" << _program.GetName() << "\". Do not edit.\n\n";
+		code << "#pragma once\n\n#include <shaderstructgenerator.hpp>\n#include <cstdint>\n#include <cstddef>\n\n";
+		if (!_namespace.empty())
+			code << "namespace " << _namespace << "\n{\n";
+
+		// Maps are unordered, sort for deterministic output.
+		std::vector<std::string> blockNames;
+		for (auto it = _program.GetUniformBufferInfo().begin(); it != _program.GetUniformBufferInfo().end(); ++it)
+			blockNames.push_back(it->first);
+		std::sort(blockNames.begin(), blockNames.end());
+		for (const std::string& blockName : blockNames)
+			code << "// uniform block \"" << blockName << "\"\n" << GenerateStruct(SanitizeIdentifier(blockName), _program.GetUniformBufferInfo().at(blockName)) << "\n";
+
+		blockNames.clear();
+		for (auto it = _program.GetShaderStorageBufferInfo().begin(); it != _program.GetShaderStorageBufferInfo().end(); ++it)
+			blockNames.push_back(it->first);
+		std::sort(blockNames.begin(), blockNames.end());
+		for (const std::string& blockName : blockNames)
+			code << "// shader storage block \"" << blockName << "\"\n" << GenerateStruct(SanitizeIdentifier(blockName), _program.GetShaderStorageBufferInfo().at(blockName)) << "\n";
+
+		if (!_namespace.empty())
+			code << "}\n";
+
+		return code.str();
+	}
+
+	template<typename VariableInfoType>
+	Result ShaderStructGenerator::CheckLayout(const char* _structName, size_t _structSize, const MemberLayout* _members, size_t _numMembers,
+												const char* const* _excludedVariables, size_t _numExcludedVariables, const BufferInfo<VariableInfoType>& _blockInfo)
+	{
+		Result result = Result::SUCCEEDED;
+
+		for (size_t i = 0; i < _numMembers; ++i)
+		{
+			auto variableIt = _blockInfo.variables.find(_members[i].reflectedName);
+			if (variableIt == _blockInfo.variables.end())
+			{
+				GLHELPER_LOG_ERROR(std::string("Generated struct ") + _structName + " contains " + _members[i].reflectedName + " which is no longer part of the block.");
+				result = Result::FAILURE;
+			}
+			else if (static_cast<size_t>(variableIt->second.blockOffset) != _members[i].offset)
+			{
+				GLHELPER_LOG_ERROR(std::string("Generated struct ") + _structName + ": offset of " + _members[i].reflectedName + " is " + std::to_string(_members[i].offset) +
+									" but the shader expects " + std::to_string(variableIt->second.blockOffset));
+				result = Result::FAILURE;
+			}
+		}
+
+		// Every variable of the block needs to be either a member or excluded by the generator.
+		for (auto it = _blockInfo.variables.begin(); it != _blockInfo.variables.end(); ++it)
+		{
+			bool known = std::any_of(_members, _members + _numMembers, [&](const MemberLayout& _member) { return it->first == _member.reflectedName; }) ||
+						std::any_of(_excludedVariables, _excludedVariables + _numExcludedVariables, [&](const char* _excludedVariable) { return it->first == _excludedVariable; });
+			if (!known)
+			{
+				GLHELPER_LOG_ERROR(std::string("Generated struct ") + _structName + " does not contain the block variable " + it->first + ".");
+				result = Result::FAILURE;
+			}
+		}
+
+		if (_blockInfo.bufferDataSizeByte > 0)
+		{
+			if (_structSize > static_cast<size_t>(_blockInfo.bufferDataSizeByte))
+			{
+				GLHELPER_LOG_ERROR(std::string("Generated struct ") + _structName + " is " + std::to_string(_structSize) + " bytes, larger than the block with " + std::to_string(_blockInfo.bufferDataSizeByte) + " bytes.");
+				result = Result::FAILURE;
+			}
+			else if (_structSize < static_cast<size_t>(_blockInfo.bufferDataSizeByte))
+				GLHELPER_LOG_WARNING(std::string("Generated struct ") + _structName + " is smaller than the block. Fine if the block ends with a runtime sized array.");
+		}
+
+		return result;
+	}
+
+	template Result ShaderStructGenerator::CheckLayout(const char*, size_t, const MemberLayout*, size_t, const char* const*, size_t, const BufferInfo<UniformVariableInfo>&);
+	template Result ShaderStructGenerator::CheckLayout(const char*, size_t, const MemberLayout*, size_t, const char* const*, size_t, const BufferInfo<BufferVariableInfo>&);
+}
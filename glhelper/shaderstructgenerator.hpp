@@ -0,0 +1,67 @@
+#pragma once
+
+#include "shaderdatametainfo.hpp"
+
+#include <string>
+
+namespace gl
+{
+	class ShaderObject;
+
+	/// Generates C++ structs that match the memory layout of uniform and shader storage blocks (std140/std430 or any other layout).
+	///
+	/// The layout is taken from reflection, all padding is explicit and each member offset is checked by a static_assert.
+	/// Filling whole blocks with a single memcpy or direct member writes into mapped memory is much faster than BufferInfoView.
+	/// Vectors and matrices are emitted as plain arrays, so the generated code does not depend on the configured vector types.
+	/// Usually used offline, see tools/shaderstructgen.
+	class ShaderStructGenerator
+	{
+	public:
+		/// Layout of a single generated member, used for the runtime check.
+		struct MemberLayout
+		{
+			const char* reflectedName;
+			size_t offset;
+		};
+
+		/// Generates a single struct for a block.
+		///
+		/// Members of nested structs are flattened, names are sanitized to valid identifiers.
+		/// A fixed size top-level array of structs in a shader storage block becomes an array of a nested struct with the reflected array stride.
+		/// A runtime sized array at the end of a shader storage block is not part of the struct, its offset and stride are noted in a comment.
+		/// The struct size is the reflected block size (or the offset of the runtime sized array), checked by a static_assert.
+		/// Variables that can not be part of the struct are listed by its GetExcludedVariables.
+		template<typename VariableInfoType>
+		static std::string GenerateStruct(const std::string& _structName, const BufferInfo<VariableInfoType>& _blockInfo);
+
+		/// Generates a complete header with structs for all uniform and shader storage blocks of a program.
+		///
+		/// Struct names are the block names.
+		/// \param _namespace
+		///		Namespace for all structs, none if empty.
+		static std::string GenerateHeader(const ShaderObject& _program, const std::string& _namespace = "");
+
+		/// Checks if a generated struct still matches the reflected layout of a block.
+		///
+		/// Reports all mismatches to the log. Use this after shader reloads or in debug builds to detect outdated generated code.
+		/// Variables the generator excluded from the struct are not reported as missing.
+		template<typename GeneratedStruct, typename VariableInfoType>
+		static Result CheckLayout(const BufferInfo<VariableInfoType>& _blockInfo);
+
+	private:
+		/// Compares a list of member layouts with reflected variables.
+		template<typename VariableInfoType>
+		static Result CheckLayout(const char* _structName, size_t _structSize, const MemberLayout* _members, size_t _numMembers,
+									const char* const* _excludedVariables, size_t _numExcludedVariables, const BufferInfo<VariableInfoType>& _blockInfo);
+	};
+
+	template<typename GeneratedStruct, typename VariableInfoType>
+	inline Result ShaderStructGenerator::CheckLayout(const BufferInfo<VariableInfoType>& _blockInfo)
+	{
+		size_t numMembers = 0;
+		const MemberLayout* members = GeneratedStruct::GetMemberLayouts(numMembers);
+		size_t numExcludedVariables = 0;
+		const char* const* excludedVariables = GeneratedStruct::GetExcludedVariables(numExcludedVariables);
+		return CheckLayout(GeneratedStruct::GetBlockName(), sizeof(GeneratedStruct), members, numMembers, excludedVariables, numExcludedVariables, _blockInfo);
+	}
+}
@@ -0,0 +1,162 @@
+#include "shadervariantset.hpp"
+
+namespace gl
+{
+	ShaderVariantSet::ShaderVariantSet(const std::string& _name, std::initializer_list<StageFile> _stageFiles, std::initializer_list<std::string> _featureDefines, const std::string& _commonPrefixCode) :
+		m_name(_name),
+		m_features(_featureDefines),
+		m_commonPrefixCode(_commonPrefixCode)
+	{
+		GLHELPER_ASSERT(m_features.size() <= s_maxNumFeatures, "ShaderVariantSet \"" + m_name + "\" has more than " + std::to_string(s_maxNumFeatures) + " features!");
+
+		for (const StageFile& stageFile : _stageFiles)
+		{
+			GLHELPER_ASSERT(std::none_of(m_stages.begin(), m_stages.end(), [&](const Stage& stage) { return stage.type == stageFile.type; }),
+							"ShaderVariantSet \"" + m_name + "\" has multiple files for the same shader stage!");
+
+			Stage stage;
+			stage.type = stageFile.type;
+			stage.filename = stageFile.filename;
+			m_stages.push_back(stage);
+		}
+
+		for (unsigned int i = 0; i < m_features.size(); ++i)
+			m_featureIndices.emplace(m_features[i], i);
+	}
+
+	ShaderVariantSet::~ShaderVariantSet()
+	{
+	}
+
+	ShaderVariantSet::VariantKey ShaderVariantSet::GetVariantKey(std::initializer_list<std::string> _activeFeatures) const
+	{
+		VariantKey key = 0;
+		for (const std::string& feature : _activeFeatures)
+		{
+			auto it = m_featureIndices.find(feature);
+			if (it == m_featureIndices.end())
+				GLHELPER_LOG_ERROR("ShaderVariantSet \"" + m_name + "\" has no feature \"" + feature + "\"!");
+			else
+				key |= VariantKey(1) << it->second;
+		}
+		return key;
+	}
+
+	ShaderObject* ShaderVariantSet::GetVariant(VariantKey _key)
+	{
+		auto it = m_variants.find(_key);
+		if (it != m_variants.end())
+			return it->second.valid ? it->second.shaderObject.get() : nullptr;
+
+		GLHELPER_ASSERT(m_features.size() == s_maxNumFeatures || (_key >> m_features.size()) == 0, "Variant key contains bits that do not correspond to any feature!");
+
+		// Name the variant by its active features.
+		std::string variantName = m_name + "[";
+		for (unsigned int i = 0; i < m_features.size(); ++i)
+		{
+			if (_key & (VariantKey(1) << i))
+			{
+				if (variantName.back() != '[')
+					variantName += ",";
+				variantName += m_features[i];
+			}
+		}
+		variantName += "]";
+
+		Variant& variant = m_variants[_key];
+		variant.shaderObject.reset(new ShaderObject(variantName));
+		variant.valid = BuildVariant(*variant.shaderObject, _key) == Result::SUCCEEDED;
+
+		return variant.valid ? variant.shaderObject.get() : nullptr;
+	}
+
+	Result ShaderVariantSet::ReloadShaderFile(const std::string& _changedShaderFile)
+	{
+		auto fileIt = m_filesPerShaderType.find(_changedShaderFile);
+		if (fileIt == m_filesPerShaderType.end())
+			return Result::SUCCEEDED;
+
+		for (Stage& stage : m_stages)
+		{
+			if (stage.type == fileIt->second)
+				stage.preprocessedSource.clear();
+		}
+
+		Result result = Result::SUCCEEDED;
+		for (auto& variant : m_variants)
+		{
+			// Keep the old program of valid variants if the reload fails.
+			bool valid = BuildVariant(*variant.second.shaderObject, variant.first) == Result::SUCCEEDED;
+			variant.second.valid |= valid;
+			if (!valid)
+				result = Result::FAILURE;
+		}
+		return result;
+	}
+
+	Result ShaderVariantSet::EnsurePreprocessedSource(unsigned int _stageIndex)
+	{
+		Stage& stage = m_stages[_stageIndex];
+		if (!stage.preprocessedSource.empty())
+			return Result::SUCCEEDED;
+
+		std::unordered_set<std::string> includingFiles, allFiles;
+		stage.preprocessedSource = ShaderObject::ReadShaderFromFile(stage.filename, "", 0, includingFiles, allFiles);
+		if (stage.preprocessedSource.empty())
+			return Result::FAILURE;
+
+		// remove old associated files
+		for (auto it = m_filesPerShaderType.begin(); it != m_filesPerShaderType.end();)
+		{
+			if (it->second == stage.type)
+				it = m_filesPerShaderType.erase(it);
+			else
+				++it;
+		}
+		for (const std::string& file : allFiles)
+			m_filesPerShaderType.emplace(file, stage.type);
+
+		return Result::SUCCEEDED;
+	}
+
+	Result ShaderVariantSet::BuildVariant(ShaderObject& _shaderObject, VariantKey _key)
+	{
+		std::string prefixCode = GetVariantPrefixCode(_key);
+
+		for (unsigned int stageIndex = 0; stageIndex < m_stages.size(); ++stageIndex)
+		{
+			if (EnsurePreprocessedSource(stageIndex) == Result::FAILURE)
+				return Result::FAILURE;
+
+			const Stage& stage = m_stages[stageIndex];
+			std::string sourceCode = stage.preprocessedSource;
+			size_t versionPos = sourceCode.find("#version");
+			if (versionPos == std::string::npos)
+			{
+				GLHELPER_LOG_ERROR("ShaderVariantSet \"" + m_name + "\": Shader file " + stage.filename + " has no #version tag. Unable to insert variant defines.");
+				return Result::FAILURE;
+			}
+			ShaderObject::InsertPrefixCode(sourceCode, versionPos, prefixCode, ShaderObject::s_prefixCodeFileIndex, 0);
+
+			if (_shaderObject.AddShader(stage.type, sourceCode, stage.filename, prefixCode) == Result::FAILURE)
+				return Result::FAILURE;
+		}
+
+		return _shaderObject.CreateProgram();
+	}
+
+	std::string ShaderVariantSet::GetVariantPrefixCode(VariantKey _key) const
+	{
+		std::string prefixCode = m_commonPrefixCode;
+		for (unsigned int i = 0; i < m_features.size(); ++i)
+		{
+			if (_key & (VariantKey(1) << i))
+			{
+				if (!prefixCode.empty() && prefixCode.back() != '\n')
+					prefixCode += "\n";
+				prefixCode += "#define " + m_features[i];
+			}
+		}
+		return prefixCode;
+	}
+}
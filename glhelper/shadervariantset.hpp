@@ -0,0 +1,126 @@
+#pragma once
+
+#include "shaderobject.hpp"
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <initializer_list>
+#include <cstdint>
+
+namespace gl
+{
+	/// Set of shader permutations that share the same shader files but differ in a list of feature #defines.
+	///
+	/// Each feature is a single #define that is either present or absent, a variant is identified by a bitmask of its active features.
+	/// Variants are compiled lazily on their first request, so only permutations that are actually used cost any compile time.
+	/// Shader files are read and their #includes resolved only once per stage. All variants share this preprocessed text and only differ in the inserted #defines.
+	class ShaderVariantSet
+	{
+	public:
+		ShaderVariantSet(const ShaderVariantSet&) = delete;
+		void operator = (const ShaderVariantSet&) = delete;
+
+		/// Bitmask of active features. Bit i corresponds to the i-th feature given on construction.
+		typedef std::uint64_t VariantKey;
+
+		/// Maximum number of features per variant set, limited by the bit count of VariantKey.
+		static const unsigned int s_maxNumFeatures = sizeof(VariantKey) * 8;
+
+		/// Shader file for a single stage.
+		struct StageFile
+		{
+			StageFile(ShaderObject::ShaderType _type, const std::string& _filename) : type(_type), filename(_filename) {}
+
+			ShaderObject::ShaderType type;
+			std::string filename;
+		};
+
+		/// Creates a variant set. Does not read or compile anything yet.
+		///
+		/// \param _name
+		///		Name mainly used for debugging and identification. Variant names are derived from it.
+		/// \param _stageFiles
+		///		Shader file per stage. Each stage may only occur once.
+		/// \param _featureDefines
+		///		Names of all #defines that can be toggled. At most s_maxNumFeatures.
+		/// \param _commonPrefixCode
+		///		Code inserted after the version tag in every variant, before the feature #defines.
+		ShaderVariantSet(const std::string& _name, std::initializer_list<StageFile> _stageFiles, std::initializer_list<std::string> _featureDefines, const std::string& _commonPrefixCode = "");
+		~ShaderVariantSet();
+
+		const std::string& GetName() const { return m_name; }
+
+		/// Returns the list of all features in bit order.
+		const std::vector<std::string>& GetFeatures() const { return m_features; }
+
+		/// Computes the variant key for a set of active feature names.
+		///
+		/// Unknown feature names are reported as error and ignored.
+		/// \remarks Performs a hash lookup for each name. Consider to compute keys once and store them.
+		VariantKey GetVariantKey(std::initializer_list<std::string> _activeFeatures) const;
+
+		/// Returns the variant for a given feature bitmask. Compiles and links it if it was not requested before.
+		///
+		/// \return
+		///		nullptr if the variant failed to compile or link. Failures are memorized, there will be no further attempt until a reload.
+		ShaderObject* GetVariant(VariantKey _key);
+
+		/// \copydoc GetVariant
+		ShaderObject* GetVariant(std::initializer_list<std::string> _activeFeatures) { return GetVariant(GetVariantKey(_activeFeatures)); }
+
+		/// Returns the number of variants that were requested so far (including failed ones).
+		size_t GetNumRequestedVariants() const { return m_variants.size(); }
+
+		/// Call this function for hot reloading of a shader.
+		///
+		/// If the given file is used by any stage, this stage's preprocessed source is read again and all already requested variants are recompiled.
+		/// If the given filename is not recognized, nothing will happen.
+		Result ReloadShaderFile(const std::string& _changedShaderFile);
+
+		/// Gets a list of all associated shader files (including resolved includes) and their usage.
+		/// Empty for stages that were not read yet.
+		const std::unordered_map<std::string, ShaderObject::ShaderType>& GetShaderFilenames() const { return m_filesPerShaderType; }
+
+	private:
+		/// Reads and preprocesses the stage's file if not already done.
+		Result EnsurePreprocessedSource(unsigned int _stageIndex);
+
+		/// Adds all stages with the given key's defines to _shaderObject and links it.
+		Result BuildVariant(ShaderObject& _shaderObject, VariantKey _key);
+
+		/// Builds the prefix code for a given key.
+		std::string GetVariantPrefixCode(VariantKey _key) const;
+
+
+		/// Name for identifying at runtime
+		const std::string m_name;
+
+		struct Stage
+		{
+			ShaderObject::ShaderType type;
+			std::string filename;
+
+			/// Source with all includes resolved, but without any prefix code. Empty if not read yet.
+			std::string preprocessedSource;
+		};
+		std::vector<Stage> m_stages;
+
+		std::vector<std::string> m_features;
+		std::unordered_map<std::string, unsigned int> m_featureIndices;
+		const std::string m_commonPrefixCode;
+
+		struct Variant
+		{
+			std::unique_ptr<ShaderObject> shaderObject;
+			/// False if the last build of this variant failed.
+			bool valid;
+		};
+		/// All requested variants, including those that failed to build.
+		std::unordered_map<VariantKey, Variant> m_variants;
+
+		/// list of relevant files - if any of these changes a reload can be triggered via ReloadShaderFile.
+		std::unordered_map<std::string, ShaderObject::ShaderType> m_filesPerShaderType;
+	};
+}
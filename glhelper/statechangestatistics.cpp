@@ -0,0 +1,74 @@
+#include "statechangestatistics.hpp"
+
+#ifdef STATE_CHANGE_STATISTICS
+
+#include "context.hpp"
+
+namespace gl
+{
+	StateChangeStatistics::StateChangeStatistics()
+	{
+		for (unsigned int i = 0; i < static_cast<unsigned int>(StateChangeCategory::NUM_CATEGORIES); ++i)
+		{
+			numRequested[i] = 0;
+			numIssued[i] = 0;
+		}
+	}
+
+	const char* StateChangeStatistics::GetCategoryName(StateChangeCategory _category)
+	{
+		static const char* names[] =
+		{
+			"VertexBuffer",
+			"IndexBuffer",
+			"UniformBuffer",
+			"ShaderStorageBuffer",
+			"AtomicCounterBuffer",
+			"IndirectDrawBuffer",
+			"IndirectDispatchBuffer",
+			"PixelUnpackBuffer",
+			"Texture",
+			"Sampler",
+			"VertexArray",
+			"Framebuffer",
+			"ShaderObject",
+			"ProgramPipeline",
+			"Cap",
+			"DepthWrite",
+			"DepthFunc",
+			"StencilFunc",
+			"StencilOp",
+			"StencilWriteMask",
+			"BlendFunc",
+			"BlendEquation",
+			"ColorMask",
+			"BlendColor",
+			"Viewport",
+			"Scissor",
+			"DepthRange",
+			"PipelineState",
+		};
+		static_assert(sizeof(names) / sizeof(names[0]) == static_cast<unsigned int>(StateChangeCategory::NUM_CATEGORIES), "Category name list needs to be adapted.");
+
+		return names[static_cast<unsigned int>(_category)];
+	}
+
+	const StateChangeStatistics& GetStateChangeStatistics()
+	{
+		return Context::GetCurrent().stateChangeStatistics;
+	}
+
+	void ResetStateChangeStatistics()
+	{
+		Context::GetCurrent().stateChangeStatistics = StateChangeStatistics();
+	}
+
+	StateChangeStatistics TakeStateChangeStatistics()
+	{
+		StateChangeStatistics statistics = Context::GetCurrent().stateChangeStatistics;
+		ResetStateChangeStatistics();
+		return statistics;
+	}
+}
+
+#endif
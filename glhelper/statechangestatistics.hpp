@@ -0,0 +1,95 @@
+#pragma once
+
+#include "gl.hpp"
+
+#ifdef STATE_CHANGE_STATISTICS
+
+#include <cstdint>
+
+namespace gl
+{
+	/// Groups of redundancy checked entry points.
+	enum class StateChangeCategory
+	{
+		VERTEX_BUFFER,				///< Buffer::BindVertexBuffer
+		INDEX_BUFFER,				///< Buffer::BindIndexBuffer
+		UNIFORM_BUFFER,				///< Buffer::BindUniformBuffer
+		SHADER_STORAGE_BUFFER,		///< Buffer::BindShaderStorageBuffer
+		ATOMIC_COUNTER_BUFFER,		///< Buffer::BindAtomicCounterBuffer
+		INDIRECT_DRAW_BUFFER,		///< Buffer::BindIndirectDrawBuffer
+		INDIRECT_DISPATCH_BUFFER,	///< Buffer::BindIndirectDispatchBuffer
+		PIXEL_UNPACK_BUFFER,		///< Buffer::BindPixelUnpackBuffer, Buffer::UnbindPixelUnpackBuffer
+		TEXTURE,					///< Texture::Bind
+		SAMPLER,					///< SamplerObject::BindSampler
+		VERTEX_ARRAY,				///< VertexArrayObject::Bind
+		FRAMEBUFFER,				///< FramebufferObject::Bind, FramebufferObject::BindBackBuffer
+		SHADER_OBJECT,				///< ShaderObject::Activate
+		PROGRAM_PIPELINE,			///< ProgramPipeline::Bind
+		CAP,						///< Enable, Disable (with and without index)
+		DEPTH_WRITE,				///< SetDepthWrite
+		DEPTH_FUNC,					///< SetDepthFunc
+		STENCIL_FUNC,				///< SetStencilFunc
+		STENCIL_OP,					///< SetStencilOp
+		STENCIL_WRITE_MASK,			///< SetStencilWriteMask
+		BLEND_FUNC,					///< SetBlendFuncSeparate, SetBlendFunc (with and without draw buffer)
+		BLEND_EQUATION,				///< SetBlendEquationSeparate, SetBlendEquation (with and without draw buffer)
+		COLOR_MASK,					///< SetColorMask (with and without draw buffer)
+		BLEND_COLOR,				///< SetBlendColor
+		VIEWPORT,					///< SetViewport requests, glViewportArrayv calls of FlushViewportState issues
+		SCISSOR,					///< SetScissor requests, glScissorArrayv calls of FlushViewportState issues
+		DEPTH_RANGE,				///< SetDepthRange requests, glDepthRangeArrayv calls of FlushViewportState issues
+		PIPELINE_STATE,				///< ApplyPipelineState, issued if the state differs from the last applied one
+
+		NUM_CATEGORIES
+	};
+
+	/// Number of requested and actually issued calls per category.
+	///
+	/// Counted per gl::Context. Only available if STATE_CHANGE_STATISTICS is defined, otherwise all counters compile to nothing.
+	/// Typical usage is to take a snapshot with TakeStateChangeStatistics once per frame.
+	struct StateChangeStatistics
+	{
+		StateChangeStatistics();
+
+		/// Returns a readable name for a category.
+		static const char* GetCategoryName(StateChangeCategory _category);
+
+		std::uint64_t GetNumRequested(StateChangeCategory _category) const { return numRequested[static_cast<unsigned int>(_category)]; }
+		std::uint64_t GetNumIssued(StateChangeCategory _category) const { return numIssued[static_cast<unsigned int>(_category)]; }
+		/// Number of calls that were skipped because they would not have changed anything.
+		std::uint64_t GetNumFiltered(StateChangeCategory _category) const { return GetNumRequested(_category) - GetNumIssued(_category); }
+
+		std::uint64_t numRequested[static_cast<unsigned int>(StateChangeCategory::NUM_CATEGORIES)];
+		std::uint64_t numIssued[static_cast<unsigned int>(StateChangeCategory::NUM_CATEGORIES)];
+	};
+
+	/// Returns the statistics of the current context since the last reset.
+	const StateChangeStatistics& GetStateChangeStatistics();
+
+	/// Clears the statistics of the current context.
+	void ResetStateChangeStatistics();
+
+	/// Returns the statistics of the current context and clears them. Meant to be called once per frame.
+	StateChangeStatistics TakeStateChangeStatistics();
+
+	namespace Details
+	{
+		/// Returns the statistics of the gl::Context that is current on the calling thread. Defined in context.hpp
+		inline StateChangeStatistics& GetCurrentStateChangeStatistics();
+	}
+}
+
+/// Counts a call of a redundancy checked entry point.
+#define GLHELPER_COUNT_STATE_CHANGE_REQUEST(category) \
+	++::gl::Details::GetCurrentStateChangeStatistics().numRequested[static_cast<unsigned int>(::gl::StateChangeCategory::category)]
+
+/// Counts a call that was passed on to OpenGL.
+#define GLHELPER_COUNT_STATE_CHANGE_ISSUE(category) \
+	++::gl::Details::GetCurrentStateChangeStatistics().numIssued[static_cast<unsigned int>(::gl::StateChangeCategory::category)]
+
+#else
+
+#define GLHELPER_COUNT_STATE_CHANGE_REQUEST(category) do { } while(false)
+#define GLHELPER_COUNT_STATE_CHANGE_ISSUE(category) do { } while(false)
+
+#endif
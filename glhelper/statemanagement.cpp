@@ -1,4 +1,7 @@
 #include "statemanagement.hpp"
+#include "utils/flagoperators.hpp"
+
+#include <algorithm>
 
 namespace gl
 {
@@ -8,9 +11,12 @@ namespace gl
 		GLenum CapStateToGLCap[static_cast<unsigned int>(Cap::NUM_CAPS)] = {
 			GL_BLEND, GL_CLIP_DISTANCE0, GL_CLIP_DISTANCE1, GL_CLIP_DISTANCE2, GL_CLIP_DISTANCE3, GL_CLIP_DISTANCE4, GL_CLIP_DISTANCE5, GL_COLOR_LOGIC_OP, GL_CULL_FACE, GL_DEBUG_OUTPUT, GL_DEBUG_OUTPUT_SYNCHRONOUS, GL_DEPTH_CLAMP, GL_DEPTH_TEST, GL_DITHER, GL_FRAMEBUFFER_SRGB, GL_LINE_SMOOTH, GL_MULTISAMPLE, GL_POLYGON_OFFSET_FILL, GL_POLYGON_OFFSET_LINE, GL_POLYGON_OFFSET_POINT, GL_POLYGON_SMOOTH, GL_PRIMITIVE_RESTART, GL_PRIMITIVE_RESTART_FIXED_INDEX, GL_RASTERIZER_DISCARD, GL_SAMPLE_ALPHA_TO_COVERAGE, GL_SAMPLE_ALPHA_TO_ONE, GL_SAMPLE_COVERAGE, GL_SAMPLE_SHADING, GL_SAMPLE_MASK, GL_SCISSOR_TEST, GL_STENCIL_TEST, GL_TEXTURE_CUBE_MAP_SEAMLESS, GL_PROGRAM_POINT_SIZE,
 		};
+	}
 
+	namespace
+	{
 		// Initial states according to http://docs.gl/gl4/glEnable
-		CapState CapStates[static_cast<unsigned int>(Cap::NUM_CAPS)]
+		const CapState InitialCapStates[static_cast<unsigned int>(Cap::NUM_CAPS)] =
 		{
 			CapState::DISABLED, // BLEND
 			CapState::DISABLED, // CLIP_DISTANCE0
@@ -47,100 +53,531 @@ namespace gl
 			CapState::DISABLED, // PROGRAM_POINT_SIZE
 		};
 
-		CapState BlendStatePerViewPort[Details::MaxExpectedViewports];
-		CapState ScissorTestPerViewPort[Details::MaxExpectedDrawbuffers];
+		// Initial states according to http://docs.gl/gl4/glBlendFunc, http://docs.gl/gl4/glBlendEquation, http://docs.gl/gl4/glColorMask
+		const Details::DrawBufferBlendState InitialDrawBufferBlendState = { BlendFactor::ONE, BlendFactor::ZERO, BlendFactor::ONE, BlendFactor::ZERO, BlendEquation::ADD, BlendEquation::ADD, ColorMask::ALL, true, true, true };
 
-		void InitScissorBlendState()
+		// Initial states according to http://docs.gl/gl4/glStencilFunc, http://docs.gl/gl4/glStencilOp, http://docs.gl/gl4/glStencilMask
+		const Details::StencilFaceState InitialStencilFaceState = { DepthFunc::ALWAYS, 0, 0xFFFFFFFF, 0xFFFFFFFF, StencilOp::KEEP, StencilOp::KEEP, StencilOp::KEEP, true, true, true };
+	}
+
+	namespace Details
+	{
+		template<typename T, unsigned int N>
+		void IndexedViewportStateTable<T, N>::Init(const T(&_initialValue)[N])
 		{
-			for (unsigned int i = 0; i < Details::MaxExpectedViewports; ++i)
-				BlendStatePerViewPort[i] = CapState::DISABLED;
-			for (unsigned int i = 0; i < Details::MaxExpectedDrawbuffers; ++i)
-				ScissorTestPerViewPort[i] = CapState::DISABLED;
+			for (unsigned int i = 0; i < MaxExpectedViewports; ++i)
+			{
+				std::copy(_initialValue, _initialValue + N, values[i]);
+				known[i] = true;
+				dirty[i] = false;
+			}
+			dirtyBegin = MaxExpectedViewports;
+			dirtyEnd = 0;
 		}
-		struct InitScissorBlendStateOnStartup
-		{
-			InitScissorBlendStateOnStartup() { InitScissorBlendState(); }
-		} initScissorBlendStateOnStartup;
-
 
+		template<typename T, unsigned int N>
+		void IndexedViewportStateTable<T, N>::Set(GLuint _index, const T(&_value)[N], bool _force)
+		{
+			GLHELPER_ASSERT(_index < MaxExpectedViewports, "Viewport index exceeds expected maximum!");
+			if (!_force && known[_index] && std::equal(_value, _value + N, values[_index]))
+				return;
 
-		bool DepthWriteEnabled = false;
-		DepthFunc DepthComparisionFunc = DepthFunc::LESS;
-	}
+			std::copy(_value, _value + N, values[_index]);
+			dirty[_index] = true;
+			dirtyBegin = std::min(dirtyBegin, _index);
+			dirtyEnd = std::max(dirtyEnd, _index + 1);
+		}
 
-	void Enable(Cap _cap, GLuint _index, bool _force)
-	{
-		if (_cap == Cap::BLEND)
+		template<typename T, unsigned int N>
+		void IndexedViewportStateTable<T, N>::SetAll(const T(&_value)[N], bool _force)
 		{
-			GLHELPER_ASSERT(_index < Details::MaxExpectedViewports, "Enable index exceeds expected maximum!");
+			for (GLuint i = 0; i < MaxExpectedViewports; ++i)
+				Set(i, _value, _force);
+		}
 
-			if (_force || Details::CapStates[static_cast<unsigned int>(_cap)] == CapState::DISABLED ||
-				(Details::CapStates[static_cast<unsigned int>(_cap)] == CapState::UNKOWN && Details::BlendStatePerViewPort[_index] != CapState::ENABLED))
+		template<typename T, unsigned int N>
+		template<typename SetArrayFunc>
+		void IndexedViewportStateTable<T, N>::Flush(SetArrayFunc _setArray)
+		{
+			// Unknown indices that were not set must not be sent, their cached values may be stale.
+			// Everything else in between dirty indices can be sent along to save calls.
+			unsigned int runBegin = MaxExpectedViewports;
+			unsigned int runEnd = 0;
+			for (unsigned int i = dirtyBegin; i <= dirtyEnd; ++i)
 			{
-				GL_CALL(glEnablei, Details::CapStateToGLCap[static_cast<unsigned int>(_cap)], _index);
-				Details::CapStates[static_cast<unsigned int>(_cap)] = CapState::UNKOWN;
-				Details::BlendStatePerViewPort[_index] = CapState::ENABLED;
+				if (i < dirtyEnd && (dirty[i] || known[i]))
+				{
+					if (dirty[i])
+					{
+						runBegin = std::min(runBegin, i);
+						runEnd = i + 1;
+						dirty[i] = false;
+						known[i] = true;
+					}
+					continue;
+				}
+
+				if (runEnd > runBegin)
+					_setArray(runBegin, static_cast<GLsizei>(runEnd - runBegin), &values[runBegin][0]);
+				runBegin = MaxExpectedViewports;
+				runEnd = 0;
 			}
+
+			dirtyBegin = MaxExpectedViewports;
+			dirtyEnd = 0;
 		}
-		else if (_cap == Cap::SCISSOR_TEST)
-		{
-			GLHELPER_ASSERT(_index < Details::MaxExpectedDrawbuffers, "Enable index exceeds expected maximum!");
 
-			if (_force || Details::CapStates[static_cast<unsigned int>(_cap)] == CapState::DISABLED ||
-				(Details::CapStates[static_cast<unsigned int>(_cap)] == CapState::UNKOWN && Details::ScissorTestPerViewPort[_index] != CapState::ENABLED))
+		template<typename T, unsigned int N>
+		void IndexedViewportStateTable<T, N>::Reset()
+		{
+			for (unsigned int i = 0; i < MaxExpectedViewports; ++i)
 			{
-				GL_CALL(glEnablei, Details::CapStateToGLCap[static_cast<unsigned int>(_cap)], _index);
-				Details::CapStates[static_cast<unsigned int>(_cap)] = CapState::UNKOWN;
-				Details::ScissorTestPerViewPort[_index] = CapState::ENABLED;
+				known[i] = false;
+				dirty[i] = false;
 			}
+			dirtyBegin = MaxExpectedViewports;
+			dirtyEnd = 0;
 		}
-		else
+
+		StateTables::StateTables() :
+			depthWriteEnabled(true),
+			depthComparisionFunc(DepthFunc::LESS),
+			blendColorKnown(true)
 		{
-			Enable(_cap, _force);
+			std::copy(InitialCapStates, InitialCapStates + static_cast<unsigned int>(Cap::NUM_CAPS), capStates);
+			std::fill(blendStatePerDrawBuffer, blendStatePerDrawBuffer + MaxExpectedDrawbuffers, CapState::DISABLED);
+			std::fill(scissorTestPerViewPort, scissorTestPerViewPort + MaxExpectedViewports, CapState::DISABLED);
+
+			stencilStates[0] = InitialStencilFaceState;
+			stencilStates[1] = InitialStencilFaceState;
+
+			std::fill(drawBufferBlendStates, drawBufferBlendStates + MaxExpectedDrawbuffers, InitialDrawBufferBlendState);
+			std::fill(blendColor, blendColor + 4, 0.0f);
+
+			// Initial viewport and scissor box depend on the window size and are therefore unknown.
+			const GLfloat initialViewport[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			viewports.Init(initialViewport);
+			viewports.Reset();
+			const GLint initialScissorBox[4] = { 0, 0, 0, 0 };
+			scissorBoxes.Init(initialScissorBox);
+			scissorBoxes.Reset();
+			const GLdouble initialDepthRange[2] = { 0.0, 1.0 };
+			depthRanges.Init(initialDepthRange);
 		}
 	}
 
-	void Disable(Cap _cap, GLuint _index, bool _force)
+	namespace
 	{
-		if (_cap == Cap::BLEND)
+		/// Returns the per index table of an indexed cap, nullptr for caps without index.
+		CapState* GetIndexedCapStates(Cap _cap)
 		{
-			GLHELPER_ASSERT(_index < Details::MaxExpectedViewports, "Enable index exceeds expected maximum!");
+			if (_cap == Cap::BLEND)
+				return Details::GetStateTables().blendStatePerDrawBuffer;
+			else if (_cap == Cap::SCISSOR_TEST)
+				return Details::GetStateTables().scissorTestPerViewPort;
+			return nullptr;
+		}
 
-			if (_force || Details::CapStates[static_cast<unsigned int>(_cap)] == CapState::ENABLED ||
-				(Details::CapStates[static_cast<unsigned int>(_cap)] == CapState::UNKOWN && Details::BlendStatePerViewPort[_index] != CapState::DISABLED))
-			{
-				GL_CALL(glDisablei, Details::CapStateToGLCap[static_cast<unsigned int>(_cap)], _index);
-				Details::CapStates[static_cast<unsigned int>(_cap)] = CapState::UNKOWN;
-				Details::BlendStatePerViewPort[_index] = CapState::ENABLED;
-			}
+		unsigned int GetNumIndexedCapStates(Cap _cap)
+		{
+			return _cap == Cap::BLEND ? Details::MaxExpectedDrawbuffers : Details::MaxExpectedViewports;
 		}
-		else if (_cap == Cap::SCISSOR_TEST)
+
+		void SetIndexed(Cap _cap, GLuint _index, CapState _newState, bool _force)
 		{
-			GLHELPER_ASSERT(_index < Details::MaxExpectedDrawbuffers, "Enable index exceeds expected maximum!");
+			GLHELPER_ASSERT(_index < GetNumIndexedCapStates(_cap), "Draw buffer/viewport index exceeds expected maximum!");
 
-			if (_force || Details::CapStates[static_cast<unsigned int>(_cap)] == CapState::ENABLED ||
-				(Details::CapStates[static_cast<unsigned int>(_cap)] == CapState::UNKOWN && Details::ScissorTestPerViewPort[_index] != CapState::DISABLED))
-			{
+			GLHELPER_COUNT_STATE_CHANGE_REQUEST(CAP);
+			CapState* indexedStates = GetIndexedCapStates(_cap);
+			CapState& capState = Details::GetStateTables().capStates[static_cast<unsigned int>(_cap)];
+
+			if (!_force && (capState == _newState || (capState == CapState::UNKOWN && indexedStates[_index] == _newState)))
+				return;
+
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(CAP);
+
+			if (_newState == CapState::ENABLED)
+				GL_CALL(glEnablei, Details::CapStateToGLCap[static_cast<unsigned int>(_cap)], _index);
+			else
 				GL_CALL(glDisablei, Details::CapStateToGLCap[static_cast<unsigned int>(_cap)], _index);
-				Details::CapStates[static_cast<unsigned int>(_cap)] = CapState::UNKOWN;
-				Details::ScissorTestPerViewPort[_index] = CapState::DISABLED;
+
+			// A known non-indexed state applies to all indices.
+			if (capState != CapState::UNKOWN)
+			{
+				for (unsigned int i = 0; i < GetNumIndexedCapStates(_cap); ++i)
+					indexedStates[i] = capState;
+				capState = CapState::UNKOWN;
 			}
+			indexedStates[_index] = _newState;
 		}
+	}
+
+	void Enable(Cap _cap, GLuint _index, bool _force)
+	{
+		if (GetIndexedCapStates(_cap))
+			SetIndexed(_cap, _index, CapState::ENABLED, _force);
 		else
-		{
 			Enable(_cap, _force);
-		}
+	}
+
+	void Disable(Cap _cap, GLuint _index, bool _force)
+	{
+		if (GetIndexedCapStates(_cap))
+			SetIndexed(_cap, _index, CapState::DISABLED, _force);
+		else
+			Disable(_cap, _force);
 	}
 
 	void ResetBooleanCapStateTable_Get()
 	{
+		Details::StateTables& stateTables = Details::GetStateTables();
 		for (unsigned int i = 0; i < static_cast<unsigned int>(Cap::NUM_CAPS); ++i)
-			Details::CapStates[i] = glIsEnabled(Details::CapStateToGLCap[i]) == GL_TRUE ? CapState::ENABLED : CapState::DISABLED;
+			stateTables.capStates[i] = glIsEnabled(Details::CapStateToGLCap[i]) == GL_TRUE ? CapState::ENABLED : CapState::DISABLED;
 	}
 
 	void ResetBooleanCapStateTable_Unkown()
 	{
+		Details::StateTables& stateTables = Details::GetStateTables();
 		for (unsigned int i = 0; i < static_cast<unsigned int>(Cap::NUM_CAPS); ++i)
-			Details::CapStates[i] = CapState::UNKOWN;
+			stateTables.capStates[i] = CapState::UNKOWN;
+		for (unsigned int i = 0; i < Details::MaxExpectedDrawbuffers; ++i)
+			stateTables.blendStatePerDrawBuffer[i] = CapState::UNKOWN;
+		for (unsigned int i = 0; i < Details::MaxExpectedViewports; ++i)
+			stateTables.scissorTestPerViewPort[i] = CapState::UNKOWN;
+	}
+
+	void SetBlendFuncSeparate(GLuint _drawBuffer, BlendFactor _srcRGB, BlendFactor _dstRGB, BlendFactor _srcAlpha, BlendFactor _dstAlpha, bool _force)
+	{
+		GLHELPER_ASSERT(_drawBuffer < Details::MaxExpectedDrawbuffers, "Draw buffer index exceeds expected maximum!");
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(BLEND_FUNC);
+		Details::DrawBufferBlendState& state = Details::GetStateTables().drawBufferBlendStates[_drawBuffer];
+		if (_force || !state.blendFuncKnown || state.srcRGB != _srcRGB || state.dstRGB != _dstRGB || state.srcAlpha != _srcAlpha || state.dstAlpha != _dstAlpha)
+		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(BLEND_FUNC);
+			GL_CALL(glBlendFuncSeparatei, _drawBuffer, static_cast<GLenum>(_srcRGB), static_cast<GLenum>(_dstRGB), static_cast<GLenum>(_srcAlpha), static_cast<GLenum>(_dstAlpha));
+			state.srcRGB = _srcRGB;
+			state.dstRGB = _dstRGB;
+			state.srcAlpha = _srcAlpha;
+			state.dstAlpha = _dstAlpha;
+			state.blendFuncKnown = true;
+		}
+	}
+
+	void SetBlendFuncSeparate(BlendFactor _srcRGB, BlendFactor _dstRGB, BlendFactor _srcAlpha, BlendFactor _dstAlpha, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(BLEND_FUNC);
+		Details::StateTables& stateTables = Details::GetStateTables();
+		if (!_force)
+		{
+			bool allEqual = true;
+			for (const Details::DrawBufferBlendState& state : stateTables.drawBufferBlendStates)
+				allEqual &= state.blendFuncKnown && state.srcRGB == _srcRGB && state.dstRGB == _dstRGB && state.srcAlpha == _srcAlpha && state.dstAlpha == _dstAlpha;
+			if (allEqual)
+				return;
+		}
+
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(BLEND_FUNC);
+		GL_CALL(glBlendFuncSeparate, static_cast<GLenum>(_srcRGB), static_cast<GLenum>(_dstRGB), static_cast<GLenum>(_srcAlpha), static_cast<GLenum>(_dstAlpha));
+		for (Details::DrawBufferBlendState& state : stateTables.drawBufferBlendStates)
+		{
+			state.srcRGB = _srcRGB;
+			state.dstRGB = _dstRGB;
+			state.srcAlpha = _srcAlpha;
+			state.dstAlpha = _dstAlpha;
+			state.blendFuncKnown = true;
+		}
+	}
+
+	void SetBlendEquationSeparate(GLuint _drawBuffer, BlendEquation _equationRGB, BlendEquation _equationAlpha, bool _force)
+	{
+		GLHELPER_ASSERT(_drawBuffer < Details::MaxExpectedDrawbuffers, "Draw buffer index exceeds expected maximum!");
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(BLEND_EQUATION);
+		Details::DrawBufferBlendState& state = Details::GetStateTables().drawBufferBlendStates[_drawBuffer];
+		if (_force || !state.blendEquationKnown || state.equationRGB != _equationRGB || state.equationAlpha != _equationAlpha)
+		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(BLEND_EQUATION);
+			GL_CALL(glBlendEquationSeparatei, _drawBuffer, static_cast<GLenum>(_equationRGB), static_cast<GLenum>(_equationAlpha));
+			state.equationRGB = _equationRGB;
+			state.equationAlpha = _equationAlpha;
+			state.blendEquationKnown = true;
+		}
+	}
+
+	void SetBlendEquationSeparate(BlendEquation _equationRGB, BlendEquation _equationAlpha, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(BLEND_EQUATION);
+		Details::StateTables& stateTables = Details::GetStateTables();
+		if (!_force)
+		{
+			bool allEqual = true;
+			for (const Details::DrawBufferBlendState& state : stateTables.drawBufferBlendStates)
+				allEqual &= state.blendEquationKnown && state.equationRGB == _equationRGB && state.equationAlpha == _equationAlpha;
+			if (allEqual)
+				return;
+		}
+
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(BLEND_EQUATION);
+		GL_CALL(glBlendEquationSeparate, static_cast<GLenum>(_equationRGB), static_cast<GLenum>(_equationAlpha));
+		for (Details::DrawBufferBlendState& state : stateTables.drawBufferBlendStates)
+		{
+			state.equationRGB = _equationRGB;
+			state.equationAlpha = _equationAlpha;
+			state.blendEquationKnown = true;
+		}
+	}
+
+	void SetColorMask(GLuint _drawBuffer, ColorMask _colorMask, bool _force)
+	{
+		GLHELPER_ASSERT(_drawBuffer < Details::MaxExpectedDrawbuffers, "Draw buffer index exceeds expected maximum!");
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(COLOR_MASK);
+		Details::DrawBufferBlendState& state = Details::GetStateTables().drawBufferBlendStates[_drawBuffer];
+		if (_force || !state.colorMaskKnown || state.colorMask != _colorMask)
+		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(COLOR_MASK);
+			GL_CALL(glColorMaski, _drawBuffer, any(_colorMask & ColorMask::RED) ? GL_TRUE : GL_FALSE, any(_colorMask & ColorMask::GREEN) ? GL_TRUE : GL_FALSE,
+											any(_colorMask & ColorMask::BLUE) ? GL_TRUE : GL_FALSE, any(_colorMask & ColorMask::ALPHA) ? GL_TRUE : GL_FALSE);
+			state.colorMask = _colorMask;
+			state.colorMaskKnown = true;
+		}
+	}
+
+	void SetColorMask(ColorMask _colorMask, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(COLOR_MASK);
+		Details::StateTables& stateTables = Details::GetStateTables();
+		if (!_force)
+		{
+			bool allEqual = true;
+			for (const Details::DrawBufferBlendState& state : stateTables.drawBufferBlendStates)
+				allEqual &= state.colorMaskKnown && state.colorMask == _colorMask;
+			if (allEqual)
+				return;
+		}
+
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(COLOR_MASK);
+		GL_CALL(glColorMask, any(_colorMask & ColorMask::RED) ? GL_TRUE : GL_FALSE, any(_colorMask & ColorMask::GREEN) ? GL_TRUE : GL_FALSE,
+							any(_colorMask & ColorMask::BLUE) ? GL_TRUE : GL_FALSE, any(_colorMask & ColorMask::ALPHA) ? GL_TRUE : GL_FALSE);
+		for (Details::DrawBufferBlendState& state : stateTables.drawBufferBlendStates)
+		{
+			state.colorMask = _colorMask;
+			state.colorMaskKnown = true;
+		}
+	}
+
+	void SetBlendColor(float _red, float _green, float _blue, float _alpha, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(BLEND_COLOR);
+		Details::StateTables& stateTables = Details::GetStateTables();
+		if (_force || !stateTables.blendColorKnown || stateTables.blendColor[0] != _red || stateTables.blendColor[1] != _green || stateTables.blendColor[2] != _blue || stateTables.blendColor[3] != _alpha)
+		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(BLEND_COLOR);
+			GL_CALL(glBlendColor, _red, _green, _blue, _alpha);
+			stateTables.blendColor[0] = _red;
+			stateTables.blendColor[1] = _green;
+			stateTables.blendColor[2] = _blue;
+			stateTables.blendColor[3] = _alpha;
+			stateTables.blendColorKnown = true;
+		}
+	}
+
+	void ResetBlendStateTable_Unkown()
+	{
+		Details::StateTables& stateTables = Details::GetStateTables();
+		for (Details::DrawBufferBlendState& state : stateTables.drawBufferBlendStates)
+		{
+			state.blendFuncKnown = false;
+			state.blendEquationKnown = false;
+			state.colorMaskKnown = false;
+		}
+		stateTables.blendColorKnown = false;
+	}
+
+	namespace
+	{
+		/// Determines which faces need to be set, returns the GL face or GL_NONE if nothing is to be done.
+		template<typename DiffersFunction>
+		GLenum GetStencilFacesToSet(StencilFace _face, bool _force, const DiffersFunction& _differs)
+		{
+			Details::StateTables& stateTables = Details::GetStateTables();
+			bool setFront = (_face != StencilFace::BACK) && (_force || _differs(stateTables.stencilStates[0]));
+			bool setBack = (_face != StencilFace::FRONT) && (_force || _differs(stateTables.stencilStates[1]));
+
+			if (setFront && setBack)
+				return GL_FRONT_AND_BACK;
+			else if (setFront)
+				return GL_FRONT;
+			else if (setBack)
+				return GL_BACK;
+			return GL_NONE;
+		}
+
+		template<typename UpdateFunction>
+		void UpdateStencilStates(GLenum _glFace, const UpdateFunction& _update)
+		{
+			Details::StateTables& stateTables = Details::GetStateTables();
+			if (_glFace != GL_BACK)
+				_update(stateTables.stencilStates[0]);
+			if (_glFace != GL_FRONT)
+				_update(stateTables.stencilStates[1]);
+		}
+	}
+
+	void SetStencilFunc(StencilFace _face, DepthFunc _func, GLint _ref, GLuint _readMask, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(STENCIL_FUNC);
+		GLenum glFace = GetStencilFacesToSet(_face, _force, [=](const Details::StencilFaceState& _state) {
+			return !_state.funcKnown || _state.func != _func || _state.ref != _ref || _state.readMask != _readMask;
+		});
+		if (glFace == GL_NONE)
+			return;
+
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(STENCIL_FUNC);
+		GL_CALL(glStencilFuncSeparate, glFace, _func, _ref, _readMask);
+		UpdateStencilStates(glFace, [=](Details::StencilFaceState& _state) {
+			_state.func = _func;
+			_state.ref = _ref;
+			_state.readMask = _readMask;
+			_state.funcKnown = true;
+		});
+	}
+
+	void SetStencilOp(StencilFace _face, StencilOp _stencilFail, StencilOp _depthFail, StencilOp _depthPass, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(STENCIL_OP);
+		GLenum glFace = GetStencilFacesToSet(_face, _force, [=](const Details::StencilFaceState& _state) {
+			return !_state.opKnown || _state.stencilFail != _stencilFail || _state.depthFail != _depthFail || _state.depthPass != _depthPass;
+		});
+		if (glFace == GL_NONE)
+			return;
+
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(STENCIL_OP);
+		GL_CALL(glStencilOpSeparate, glFace, static_cast<GLenum>(_stencilFail), static_cast<GLenum>(_depthFail), static_cast<GLenum>(_depthPass));
+		UpdateStencilStates(glFace, [=](Details::StencilFaceState& _state) {
+			_state.stencilFail = _stencilFail;
+			_state.depthFail = _depthFail;
+			_state.depthPass = _depthPass;
+			_state.opKnown = true;
+		});
+	}
+
+	void SetStencilWriteMask(StencilFace _face, GLuint _writeMask, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(STENCIL_WRITE_MASK);
+		GLenum glFace = GetStencilFacesToSet(_face, _force, [=](const Details::StencilFaceState& _state) {
+			return !_state.writeMaskKnown || _state.writeMask != _writeMask;
+		});
+		if (glFace == GL_NONE)
+			return;
+
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(STENCIL_WRITE_MASK);
+		GL_CALL(glStencilMaskSeparate, glFace, _writeMask);
+		UpdateStencilStates(glFace, [=](Details::StencilFaceState& _state) {
+			_state.writeMask = _writeMask;
+			_state.writeMaskKnown = true;
+		});
+	}
+
+	void ResetStencilStateTable_Unkown()
+	{
+		for (Details::StencilFaceState& state : Details::GetStateTables().stencilStates)
+		{
+			state.funcKnown = false;
+			state.opKnown = false;
+			state.writeMaskKnown = false;
+		}
+	}
+
+	void SetViewport(GLuint _index, GLfloat _x, GLfloat _y, GLfloat _width, GLfloat _height, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(VIEWPORT);
+		const GLfloat viewport[4] = { _x, _y, _width, _height };
+		Details::GetStateTables().viewports.Set(_index, viewport, _force);
+	}
+
+	void SetViewport(GLfloat _x, GLfloat _y, GLfloat _width, GLfloat _height, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(VIEWPORT);
+		const GLfloat viewport[4] = { _x, _y, _width, _height };
+		Details::GetStateTables().viewports.SetAll(viewport, _force);
+	}
+
+	void SetScissor(GLuint _index, GLint _x, GLint _y, GLsizei _width, GLsizei _height, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(SCISSOR);
+		const GLint scissorBox[4] = { _x, _y, _width, _height };
+		Details::GetStateTables().scissorBoxes.Set(_index, scissorBox, _force);
+	}
+
+	void SetScissor(GLint _x, GLint _y, GLsizei _width, GLsizei _height, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(SCISSOR);
+		const GLint scissorBox[4] = { _x, _y, _width, _height };
+		Details::GetStateTables().scissorBoxes.SetAll(scissorBox, _force);
+	}
+
+	void SetDepthRange(GLuint _index, GLdouble _near, GLdouble _far, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(DEPTH_RANGE);
+		const GLdouble depthRange[2] = { _near, _far };
+		Details::GetStateTables().depthRanges.Set(_index, depthRange, _force);
+	}
+
+	void SetDepthRange(GLdouble _near, GLdouble _far, bool _force)
+	{
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(DEPTH_RANGE);
+		const GLdouble depthRange[2] = { _near, _far };
+		Details::GetStateTables().depthRanges.SetAll(depthRange, _force);
+	}
+
+	void FlushViewportState()
+	{
+		Details::StateTables& stateTables = Details::GetStateTables();
+		if (stateTables.viewports.IsDirty())
+		{
+			stateTables.viewports.Flush([](GLuint _first, GLsizei _count, const GLfloat* _values) {
+				GLHELPER_COUNT_STATE_CHANGE_ISSUE(VIEWPORT);
+				GL_CALL(glViewportArrayv, _first, _count, _values);
+			});
+		}
+		if (stateTables.scissorBoxes.IsDirty())
+		{
+			stateTables.scissorBoxes.Flush([](GLuint _first, GLsizei _count, const GLint* _values) {
+				GLHELPER_COUNT_STATE_CHANGE_ISSUE(SCISSOR);
+				GL_CALL(glScissorArrayv, _first, _count, _values);
+			});
+		}
+		if (stateTables.depthRanges.IsDirty())
+		{
+			stateTables.depthRanges.Flush([](GLuint _first, GLsizei _count, const GLdouble* _values) {
+				GLHELPER_COUNT_STATE_CHANGE_ISSUE(DEPTH_RANGE);
+				GL_CALL(glDepthRangeArrayv, _first, _count, _values);
+			});
+		}
+	}
+
+	const GLfloat* GetViewport(GLuint _index)
+	{
+		GLHELPER_ASSERT(_index < Details::MaxExpectedViewports, "Viewport index exceeds expected maximum!");
+		return Details::GetStateTables().viewports.values[_index];
+	}
+
+	const GLint* GetScissor(GLuint _index)
+	{
+		GLHELPER_ASSERT(_index < Details::MaxExpectedViewports, "Viewport index exceeds expected maximum!");
+		return Details::GetStateTables().scissorBoxes.values[_index];
+	}
+
+	const GLdouble* GetDepthRange(GLuint _index)
+	{
+		GLHELPER_ASSERT(_index < Details::MaxExpectedViewports, "Viewport index exceeds expected maximum!");
+		return Details::GetStateTables().depthRanges.values[_index];
+	}
+
+	void ResetViewportStateTable_Unkown()
+	{
+		Details::StateTables& stateTables = Details::GetStateTables();
+		stateTables.viewports.Reset();
+		stateTables.scissorBoxes.Reset();
+		stateTables.depthRanges.Reset();
 	}
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 ﻿#pragma once
 
 #include "gl.hpp"
+#include "statechangestatistics.hpp"
+#include <cstdint>
 
 /// \file statemanagement.hpp
 /// Contains wrapper for various global state operations.
@@ -95,10 +97,6 @@ namespace gl
 		/// http://delphigl.de/glcapsviewer/gl_stats_caps_single.php?listreportsbycap=GL_MAX_DRAW_BUFFERS
 		static const unsigned int MaxExpectedDrawbuffers = 8;
 
-		extern CapState BlendStatePerViewPort[MaxExpectedViewports];
-		extern CapState ScissorTestPerViewPort[MaxExpectedDrawbuffers];
-		extern CapState CapStates[static_cast<unsigned int>(Cap::NUM_CAPS)];
-
 		extern GLenum CapStateToGLCap[static_cast<unsigned int>(Cap::NUM_CAPS)];
 	};
 
@@ -129,7 +127,7 @@ namespace gl
 
 
 	/// Returns value of cap from internal state table.
-	inline CapState GetCapState(Cap _cap) { return Details::CapStates[static_cast<unsigned int>(_cap)]; }
+	inline CapState GetCapState(Cap _cap);
 
 
 	/// Resets the entire internal state table with result from glIsEnable on each state.
@@ -138,7 +136,7 @@ namespace gl
 	/// \see ResetBooleanStateTable_Unkown, Enable, Disable
 	void ResetBooleanCapStateTable_Get();
 
-	/// Resets the internal state table to Details::EnableState::UNKOWN
+	/// Resets the internal state table (including the indexed states of BLEND and SCISSOR_TEST) to Details::EnableState::UNKOWN
 	///
 	/// For states which are set to unknown, no redundant change check will be performed. After a call to Enable/Disable a state is no longer unknown.
 	/// \see ResetBooleanStateTable_Get, Enable, Disable
@@ -162,12 +160,6 @@ namespace gl
 		ALWAYS = GL_ALWAYS,		///< Always passes.
 	};
 
-	namespace Details
-	{
-		extern bool DepthWriteEnabled;
-		extern DepthFunc DepthComparisionFunc;
-	}
-
 	/// Enable or disable writing into the depth buffer. (glDepthMask)
 	///
 	/// Reading from depth buffer is a cap state, since it is set by glEnable
@@ -186,28 +178,311 @@ namespace gl
 	// Stencil
 	// --------------------------------------------------------------------------------------------------------------------------
 
-	// todo ...
+	// Stencil comparision functions use DepthFunc.
+
+	/// Possible actions for glStencilOp http://docs.gl/gl4/glStencilOp
+	enum class StencilOp
+	{
+		KEEP = GL_KEEP,				///< Keeps the current value.
+		ZERO = GL_ZERO,				///< Sets the stencil buffer value to 0.
+		REPLACE = GL_REPLACE,		///< Sets the stencil buffer value to ref, as specified by glStencilFunc.
+		INCR = GL_INCR,				///< Increments the current stencil buffer value. Clamps to the maximum representable unsigned value.
+		INCR_WRAP = GL_INCR_WRAP,	///< Increments the current stencil buffer value. Wraps stencil buffer value to zero when incrementing the maximum representable unsigned value.
+		DECR = GL_DECR,				///< Decrements the current stencil buffer value. Clamps to 0.
+		DECR_WRAP = GL_DECR_WRAP,	///< Decrements the current stencil buffer value. Wraps stencil buffer value to the maximum representable unsigned value when decrementing a stencil buffer value of zero.
+		INVERT = GL_INVERT,			///< Bitwise inverts the current stencil buffer value.
+	};
+
+	/// Faces for separate stencil state.
+	enum class StencilFace
+	{
+		FRONT = GL_FRONT,
+		BACK = GL_BACK,
+		FRONT_AND_BACK = GL_FRONT_AND_BACK,
+	};
+
+	namespace Details
+	{
+		/// Stencil state of a single face.
+		struct StencilFaceState
+		{
+			DepthFunc func;
+			GLint ref;
+			GLuint readMask;
+			GLuint writeMask;
+			StencilOp stencilFail;
+			StencilOp depthFail;
+			StencilOp depthPass;
+
+			/// False if the corresponding values are unknown, see ResetStencilStateTable_Unkown.
+			bool funcKnown;
+			bool opKnown;
+			bool writeMaskKnown;
+		};
+	}
+
+	/// Sets stencil test function, reference value and read mask. (glStencilFuncSeparate)
+	///
+	/// If FRONT_AND_BACK is given and only one face differs, only this face is set.
+	void SetStencilFunc(StencilFace _face, DepthFunc _func, GLint _ref, GLuint _readMask, bool _force = false);
+
+	/// Sets stencil actions. (glStencilOpSeparate)
+	///
+	/// If FRONT_AND_BACK is given and only one face differs, only this face is set.
+	/// \param _stencilFail
+	///		Action if the stencil test fails.
+	/// \param _depthFail
+	///		Action if the stencil test passes, but the depth test fails.
+	/// \param _depthPass
+	///		Action if both stencil and depth test pass (or depth test is disabled).
+	void SetStencilOp(StencilFace _face, StencilOp _stencilFail, StencilOp _depthFail, StencilOp _depthPass, bool _force = false);
+
+	/// Sets the stencil write mask. (glStencilMaskSeparate)
+	///
+	/// If FRONT_AND_BACK is given and only one face differs, only this face is set.
+	void SetStencilWriteMask(StencilFace _face, GLuint _writeMask, bool _force = false);
+
+	/// Gets stencil state of a face (FRONT or BACK) from the internal state table. Values may be outdated if marked as unknown.
+	inline const Details::StencilFaceState& GetStencilState(StencilFace _face);
+
+	/// Marks all stencil state as unknown.
+	///
+	/// For unknown states, no redundant change check will be performed. After the next call to the corresponding setter a state is no longer unknown.
+	void ResetStencilStateTable_Unkown();
 
 
 	// --------------------------------------------------------------------------------------------------------------------------
 	// Blending
 	// --------------------------------------------------------------------------------------------------------------------------
 
-	// todo ...
+	/// Possible blend factors for glBlendFunc http://docs.gl/gl4/glBlendFunc
+	enum class BlendFactor
+	{
+		ZERO = GL_ZERO,
+		ONE = GL_ONE,
+		SRC_COLOR = GL_SRC_COLOR,
+		ONE_MINUS_SRC_COLOR = GL_ONE_MINUS_SRC_COLOR,
+		DST_COLOR = GL_DST_COLOR,
+		ONE_MINUS_DST_COLOR = GL_ONE_MINUS_DST_COLOR,
+		SRC_ALPHA = GL_SRC_ALPHA,
+		ONE_MINUS_SRC_ALPHA = GL_ONE_MINUS_SRC_ALPHA,
+		DST_ALPHA = GL_DST_ALPHA,
+		ONE_MINUS_DST_ALPHA = GL_ONE_MINUS_DST_ALPHA,
+		CONSTANT_COLOR = GL_CONSTANT_COLOR,
+		ONE_MINUS_CONSTANT_COLOR = GL_ONE_MINUS_CONSTANT_COLOR,
+		CONSTANT_ALPHA = GL_CONSTANT_ALPHA,
+		ONE_MINUS_CONSTANT_ALPHA = GL_ONE_MINUS_CONSTANT_ALPHA,
+		SRC_ALPHA_SATURATE = GL_SRC_ALPHA_SATURATE,
+		SRC1_COLOR = GL_SRC1_COLOR,
+		ONE_MINUS_SRC1_COLOR = GL_ONE_MINUS_SRC1_COLOR,
+		SRC1_ALPHA = GL_SRC1_ALPHA,
+		ONE_MINUS_SRC1_ALPHA = GL_ONE_MINUS_SRC1_ALPHA,
+	};
+
+	/// Possible blend equations for glBlendEquation http://docs.gl/gl4/glBlendEquation
+	enum class BlendEquation
+	{
+		ADD = GL_FUNC_ADD,							///< Result = Src * SrcFactor + Dst * DstFactor
+		SUBTRACT = GL_FUNC_SUBTRACT,				///< Result = Src * SrcFactor - Dst * DstFactor
+		REVERSE_SUBTRACT = GL_FUNC_REVERSE_SUBTRACT,///< Result = Dst * DstFactor - Src * SrcFactor
+		MIN = GL_MIN,								///< Result = min(Src, Dst)
+		MAX = GL_MAX,								///< Result = max(Src, Dst)
+	};
+
+	/// Color channels for glColorMask http://docs.gl/gl4/glColorMask
+	///
+	/// Combine with the operators from utils/flagoperators.hpp.
+	enum class ColorMask : std::uint8_t
+	{
+		NONE = 0,
+		RED = 1,
+		GREEN = 2,
+		BLUE = 4,
+		ALPHA = 8,
+		ALL = RED | GREEN | BLUE | ALPHA
+	};
+
+	namespace Details
+	{
+		/// Blend state of a single draw buffer.
+		struct DrawBufferBlendState
+		{
+			BlendFactor srcRGB;
+			BlendFactor dstRGB;
+			BlendFactor srcAlpha;
+			BlendFactor dstAlpha;
+			BlendEquation equationRGB;
+			BlendEquation equationAlpha;
+			ColorMask colorMask;
+
+			/// False if the corresponding values are unknown, see ResetBlendStateTable_Unkown.
+			bool blendFuncKnown;
+			bool blendEquationKnown;
+			bool colorMaskKnown;
+		};
+	}
+
+	/// Sets blend factors of a single draw buffer. (glBlendFuncSeparatei)
+	///
+	/// Blending itself is enabled per draw buffer with Enable(Cap::BLEND, _drawBuffer).
+	void SetBlendFuncSeparate(GLuint _drawBuffer, BlendFactor _srcRGB, BlendFactor _dstRGB, BlendFactor _srcAlpha, BlendFactor _dstAlpha, bool _force = false);
+	/// Sets blend factors of a single draw buffer for both color and alpha. (glBlendFunci)
+	inline void SetBlendFunc(GLuint _drawBuffer, BlendFactor _src, BlendFactor _dst, bool _force = false) { SetBlendFuncSeparate(_drawBuffer, _src, _dst, _src, _dst, _force); }
+	/// Sets blend factors of all draw buffers. (glBlendFuncSeparate)
+	void SetBlendFuncSeparate(BlendFactor _srcRGB, BlendFactor _dstRGB, BlendFactor _srcAlpha, BlendFactor _dstAlpha, bool _force = false);
+	/// Sets blend factors of all draw buffers for both color and alpha. (glBlendFunc)
+	inline void SetBlendFunc(BlendFactor _src, BlendFactor _dst, bool _force = false) { SetBlendFuncSeparate(_src, _dst, _src, _dst, _force); }
+
+	/// Sets blend equations of a single draw buffer. (glBlendEquationSeparatei)
+	void SetBlendEquationSeparate(GLuint _drawBuffer, BlendEquation _equationRGB, BlendEquation _equationAlpha, bool _force = false);
+	/// Sets the blend equation of a single draw buffer for both color and alpha. (glBlendEquationi)
+	inline void SetBlendEquation(GLuint _drawBuffer, BlendEquation _equation, bool _force = false) { SetBlendEquationSeparate(_drawBuffer, _equation, _equation, _force); }
+	/// Sets blend equations of all draw buffers. (glBlendEquationSeparate)
+	void SetBlendEquationSeparate(BlendEquation _equationRGB, BlendEquation _equationAlpha, bool _force = false);
+	/// Sets the blend equation of all draw buffers for both color and alpha. (glBlendEquation)
+	inline void SetBlendEquation(BlendEquation _equation, bool _force = false) { SetBlendEquationSeparate(_equation, _equation, _force); }
+
+	/// Sets the color write mask of a single draw buffer. (glColorMaski)
+	void SetColorMask(GLuint _drawBuffer, ColorMask _colorMask, bool _force = false);
+	/// Sets the color write mask of all draw buffers. (glColorMask)
+	void SetColorMask(ColorMask _colorMask, bool _force = false);
+
+	/// Sets the constant blend color used by the CONSTANT_* blend factors. (glBlendColor)
+	void SetBlendColor(float _red, float _green, float _blue, float _alpha, bool _force = false);
+
+	/// Gets blend state of a draw buffer from the internal state table. Values may be outdated if marked as unknown.
+	inline const Details::DrawBufferBlendState& GetBlendState(GLuint _drawBuffer);
+
+	/// Marks all blend functions, equations, color masks and the blend color as unknown.
+	///
+	/// For unknown states, no redundant change check will be performed. After the next call to the corresponding setter a state is no longer unknown.
+	/// Blend enable flags are part of the cap state table, see ResetBooleanCapStateTable_Unkown.
+	void ResetBlendStateTable_Unkown();
 
 
 	// --------------------------------------------------------------------------------------------------------------------------
 	// Viewport
 	// --------------------------------------------------------------------------------------------------------------------------
 
-	// todo ...
+	// Viewports, scissor boxes and depth ranges are cached for up to Details::MaxExpectedViewports viewports.
+	// Setters only change the cache and mark the changed range dirty. FlushViewportState sends each dirty range with a single
+	// glViewportArrayv/glScissorArrayv/glDepthRangeArrayv call, split only at unknown indices in between. Call it before drawing!
+
+	/// Sets the viewport of a single viewport index.
+	void SetViewport(GLuint _index, GLfloat _x, GLfloat _y, GLfloat _width, GLfloat _height, bool _force = false);
+	/// Sets the viewport of all viewport indices (like glViewport).
+	void SetViewport(GLfloat _x, GLfloat _y, GLfloat _width, GLfloat _height, bool _force = false);
+
+	/// Sets the scissor box of a single viewport index. Scissor test itself is enabled with Enable(Cap::SCISSOR_TEST, _index).
+	void SetScissor(GLuint _index, GLint _x, GLint _y, GLsizei _width, GLsizei _height, bool _force = false);
+	/// Sets the scissor box of all viewport indices (like glScissor).
+	void SetScissor(GLint _x, GLint _y, GLsizei _width, GLsizei _height, bool _force = false);
+
+	/// Sets the depth range of a single viewport index.
+	void SetDepthRange(GLuint _index, GLdouble _near, GLdouble _far, bool _force = false);
+	/// Sets the depth range of all viewport indices (like glDepthRange).
+	void SetDepthRange(GLdouble _near, GLdouble _far, bool _force = false);
+
+	/// Sends all changed viewports, scissor boxes and depth ranges to OpenGL.
+	///
+	/// Issues one call per state type, covering the range from the first to the last changed index.
+	/// Unchanged indices in between are sent along if they are known. Unknown ones split the range, since their cached values may differ from the actual OpenGL state.
+	void FlushViewportState();
+
+	/// Gets the viewport (x, y, width, height) of an index from the internal state table, including changes that were not flushed yet.
+	const GLfloat* GetViewport(GLuint _index);
+	/// Gets the scissor box (x, y, width, height) of an index from the internal state table, including changes that were not flushed yet.
+	const GLint* GetScissor(GLuint _index);
+	/// Gets the depth range (near, far) of an index from the internal state table, including changes that were not flushed yet.
+	const GLdouble* GetDepthRange(GLuint _index);
+
+	/// Marks all viewports, scissor boxes and depth ranges as unknown.
+	///
+	/// For unknown states, no redundant change check will be performed. After the next flush a state is no longer unknown.
+	/// Pending changes are discarded.
+	void ResetViewportStateTable_Unkown();
 
 
 	// --------------------------------------------------------------------------------------------------------------------------
 	// Misc
 	// --------------------------------------------------------------------------------------------------------------------------
 
+	/// Faces for glCullFace http://docs.gl/gl4/glCullFace
+	enum class CullFace
+	{
+		FRONT = GL_FRONT,
+		BACK = GL_BACK,
+		FRONT_AND_BACK = GL_FRONT_AND_BACK,
+	};
+
+	/// Winding of front facing polygons for glFrontFace http://docs.gl/gl4/glFrontFace
+	enum class FrontFace
+	{
+		CCW = GL_CCW,
+		CW = GL_CW,
+	};
+
+
+	// --------------------------------------------------------------------------------------------------------------------------
+	// Per context state tables
+	// --------------------------------------------------------------------------------------------------------------------------
+
+	namespace Details
+	{
+		/// Cache for per viewport state with dirty range tracking.
+		template<typename T, unsigned int N>
+		struct IndexedViewportStateTable
+		{
+			T values[MaxExpectedViewports][N];
+			bool known[MaxExpectedViewports];
+			/// Changed since the last flush.
+			bool dirty[MaxExpectedViewports];
+			/// Range enclosing all dirty indices.
+			unsigned int dirtyBegin;
+			unsigned int dirtyEnd;
+
+			void Init(const T(&_initialValue)[N]);
+			void Set(GLuint _index, const T(&_value)[N], bool _force);
+			void SetAll(const T(&_value)[N], bool _force);
+			bool IsDirty() const { return dirtyEnd > dirtyBegin; }
+			/// Sends all dirty values with as few calls of _setArray(first, count, values) as possible and clears the dirty range.
+			template<typename SetArrayFunc>
+			void Flush(SetArrayFunc _setArray);
+			void Reset();
+		};
+
+		/// All cached states of this file. There is one instance per gl::Context.
+		struct StateTables
+		{
+			/// Initializes all states with the defaults of a newly created OpenGL context.
+			StateTables();
+
+			CapState capStates[static_cast<unsigned int>(Cap::NUM_CAPS)];
+			CapState blendStatePerDrawBuffer[MaxExpectedDrawbuffers];
+			CapState scissorTestPerViewPort[MaxExpectedViewports];
+
+			bool depthWriteEnabled;
+			DepthFunc depthComparisionFunc;
+
+			/// Front (0) and back (1) face.
+			StencilFaceState stencilStates[2];
+
+			DrawBufferBlendState drawBufferBlendStates[MaxExpectedDrawbuffers];
+			float blendColor[4];
+			bool blendColorKnown;
+
+			IndexedViewportStateTable<GLfloat, 4> viewports;
+			IndexedViewportStateTable<GLint, 4> scissorBoxes;
+			IndexedViewportStateTable<GLdouble, 2> depthRanges;
+		};
+
+		/// Returns the state tables of the gl::Context that is current on the calling thread. Defined in context.hpp
+		inline StateTables& GetStateTables();
+	}
+
 	// todo ...
 	#include "statemanagement.inl"
 }
 
+#include "context.hpp"
+
@@ -1,45 +1,72 @@
 inline void Enable(Cap _cap, bool _force)
 {
-	if (_force || Details::CapStates[static_cast<unsigned int>(_cap)] != CapState::ENABLED)
+	GLHELPER_COUNT_STATE_CHANGE_REQUEST(CAP);
+	CapState& capState = Details::GetStateTables().capStates[static_cast<unsigned int>(_cap)];
+	if (_force || capState != CapState::ENABLED)
 	{
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(CAP);
 		GL_CALL(glEnable, Details::CapStateToGLCap[static_cast<unsigned int>(_cap)]);
-		Details::CapStates[static_cast<unsigned int>(_cap)] = CapState::ENABLED;
+		capState = CapState::ENABLED;
 	}
 }
 
 inline void Disable(Cap _cap, bool _force)
 {
-	if (_force || Details::CapStates[static_cast<unsigned int>(_cap)] != CapState::DISABLED)
+	GLHELPER_COUNT_STATE_CHANGE_REQUEST(CAP);
+	CapState& capState = Details::GetStateTables().capStates[static_cast<unsigned int>(_cap)];
+	if (_force || capState != CapState::DISABLED)
 	{
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(CAP);
 		GL_CALL(glDisable, Details::CapStateToGLCap[static_cast<unsigned int>(_cap)]);
-		Details::CapStates[static_cast<unsigned int>(_cap)] = CapState::DISABLED;
+		capState = CapState::DISABLED;
 	}
 }
 
+inline CapState GetCapState(Cap _cap)
+{
+	return Details::GetStateTables().capStates[static_cast<unsigned int>(_cap)];
+}
+
 inline void SetDepthWrite(bool _writeEnabled, bool _force)
 {
-	if (Details::DepthWriteEnabled != _writeEnabled || _force)
+	GLHELPER_COUNT_STATE_CHANGE_REQUEST(DEPTH_WRITE);
+	Details::StateTables& stateTables = Details::GetStateTables();
+	if (stateTables.depthWriteEnabled != _writeEnabled || _force)
 	{
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(DEPTH_WRITE);
 		GL_CALL(glDepthMask, _writeEnabled ? GL_TRUE : GL_FALSE);
-		Details::DepthWriteEnabled = _writeEnabled;
+		stateTables.depthWriteEnabled = _writeEnabled;
 	}
 }
 
 inline bool GetDepthWrite()
 {
-	return Details::DepthWriteEnabled;
+	return Details::GetStateTables().depthWriteEnabled;
 }
 
 inline void SetDepthFunc(DepthFunc _depthCompFunc, bool _force)
 {
-	if (_depthCompFunc != Details::DepthComparisionFunc || _force)
+	GLHELPER_COUNT_STATE_CHANGE_REQUEST(DEPTH_FUNC);
+	Details::StateTables& stateTables = Details::GetStateTables();
+	if (_depthCompFunc != stateTables.depthComparisionFunc || _force)
 	{
+		GLHELPER_COUNT_STATE_CHANGE_ISSUE(DEPTH_FUNC);
 		GL_CALL(glDepthFunc, _depthCompFunc);
-		Details::DepthComparisionFunc = _depthCompFunc;
+		stateTables.depthComparisionFunc = _depthCompFunc;
 	}
 }
 
 inline DepthFunc GetDepthFunc()
 {
-	return Details::DepthComparisionFunc;
+	return Details::GetStateTables().depthComparisionFunc;
+}
+
+inline const Details::StencilFaceState& GetStencilState(StencilFace _face)
+{
+	return Details::GetStateTables().stencilStates[_face == StencilFace::BACK ? 1 : 0];
 }
+
+inline const Details::DrawBufferBlendState& GetBlendState(GLuint _drawBuffer)
+{
+	return Details::GetStateTables().drawBufferBlendStates[_drawBuffer];
+}
\ No newline at end of file
@@ -1,9 +1,8 @@
 #include "texture.hpp"
+#include "context.hpp"
 
 namespace gl
 {
-	TextureId Texture::s_boundTextures[Texture::s_numTextureBindings];
-
 	Texture::Texture(GLsizei width, GLsizei height, GLsizei depth, TextureFormat format, GLsizei numMipLevels, GLsizei numMSAASamples) :
 		m_width(width),
 		m_height(height),
@@ -42,10 +41,11 @@ namespace gl
 		// Since they contain texture handles, this might result in rejected binding of new textures!
 
 		// Iterating over all bindings is rather costly but reliable, easy and zero overhead for all other operations.
+		TextureId* boundTextures = Context::GetCurrent().boundTextures;
 		for (unsigned int i = 0; i < s_numTextureBindings; ++i)
 		{
-			if (s_boundTextures[i] == m_textureHandle)
-				s_boundTextures[i] = 0;
+			if (boundTextures[i] == m_textureHandle)
+				boundTextures[i] = 0;
 		}
 
 		GL_CALL(glDeleteTextures, 1, &m_textureHandle);
@@ -82,13 +82,14 @@ namespace gl
 
     void Texture::ResetBinding(GLuint _slotIndex)
 	{
-		GLHELPER_ASSERT(_slotIndex < sizeof(s_boundTextures) / sizeof(Texture*), "Can't bind texture to slot " + std::to_string(_slotIndex) + 
-							". Maximum number of slots in glhelper is " + (std::to_string(sizeof(s_boundTextures) / sizeof(Texture*)) + 
+		GLHELPER_ASSERT(_slotIndex < s_numTextureBindings, "Can't bind texture to slot " + std::to_string(_slotIndex) + 
+							". Maximum number of slots in glhelper is " + (std::to_string(s_numTextureBindings) + 
 							". For actual hardware restrictions see glGet GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS"));
-		if (s_boundTextures[_slotIndex] != 0)
+		TextureId& boundTexture = Context::GetCurrent().boundTextures[_slotIndex];
+		if (boundTexture != 0)
 		{
 			GL_CALL(glBindTextureUnit, _slotIndex, 0);
-			s_boundTextures[_slotIndex] = 0;
+			boundTexture = 0;
 		}
 	}
 
@@ -106,11 +107,14 @@ namespace gl
 
 	void Texture::Bind(TextureId textureHandle, GLuint _slotIndex)
 	{
-		GLHELPER_ASSERT(_slotIndex < sizeof(s_boundTextures) / sizeof(void*), "Can't bind texture to slot " + std::to_string(_slotIndex) + ". Maximum number of slots is " + std::to_string(sizeof(s_boundTextures) / sizeof(Texture*)));
-		if(s_boundTextures[_slotIndex] != textureHandle)
+		GLHELPER_ASSERT(_slotIndex < s_numTextureBindings, "Can't bind texture to slot " + std::to_string(_slotIndex) + ". Maximum number of slots is " + std::to_string(s_numTextureBindings));
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(TEXTURE);
+		TextureId& boundTexture = Context::GetCurrent().boundTextures[_slotIndex];
+		if(boundTexture != textureHandle)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(TEXTURE);
 			GL_CALL(glBindTextureUnit, _slotIndex, textureHandle);
-			s_boundTextures[_slotIndex] = textureHandle;
+			boundTexture = textureHandle;
 		}
 	}
 
@@ -85,11 +85,6 @@ namespace gl
 		/// \remarks Internally used for all textures and texturebuffer.
 		/// Usually you should use TextureXD::Bind or TextureBuffer::Bind
 		static void Bind(TextureId textureHandle, GLuint _slotIndex);
-
-		/// Currently bound textures - number is arbitrary!
-		/// Also used for texturebuffer since these bindings are the same for OpenGL.
-		/// Not used for image binding
-		static TextureId s_boundTextures[s_numTextureBindings];
 		
 		TextureId m_textureHandle;
 
@@ -6,6 +6,13 @@
 #define STB_IMAGE_IMPLEMENTATION
 
 #include <stb_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
 #endif
 
 namespace gl
@@ -28,6 +35,18 @@ namespace gl
 	}
 
 #ifdef TEXTURE2D_FROMFILE_STBI
+	namespace
+	{
+		std::unique_ptr<Texture2D> CreateFromRGBA8(const stbi_uc* _textureData, int _width, int _height, bool _generateMipMaps, bool _sRGB)
+		{
+			std::unique_ptr<Texture2D> newTex(new Texture2D(static_cast<GLsizei>(_width), static_cast<GLsizei>(_height), _sRGB ? gl::TextureFormat::SRGB8_ALPHA8 : gl::TextureFormat::RGBA8, _generateMipMaps ? 0 : 1));
+			newTex->SetData(0, TextureSetDataFormat::RGBA, TextureSetDataType::UNSIGNED_BYTE, _textureData);
+			if (_generateMipMaps)
+				newTex->GenMipMaps();
+			return newTex;
+		}
+	}
+
 	std::unique_ptr<Texture2D> Texture2D::LoadFromFile(const std::string& _filename, bool _generateMipMaps, bool _sRGB)
 	{
 		int texSizeX = -1;
@@ -41,14 +60,115 @@ namespace gl
 			return nullptr;
 		}
 
-		std::unique_ptr<Texture2D> newTex(new Texture2D(static_cast<GLsizei>(texSizeX), static_cast<GLsizei>(texSizeY), _sRGB ? gl::TextureFormat::SRGB8_ALPHA8 : gl::TextureFormat::RGBA8, _generateMipMaps ? 0 : 1));
-		newTex->SetData(0, TextureSetDataFormat::RGBA, TextureSetDataType::UNSIGNED_BYTE, textureData);
-		if (_generateMipMaps)
-			newTex->GenMipMaps();
-
+		std::unique_ptr<Texture2D> newTex = CreateFromRGBA8(textureData, texSizeX, texSizeY, _generateMipMaps, _sRGB);
 		stbi_image_free(textureData);
 
-		return std::move(newTex);
+		return newTex;
+	}
+
+	std::vector<std::unique_ptr<Texture2D>> Texture2D::LoadFromFiles(const std::vector<std::string>& _filenames, bool _generateMipMaps, bool _sRGB, unsigned int _numThreads, size_t _maxDecodedBytes)
+	{
+		std::vector<std::unique_ptr<Texture2D>> textures(_filenames.size());
+		if (_filenames.empty())
+			return textures;
+
+		if (_numThreads == 0)
+			_numThreads = std::max(1u, std::thread::hardware_concurrency());
+		_numThreads = static_cast<unsigned int>(std::min<size_t>(_numThreads, _filenames.size()));
+
+		struct DecodedImage
+		{
+			size_t fileIndex;
+			stbi_uc* data; ///< NULL if decoding failed.
+			int width;
+			int height;
+			size_t numBytes;
+		};
+
+		std::mutex mutex;
+		std::condition_variable imageDecoded;	///< Signaled by workers when a new image (or failure) was queued.
+		std::condition_variable memoryFreed;	///< Signaled by the GL thread when decoded memory was released.
+		std::queue<DecodedImage> decodedImages;
+		size_t numDecodedBytes = 0;				///< Memory of all images that are being decoded or wait for upload.
+		std::atomic<size_t> nextFileIndex(0);
+
+		auto decodeWorker = [&]()
+		{
+			for (size_t fileIndex = nextFileIndex++; fileIndex < _filenames.size(); fileIndex = nextFileIndex++)
+			{
+				DecodedImage image;
+				image.fileIndex = fileIndex;
+				image.data = nullptr;
+				image.numBytes = 0;
+
+				// Read only the header first to reserve the decoded size before decoding.
+				int numComps = -1;
+				if (stbi_info(_filenames[fileIndex].c_str(), &image.width, &image.height, &numComps))
+				{
+					size_t numBytes = static_cast<size_t>(image.width) * image.height * 4;
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						memoryFreed.wait(lock, [&]() { return numDecodedBytes == 0 || numDecodedBytes + numBytes <= _maxDecodedBytes; });
+						numDecodedBytes += numBytes;
+					}
+
+					image.data = stbi_load(_filenames[fileIndex].c_str(), &image.width, &image.height, &numComps, 4);
+					if (image.data)
+						image.numBytes = numBytes;
+					else
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						numDecodedBytes -= numBytes;
+						memoryFreed.notify_all();
+					}
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					decodedImages.push(image);
+				}
+				imageDecoded.notify_one();
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for (unsigned int i = 0; i < _numThreads; ++i)
+			workers.emplace_back(decodeWorker);
+
+		// Upload on this thread whatever got decoded in the meantime, while the workers continue decoding.
+		size_t numHandledFiles = 0;
+		while (numHandledFiles < _filenames.size())
+		{
+			std::queue<DecodedImage> batch;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				imageDecoded.wait(lock, [&]() { return !decodedImages.empty(); });
+				std::swap(batch, decodedImages);
+			}
+
+			for (; !batch.empty(); batch.pop(), ++numHandledFiles)
+			{
+				const DecodedImage& image = batch.front();
+				if (!image.data)
+				{
+					GLHELPER_LOG_ERROR("Error loading texture \"" + _filenames[image.fileIndex] + "\".");
+					continue;
+				}
+
+				textures[image.fileIndex] = CreateFromRGBA8(image.data, image.width, image.height, _generateMipMaps, _sRGB);
+				stbi_image_free(image.data);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					numDecodedBytes -= image.numBytes;
+				}
+				memoryFreed.notify_all();
+			}
+		}
+
+		for (std::thread& worker : workers)
+			worker.join();
+
+		return textures;
 	}
 #endif
 
@@ -3,6 +3,7 @@
 #include "texture.hpp"
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace gl
 {
@@ -29,6 +30,21 @@ namespace gl
 		/// Uses given to create an object if file loading is successful. Use corresponding deallocator to remove the texture.
 		/// Will return NULL on error.
 		static std::unique_ptr<Texture2D> LoadFromFile(const std::string& _filename, bool _generateMipMaps = true, bool _sRGB = false);
+
+		/// \brief Loads several textures from files, decoding them in parallel.
+		///
+		/// Images are decoded with stb_image on a pool of worker threads, while the calling thread creates and uploads textures as soon as their images are decoded.
+		/// Must be called on the thread of the OpenGL context.
+		///
+		/// \param _numThreads
+		///		Number of decode threads. If 0, std::thread::hardware_concurrency is used.
+		/// \param _maxDecodedBytes
+		///		Limit for decoded image memory that is not uploaded yet. Workers wait before decoding an image that would exceed it.
+		///		A single image larger than the limit is still decoded if no other decoded image is pending.
+		/// \return
+		///		One texture per file in the same order. Entries of files that failed to load are NULL.
+		static std::vector<std::unique_ptr<Texture2D>> LoadFromFiles(const std::vector<std::string>& _filenames, bool _generateMipMaps = true, bool _sRGB = false,
+																		unsigned int _numThreads = 0, size_t _maxDecodedBytes = 256 * 1024 * 1024);
 #endif
 
 		/// Overwrites all data of a given mip level.
@@ -41,6 +57,7 @@ namespace gl
 		///		Offset of the area from (0,0) in pixel coordinates.
 		/// \param _areaSize
 		///		Size of the area in pixels which will be overwritten by _data.
+		/// \remarks Copies synchronously from client memory. For uploads from worker threads without stalls see TextureStreamer.
 		void SetData(GLsizei _mipLevel, TextureSetDataFormat _dataFormat, TextureSetDataType _dataType, const void* _data, const gl::UVec2& _areaOffset, const gl::UVec2& _areaSize);
 
 		GLenum GetOpenGLTextureType() const override { return GetNumMSAASamples() > 0 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D; }
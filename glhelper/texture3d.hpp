@@ -25,6 +25,7 @@ namespace gl
 		///		Offset of the area from (0,0,0) in pixel coordinates.
 		/// \param _volumeSize
 		///		Size of the area in pixels which will be overwritten by _data.
+		/// \remarks Copies synchronously from client memory. For uploads from worker threads without stalls see TextureStreamer.
 		void SetData(GLsizei _mipLevel, TextureSetDataFormat _dataFormat, TextureSetDataType _dataType, const void* _data, const gl::UVec3& _volumeOffset, const gl::UVec3& _volumeSize);
 
 		GLenum GetOpenGLTextureType() const override { return GL_TEXTURE_3D; }
@@ -1,6 +1,7 @@
 ﻿#include "texturebufferview.hpp"
 #include "shaderobject.hpp"
 #include "texture.hpp"
+#include "context.hpp"
 
 namespace gl
 {
@@ -21,10 +22,11 @@ namespace gl
 			// Since they contain texture handles, this might result in rejected binding of new textures!
 
 			// Iterating over all bindings is rather costly but reliable, easy and zero overhead for all other operations.
+			TextureId* boundTextures = Context::GetCurrent().boundTextures;
 			for(unsigned int i = 0; i < Texture::s_numTextureBindings; ++i)
 			{
-				if(Texture::s_boundTextures[i] == m_textureHandle)
-					Texture::s_boundTextures[i] = 0;
+				if(boundTextures[i] == m_textureHandle)
+					boundTextures[i] = 0;
 			}
 
 			GL_CALL(glDeleteTextures, 1, &m_textureHandle);
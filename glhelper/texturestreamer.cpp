@@ -0,0 +1,187 @@
+#include "texturestreamer.hpp"
+#include "texture2d.hpp"
+#include "texture3d.hpp"
+#include "utils/flagoperators.hpp"
+
+#include <vector>
+#include <string>
+
+namespace gl
+{
+	namespace
+	{
+		/// Alignment of every upload within the ring. Offsets into a pixel unpack buffer need to be a multiple of the texel component size.
+		const GLintptr s_uploadAlignment = 16;
+	}
+
+	TextureStreamer::TextureStreamer(GLsizeiptr _ringSizeInBytes, GLsizeiptr _frameByteBudget) :
+		m_buffer(_ringSizeInBytes, Buffer::MAP_WRITE | Buffer::MAP_PERSISTENT | Buffer::EXPLICIT_FLUSH),
+		m_frameByteBudget(_frameByteBudget),
+		m_writePosition(0),
+		m_numUsedBytes(0),
+		m_firstUploadId(0)
+	{
+		GLHELPER_ASSERT(_frameByteBudget > 0, "Frame byte budget needs to be larger than zero!");
+		m_mappedMemory = static_cast<char*>(m_buffer.Map(Buffer::MapType::WRITE, Buffer::MapWriteFlag::FLUSH_EXPLICIT));
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		GLHELPER_ASSERT(m_uploads.empty(), "TextureStreamer destroyed with " + std::to_string(m_uploads.size()) + " pending uploads!");
+
+		// Deleting the buffer is safe even if the GPU still reads from it, only the fences need to be cleaned up.
+		while (!m_batches.empty())
+		{
+			GL_CALL(glDeleteSync, m_batches.front().fence);
+			m_batches.pop();
+		}
+	}
+
+	void* TextureStreamer::BeginUpload(UploadId& _outId, Texture2D& _texture, GLsizei _mipLevel, TextureSetDataFormat _dataFormat, TextureSetDataType _dataType,
+										const gl::UVec2& _areaOffset, const gl::UVec2& _areaSize, GLsizeiptr _numBytes)
+	{
+		Upload upload;
+		upload.texture2D = &_texture;
+		upload.texture3D = nullptr;
+		upload.mipLevel = _mipLevel;
+		upload.dataFormat = _dataFormat;
+		upload.dataType = _dataType;
+		upload.offset = gl::UVec3(_areaOffset.x, _areaOffset.y, 0);
+		upload.size = gl::UVec3(_areaSize.x, _areaSize.y, 1);
+		upload.numBytes = _numBytes;
+
+		return Allocate(_outId, upload);
+	}
+
+	void* TextureStreamer::BeginUpload(UploadId& _outId, Texture3D& _texture, GLsizei _mipLevel, TextureSetDataFormat _dataFormat, TextureSetDataType _dataType,
+										const gl::UVec3& _volumeOffset, const gl::UVec3& _volumeSize, GLsizeiptr _numBytes)
+	{
+		Upload upload;
+		upload.texture2D = nullptr;
+		upload.texture3D = &_texture;
+		upload.mipLevel = _mipLevel;
+		upload.dataFormat = _dataFormat;
+		upload.dataType = _dataType;
+		upload.offset = _volumeOffset;
+		upload.size = _volumeSize;
+		upload.numBytes = _numBytes;
+
+		return Allocate(_outId, upload);
+	}
+
+	void* TextureStreamer::Allocate(UploadId& _outId, Upload& _upload)
+	{
+		GLHELPER_ASSERT(_upload.numBytes > 0, "Upload is zero sized!");
+		if (_upload.numBytes > m_buffer.GetSize())
+		{
+			GLHELPER_LOG_ERROR("Texture upload of " + std::to_string(_upload.numBytes) + " bytes is larger than the entire streaming ring buffer!");
+			return nullptr;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		GLintptr start = (m_writePosition + s_uploadAlignment - 1) / s_uploadAlignment * s_uploadAlignment;
+		if (start + _upload.numBytes > m_buffer.GetSize())
+			start = 0; // Skip remaining memory at the end of the ring, uploads are never split.
+
+		// Bytes from the current write position to the end of this upload, including skipped memory.
+		GLsizeiptr numRingBytes = start >= m_writePosition ? (start - m_writePosition + _upload.numBytes) : (m_buffer.GetSize() - m_writePosition + _upload.numBytes);
+		if (m_numUsedBytes + numRingBytes > m_buffer.GetSize())
+			return nullptr;
+
+		_upload.ringOffset = start;
+		_upload.numRingBytes = numRingBytes;
+		_upload.ready = false;
+
+		m_writePosition = (start + _upload.numBytes) % m_buffer.GetSize();
+		m_numUsedBytes += numRingBytes;
+
+		_outId = m_firstUploadId + m_uploads.size();
+		m_uploads.push_back(_upload);
+
+		return m_mappedMemory + start;
+	}
+
+	void TextureStreamer::EndUpload(UploadId _id)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		GLHELPER_ASSERT(_id >= m_firstUploadId && _id < m_firstUploadId + m_uploads.size(), "Invalid upload id or upload was already issued!");
+		m_uploads[static_cast<size_t>(_id - m_firstUploadId)].ready = true;
+	}
+
+	GLsizeiptr TextureStreamer::ProcessUploads()
+	{
+		// Retire all batches the GPU has finished with. Batches complete in order, so stop at the first one that is still in use.
+		while (!m_batches.empty())
+		{
+			GLenum syncState = GL_RET_CALL(glClientWaitSync, m_batches.front().fence, 0, 0);
+			if (syncState == GL_WAIT_FAILED)
+			{
+				gl::CheckGLError("glClientWaitSync");
+				break;
+			}
+			else if (syncState == GL_TIMEOUT_EXPIRED)
+				break;
+
+			GL_CALL(glDeleteSync, m_batches.front().fence);
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_numUsedBytes -= m_batches.front().numRingBytes;
+			}
+			m_batches.pop();
+		}
+
+		// Take finished uploads in reservation order until the budget is reached.
+		std::vector<Upload> uploads;
+		GLsizeiptr numIssuedBytes = 0;
+		GLsizeiptr numRingBytes = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			while (!m_uploads.empty() && m_uploads.front().ready &&
+				(uploads.empty() || numIssuedBytes + m_uploads.front().numBytes <= m_frameByteBudget))
+			{
+				numIssuedBytes += m_uploads.front().numBytes;
+				numRingBytes += m_uploads.front().numRingBytes;
+				uploads.push_back(m_uploads.front());
+				m_uploads.pop_front();
+				++m_firstUploadId;
+			}
+		}
+		if (uploads.empty())
+			return 0;
+
+		m_buffer.BindPixelUnpackBuffer();
+		for (const Upload& upload : uploads)
+		{
+			m_buffer.Flush(upload.ringOffset, upload.numBytes);
+
+			// With a bound pixel unpack buffer the data pointer is an offset into the buffer.
+			const void* bufferOffset = reinterpret_cast<const void*>(upload.ringOffset);
+			if (upload.texture2D)
+				upload.texture2D->SetData(upload.mipLevel, upload.dataFormat, upload.dataType, bufferOffset, gl::UVec2(upload.offset.x, upload.offset.y), gl::UVec2(upload.size.x, upload.size.y));
+			else
+				upload.texture3D->SetData(upload.mipLevel, upload.dataFormat, upload.dataType, bufferOffset, upload.offset, upload.size);
+		}
+		Buffer::UnbindPixelUnpackBuffer();
+
+		Batch batch;
+		batch.fence = GL_RET_CALL(glFenceSync, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		batch.numRingBytes = numRingBytes;
+		m_batches.push(batch);
+
+		return numIssuedBytes;
+	}
+
+	size_t TextureStreamer::GetNumPendingUploads() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_uploads.size();
+	}
+
+	GLsizeiptr TextureStreamer::GetNumUsedBytes() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_numUsedBytes;
+	}
+}
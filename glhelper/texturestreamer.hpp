@@ -0,0 +1,151 @@
+#pragma once
+
+#include "gl.hpp"
+#include "buffer.hpp"
+#include "texture.hpp"
+
+#include <deque>
+#include <queue>
+#include <mutex>
+#include <cstdint>
+
+namespace gl
+{
+	class Texture2D;
+	class Texture3D;
+
+	/// Asynchronous texture uploads via a persistently mapped pixel unpack buffer ring.
+	///
+	/// Any thread may reserve ring memory with BeginUpload, write texel data into it and hand it over with EndUpload. No OpenGL calls are made by these two functions.
+	/// Once per frame the GL thread calls ProcessUploads, which issues glTextureSubImage*D with ring buffer offsets for finished uploads (in reservation order) until the per frame byte budget is reached.
+	/// Each frame's uploads are guarded by a fence, ring memory is reused as soon as the fence is signaled. ProcessUploads never waits for the GPU.
+	///
+	/// Typical usage:
+	/// \code
+	///		// Worker thread
+	///		gl::TextureStreamer::UploadId id;
+	///		void* memory = streamer.BeginUpload(id, texture, 0, gl::TextureSetDataFormat::RGBA, gl::TextureSetDataType::UNSIGNED_BYTE, offset, size, numBytes);
+	///		if (memory)
+	///		{
+	///			Decode(memory);
+	///			streamer.EndUpload(id);
+	///		}
+	///		// GL thread, once per frame
+	///		streamer.ProcessUploads();
+	/// \endcode
+	///
+	/// \attention
+	///		Every successful BeginUpload needs a matching EndUpload, otherwise all later uploads will be stuck.
+	///		Target textures need to stay alive until their upload was issued by ProcessUploads.
+	///		Row alignment follows the current GL_UNPACK_ALIGNMENT (default 4).
+	class TextureStreamer
+	{
+	public:
+		typedef std::uint64_t UploadId;
+
+		/// \param _ringSizeInBytes
+		///		Size of the pixel unpack ring buffer. Needs to be larger than the largest single upload.
+		/// \param _frameByteBudget
+		///		Maximum number of bytes issued per ProcessUploads. A single upload larger than the budget is still issued if it is the first of its frame.
+		TextureStreamer(GLsizeiptr _ringSizeInBytes, GLsizeiptr _frameByteBudget);
+		~TextureStreamer();
+
+		TextureStreamer(const TextureStreamer&) = delete;
+		void operator = (const TextureStreamer&) = delete;
+
+		/// Reserves ring memory for an upload to an area of a 2D texture. Thread safe, makes no OpenGL calls.
+		///
+		/// \param _numBytes
+		///		Number of bytes of the texel data, including any row padding demanded by GL_UNPACK_ALIGNMENT.
+		/// \return
+		///		Memory to write the texel data to, or nullptr if the ring has currently not enough free space. Try again after the next ProcessUploads in that case.
+		///		The memory is write-only, do not read from it.
+		void* BeginUpload(UploadId& _outId, Texture2D& _texture, GLsizei _mipLevel, TextureSetDataFormat _dataFormat, TextureSetDataType _dataType,
+							const gl::UVec2& _areaOffset, const gl::UVec2& _areaSize, GLsizeiptr _numBytes);
+
+		/// Reserves ring memory for an upload to a volume of a 3D texture. Thread safe, makes no OpenGL calls.
+		///
+		/// \see BeginUpload
+		void* BeginUpload(UploadId& _outId, Texture3D& _texture, GLsizei _mipLevel, TextureSetDataFormat _dataFormat, TextureSetDataType _dataType,
+							const gl::UVec3& _volumeOffset, const gl::UVec3& _volumeSize, GLsizeiptr _numBytes);
+
+		/// Marks the upload as fully written, it will be issued by one of the next ProcessUploads calls. Thread safe, makes no OpenGL calls.
+		void EndUpload(UploadId _id);
+
+		/// Retires uploads whose fence was signaled and issues finished uploads within the frame byte budget.
+		///
+		/// Needs to be called on the thread of the OpenGL context, usually once per frame.
+		/// Leaves no pixel unpack buffer bound.
+		/// \return
+		///		Number of bytes that were issued.
+		GLsizeiptr ProcessUploads();
+
+
+		void SetFrameByteBudget(GLsizeiptr _frameByteBudget) { m_frameByteBudget = _frameByteBudget; }
+		GLsizeiptr GetFrameByteBudget() const { return m_frameByteBudget; }
+
+		/// Returns the number of uploads that were begun but not issued yet.
+		size_t GetNumPendingUploads() const;
+
+		/// Returns the number of ring buffer bytes that are reserved or still in use by the GPU.
+		GLsizeiptr GetNumUsedBytes() const;
+
+		/// Returns the underlying pixel unpack buffer.
+		const gl::Buffer& GetBuffer() const { return m_buffer; }
+
+	private:
+		struct Upload
+		{
+			Upload() : offset(0, 0, 0), size(0, 0, 0) {}
+
+			Texture2D* texture2D;
+			Texture3D* texture3D;
+			GLsizei mipLevel;
+			TextureSetDataFormat dataFormat;
+			TextureSetDataType dataType;
+			gl::UVec3 offset;
+			gl::UVec3 size;
+
+			/// Position of the texel data in the ring.
+			GLintptr ringOffset;
+			GLsizeiptr numBytes;
+			/// Ring bytes consumed by this upload including alignment padding and skipped memory at the end of the ring.
+			GLsizeiptr numRingBytes;
+
+			/// Set by EndUpload.
+			bool ready;
+		};
+
+		/// Reserves ring memory and appends a new upload. Returns nullptr if there is not enough space.
+		void* Allocate(UploadId& _outId, Upload& _upload);
+
+		/// Ring memory used by all uploads issued in one ProcessUploads call.
+		struct Batch
+		{
+			GLsync fence;
+			GLsizeiptr numRingBytes;
+		};
+
+
+		gl::Buffer m_buffer;
+		char* m_mappedMemory;
+
+		GLsizeiptr m_frameByteBudget;
+
+		/// Batches in flight, oldest first. Only accessed on the GL thread.
+		std::queue<Batch> m_batches;
+
+		/// Guards all members below.
+		mutable std::mutex m_mutex;
+
+		/// Next byte to be reserved.
+		GLintptr m_writePosition;
+		/// Bytes that are reserved or in use by the GPU. The oldest used byte is m_writePosition - m_numUsedBytes (modulo ring size).
+		GLsizeiptr m_numUsedBytes;
+
+		/// All uploads that were begun, but not issued yet, in reservation order.
+		std::deque<Upload> m_uploads;
+		/// Id of m_uploads.front().
+		UploadId m_firstUploadId;
+	};
+}
@@ -0,0 +1,32 @@
+// This file is completely independent of any OpenGL artefacts.
+
+#pragma once
+
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define FLOATCONVERSION_SSE2
+#endif
+
+namespace FloatConversionUtils
+{
+	/// Converts an array of doubles to floats.
+	///
+	/// Uses SSE2 to convert four values per iteration where available.
+	inline void DoubleToFloat(float* _destination, const double* _source, size_t _count)
+	{
+		size_t i = 0;
+#ifdef FLOATCONVERSION_SSE2
+		for (; i + 4 <= _count; i += 4)
+		{
+			__m128 low = _mm_cvtpd_ps(_mm_loadu_pd(_source + i));
+			__m128 high = _mm_cvtpd_ps(_mm_loadu_pd(_source + i + 2));
+			_mm_storeu_ps(_destination + i, _mm_movelh_ps(low, high));
+		}
+#endif
+		for (; i < _count; ++i)
+			_destination[i] = static_cast<float>(_source[i]);
+	}
+
+} // FloatConversionUtils
@@ -0,0 +1,28 @@
+// This file is completely independent of any OpenGL artefacts.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace HashUtils
+{
+	/// Start value of FNV1a. Pass the result of a previous call instead to hash several blocks of data as one.
+	const std::uint64_t FNV1aOffsetBasis = 14695981039346656037ULL;
+
+	/// 64 bit FNV-1a hash.
+	///
+	/// Fast and simple, but not suitable against deliberate collisions.
+	/// See http://www.isthe.com/chongo/tech/comp/fnv/
+	inline std::uint64_t FNV1a(const void* _data, size_t _sizeInBytes, std::uint64_t _hash = FNV1aOffsetBasis)
+	{
+		const std::uint8_t* bytes = static_cast<const std::uint8_t*>(_data);
+		for (size_t i = 0; i < _sizeInBytes; ++i)
+		{
+			_hash ^= bytes[i];
+			_hash *= 1099511628211ULL;
+		}
+		return _hash;
+	}
+
+} // HashUtils
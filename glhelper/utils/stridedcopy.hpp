@@ -0,0 +1,84 @@
+// This file is completely independent of any OpenGL artefacts.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define STRIDEDCOPY_SSE2
+#endif
+
+namespace StridedCopyUtils
+{
+	/// Copies _numElements elements of _elementSize bytes each from a strided source to a strided destination.
+	///
+	/// Typically used to expand tightly packed arrays to padded std140/std430 layouts (e.g. vec3 arrays with a stride of 16 bytes).
+	/// Only the _elementSize bytes of each destination element are written, bytes in between are left untouched (they may belong to other members).
+	/// Common element sizes use fixed size copies, 12 and 16 byte elements use SSE2 loads where available.
+	inline void StridedCopy(void* _destination, size_t _destinationStride, const void* _source, size_t _sourceStride, size_t _elementSize, size_t _numElements)
+	{
+		std::uint8_t* destination = static_cast<std::uint8_t*>(_destination);
+		const std::uint8_t* source = static_cast<const std::uint8_t*>(_source);
+
+		if (_numElements == 0)
+			return;
+
+		// Contiguous on both sides.
+		if (_destinationStride == _elementSize && _sourceStride == _elementSize)
+		{
+			memcpy(destination, source, _elementSize * _numElements);
+			return;
+		}
+
+		switch (_elementSize)
+		{
+		case 4:
+			for (size_t i = 0; i < _numElements; ++i, destination += _destinationStride, source += _sourceStride)
+				memcpy(destination, source, 4);
+			break;
+
+		case 8:
+			for (size_t i = 0; i < _numElements; ++i, destination += _destinationStride, source += _sourceStride)
+				memcpy(destination, source, 8);
+			break;
+
+		case 12:
+#ifdef STRIDEDCOPY_SSE2
+			// Single unaligned 16 byte load per element, stored as 8 + 4 bytes. The bytes after a destination element may belong to other members
+			// (e.g. a float after a vec3 in a struct), so they are never written. The load reads 4 bytes beyond the element, the last one is copied separately to stay within the source.
+			for (size_t i = 0; i + 1 < _numElements; ++i, destination += _destinationStride, source += _sourceStride)
+			{
+				__m128i element = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(destination), element);
+				std::int32_t lastComponent = _mm_cvtsi128_si32(_mm_srli_si128(element, 8));
+				memcpy(destination + 8, &lastComponent, 4);
+			}
+			memcpy(destination, source, 12);
+			break;
+#else
+			for (size_t i = 0; i < _numElements; ++i, destination += _destinationStride, source += _sourceStride)
+				memcpy(destination, source, 12);
+			break;
+#endif
+
+		case 16:
+#ifdef STRIDEDCOPY_SSE2
+			for (size_t i = 0; i < _numElements; ++i, destination += _destinationStride, source += _sourceStride)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+#else
+			for (size_t i = 0; i < _numElements; ++i, destination += _destinationStride, source += _sourceStride)
+				memcpy(destination, source, 16);
+#endif
+			break;
+
+		default:
+			for (size_t i = 0; i < _numElements; ++i, destination += _destinationStride, source += _sourceStride)
+				memcpy(destination, source, _elementSize);
+			break;
+		}
+	}
+
+} // StridedCopyUtils
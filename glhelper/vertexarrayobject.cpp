@@ -1,4 +1,5 @@
 #include "vertexarrayobject.hpp"
+#include "context.hpp"
 #include <vector>
 
 
@@ -45,8 +46,6 @@ namespace gl
 	};
 
 
-	VertexArrayObject* VertexArrayObject::s_boundVertexArray = nullptr;
-
 	VertexArrayObject::VertexArrayObject(const std::initializer_list<Attribute>& _vertexAttributes, const std::initializer_list<GLuint>& _vertexBindingDivisors) :
 		m_vertexAttributes(_vertexAttributes)
 	{
@@ -119,7 +118,7 @@ namespace gl
 	{
 		if(m_vao != 0)
 		{
-			if(s_boundVertexArray == this)
+			if(Context::GetCurrent().boundVertexArray == this)
 				ResetBinding();
 
 			GL_CALL(glDeleteVertexArrays, 1, &m_vao);
@@ -128,16 +127,19 @@ namespace gl
 
 	void VertexArrayObject::Bind()
 	{
-		if (s_boundVertexArray != this)
+		GLHELPER_COUNT_STATE_CHANGE_REQUEST(VERTEX_ARRAY);
+		VertexArrayObject*& boundVertexArray = Context::GetCurrent().boundVertexArray;
+		if (boundVertexArray != this)
 		{
+			GLHELPER_COUNT_STATE_CHANGE_ISSUE(VERTEX_ARRAY);
 			GL_CALL(glBindVertexArray, m_vao);
-			s_boundVertexArray = this;
+			boundVertexArray = this;
 		}
 	}
 
 	void VertexArrayObject::ResetBinding()
 	{
-		s_boundVertexArray = nullptr;
+		Context::GetCurrent().boundVertexArray = nullptr;
 		GL_CALL(glBindVertexArray, 0);
 	}
 
@@ -120,9 +120,6 @@ namespace gl
 		const std::vector<Attribute>& GetVertexAttributeDesc() const { return m_vertexAttributes; }
 
 	private:
-		/// Currently bound vertex array.
-		static VertexArrayObject* s_boundVertexArray;
-
 		/// OpenGL handle.
 		VertexArrayObjectId m_vao;
 
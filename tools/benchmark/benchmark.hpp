@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../common/hiddencontext.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+	/// Wall clock time since construction.
+	class Timer
+	{
+	public:
+		Timer() : m_start(std::chrono::high_resolution_clock::now()) {}
+
+		double GetElapsedMilliseconds() const
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_start).count();
+		}
+
+	private:
+		std::chrono::high_resolution_clock::time_point m_start;
+	};
+
+	/// Each benchmark gets all command line arguments after its name and returns false on failure.
+	bool RunRenderQueue(const std::vector<std::string>& _arguments);
+	bool RunWritePolicies(const std::vector<std::string>& _arguments);
+	bool RunContext(const std::vector<std::string>& _arguments);
+	bool RunCommandList(const std::vector<std::string>& _arguments);
+	bool RunBindless(const std::vector<std::string>& _arguments);
+	bool RunTextureLoad(const std::vector<std::string>& _arguments);
+}
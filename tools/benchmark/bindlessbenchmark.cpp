@@ -0,0 +1,193 @@
+#include "benchmark.hpp"
+
+#include <bindlesstexturemanager.hpp>
+#include <buffer.hpp>
+#include <framebufferobject.hpp>
+#include <shaderobject.hpp>
+#include <texture2d.hpp>
+#include <vertexarrayobject.hpp>
+
+#include <iostream>
+#include <memory>
+
+namespace Benchmark
+{
+	namespace
+	{
+		const unsigned int s_texturesPerMaterial = 4;
+		const unsigned int s_numFrames = 100;
+
+		const char* s_vertexShaderSource =
+			"#version 450\n"
+			"layout(location = 0) in vec2 position;\n"
+			"void main() { gl_Position = vec4(position, 0.0, 1.0); }\n";
+
+		const char* s_slotFragmentShaderSource =
+			"#version 450\n"
+			"layout(binding = 0) uniform sampler2D texture0;\n"
+			"layout(binding = 1) uniform sampler2D texture1;\n"
+			"layout(binding = 2) uniform sampler2D texture2;\n"
+			"layout(binding = 3) uniform sampler2D texture3;\n"
+			"out vec4 color;\n"
+			"void main() { color = texture(texture0, vec2(0.5)) + texture(texture1, vec2(0.5)) + texture(texture2, vec2(0.5)) + texture(texture3, vec2(0.5)); }\n";
+
+		const char* s_bindlessVertexShaderSource =
+			"#version 450\n"
+			"#extension GL_ARB_shader_draw_parameters : require\n"
+			"layout(location = 0) in vec2 position;\n"
+			"flat out int material;\n"
+			"void main() { material = gl_DrawIDARB; gl_Position = vec4(position, 0.0, 1.0); }\n";
+
+		const char* s_bindlessFragmentShaderSource =
+			"#version 450\n"
+			"#extension GL_ARB_bindless_texture : require\n"
+			"layout(std430, binding = 0) readonly buffer Materials { uvec2 textureHandles[]; };\n"
+			"flat in int material;\n"
+			"out vec4 color;\n"
+			"void main()\n"
+			"{\n"
+			"	color = vec4(0.0);\n"
+			"	for (int i = 0; i < 4; ++i)\n"
+			"		color += texture(sampler2D(textureHandles[material * 4 + i]), vec2(0.5));\n"
+			"}\n";
+
+		bool CreateProgram(gl::ShaderObject& _program, const char* _vertexShaderSource, const char* _fragmentShaderSource)
+		{
+			return _program.AddShaderFromSource(gl::ShaderObject::ShaderType::VERTEX, _vertexShaderSource, _program.GetName() + ".vert") == gl::Result::SUCCEEDED &&
+					_program.AddShaderFromSource(gl::ShaderObject::ShaderType::FRAGMENT, _fragmentShaderSource, _program.GetName() + ".frag") == gl::Result::SUCCEEDED &&
+					_program.CreateProgram() == gl::Result::SUCCEEDED;
+		}
+
+		struct DrawArraysIndirectCommand
+		{
+			GLuint count;
+			GLuint instanceCount;
+			GLuint first;
+			GLuint baseInstance;
+		};
+
+		/// Wall clock time of submitting a frame and of the whole frame including GPU execution, in milliseconds.
+		struct FrameTime
+		{
+			double submit;
+			double total;
+		};
+
+		template<typename DrawFrame>
+		FrameTime MeasureFrames(const DrawFrame& _drawFrame)
+		{
+			// Warm up: driver side validation and residency changes of the first frame are not representative.
+			_drawFrame();
+			glFinish();
+
+			FrameTime frameTime;
+			Timer timer;
+			for (unsigned int frame = 0; frame < s_numFrames; ++frame)
+				_drawFrame();
+			frameTime.submit = timer.GetElapsedMilliseconds() / s_numFrames;
+			glFinish();
+			frameTime.total = timer.GetElapsedMilliseconds() / s_numFrames;
+
+			return frameTime;
+		}
+	}
+
+	bool RunBindless(const std::vector<std::string>& _arguments)
+	{
+		unsigned int numMaterials = _arguments.empty() ? 4096 : std::stoul(_arguments[0]);
+		if (numMaterials == 0)
+		{
+			std::cerr << "Number of materials needs to be positive." << std::endl;
+			return false;
+		}
+
+		if (!Tools::CreateHiddenContext("glhelper_benchmark"))
+		{
+			std::cerr << "Failed to create OpenGL context." << std::endl;
+			return false;
+		}
+		if (!GLEW_ARB_bindless_texture || !GLEW_ARB_shader_draw_parameters)
+		{
+			std::cerr << "ARB_bindless_texture and ARB_shader_draw_parameters are required." << std::endl;
+			return false;
+		}
+
+		// Every material has its own textures, so the slot path needs to rebind all of them for every draw.
+		const unsigned int numTextures = numMaterials * s_texturesPerMaterial;
+		const std::uint32_t texels[16] = { 0xFFFFFFFF, 0xFF0000FF, 0xFF00FF00, 0xFFFF0000, 0xFFFFFFFF, 0xFF0000FF, 0xFF00FF00, 0xFFFF0000,
+											0xFFFFFFFF, 0xFF0000FF, 0xFF00FF00, 0xFFFF0000, 0xFFFFFFFF, 0xFF0000FF, 0xFF00FF00, 0xFFFF0000 };
+		std::vector<std::unique_ptr<gl::Texture2D>> textures;
+		for (unsigned int i = 0; i < numTextures; ++i)
+			textures.emplace_back(new gl::Texture2D(4, 4, gl::TextureFormat::RGBA8, texels, gl::TextureSetDataFormat::RGBA, gl::TextureSetDataType::UNSIGNED_BYTE));
+
+		// One point per material on a single pixel render target. Keeps GPU work negligible, so the frame time is dominated by submission.
+		gl::Texture2D renderTarget(1, 1, gl::TextureFormat::RGBA8);
+		gl::FramebufferObject::Attachment colorAttachment(&renderTarget);
+		gl::FramebufferObject framebuffer(colorAttachment);
+		framebuffer.Bind(true);
+
+		const float point[2] = { 0.0f, 0.0f };
+		gl::Buffer vertexBuffer(sizeof(point), gl::Buffer::IMMUTABLE, point);
+		gl::VertexArrayObject vertexArray({ gl::VertexArrayObject::Attribute(gl::VertexArrayObject::Attribute::Type::FLOAT, 2) });
+
+		gl::ShaderObject slotProgram("bindlessbenchmark_slots");
+		gl::ShaderObject bindlessProgram("bindlessbenchmark_bindless");
+		if (!CreateProgram(slotProgram, s_vertexShaderSource, s_slotFragmentShaderSource) ||
+			!CreateProgram(bindlessProgram, s_bindlessVertexShaderSource, s_bindlessFragmentShaderSource))
+			return false;
+
+		// Slot binding: four texture binds and a draw per material.
+		FrameTime slotTime = MeasureFrames([&]()
+		{
+			slotProgram.Activate();
+			vertexArray.Bind();
+			vertexBuffer.BindVertexBuffer(0, 0, vertexArray.GetVertexStride(0));
+			for (unsigned int material = 0; material < numMaterials; ++material)
+			{
+				for (unsigned int i = 0; i < s_texturesPerMaterial; ++i)
+					textures[material * s_texturesPerMaterial + i]->Bind(i);
+				GL_CALL(glDrawArrays, GL_POINTS, 0, 1);
+			}
+		});
+
+		// Bindless: the material table is rewritten every frame through the manager, all materials are drawn with a single multi draw indirect call.
+		gl::BindlessTextureManager bindlessTextureManager(numTextures);
+		std::vector<gl::BindlessTextureManager::TextureSamplerPair> materialTextures;
+		for (const std::unique_ptr<gl::Texture2D>& texture : textures)
+			materialTextures.push_back(gl::BindlessTextureManager::TextureSamplerPair(*texture));
+		gl::Buffer materialBuffer(numTextures * sizeof(GLuint64), gl::Buffer::SUB_DATA_UPDATE);
+
+		std::vector<DrawArraysIndirectCommand> drawCommands(numMaterials);
+		for (DrawArraysIndirectCommand& command : drawCommands)
+		{
+			command.count = 1;
+			command.instanceCount = 1;
+			command.first = 0;
+			command.baseInstance = 0;
+		}
+		gl::Buffer indirectBuffer(drawCommands.size() * sizeof(DrawArraysIndirectCommand), gl::Buffer::IMMUTABLE, drawCommands.data());
+
+		FrameTime bindlessTime = MeasureFrames([&]()
+		{
+			bindlessTextureManager.BeginFrame();
+			bindlessTextureManager.WriteHandles(materialBuffer, 0, materialTextures);
+
+			bindlessProgram.Activate();
+			vertexArray.Bind();
+			vertexBuffer.BindVertexBuffer(0, 0, vertexArray.GetVertexStride(0));
+			materialBuffer.BindShaderStorageBuffer(0);
+			indirectBuffer.BindIndirectDrawBuffer();
+			GL_CALL(glMultiDrawArraysIndirect, GL_POINTS, nullptr, static_cast<GLsizei>(numMaterials), 0);
+		});
+
+		std::cout << numMaterials << " materials with " << s_texturesPerMaterial << " textures each, average over " << s_numFrames << " frames\n"
+			<< "  Slot binding:        " << slotTime.submit << " ms submit, " << slotTime.total << " ms total per frame\n"
+			<< "  Bindless + MDI:      " << bindlessTime.submit << " ms submit, " << bindlessTime.total << " ms total per frame\n"
+			<< "  Resident handles:    " << bindlessTextureManager.GetNumResidentHandles() << std::endl;
+
+		for (const std::unique_ptr<gl::Texture2D>& texture : textures)
+			bindlessTextureManager.ReleaseTexture(*texture);
+
+		return true;
+	}
+}
@@ -0,0 +1,107 @@
+#include "benchmark.hpp"
+
+#include <commandlist.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace Benchmark
+{
+	namespace
+	{
+		const unsigned int s_numPrograms = 16;
+		const unsigned int s_numMeshes = 256;
+		const unsigned int s_numTextures = 1024;
+
+		/// Placeholder objects. Recording only stores pointers and is never executed here, so no OpenGL context is needed.
+		struct Objects
+		{
+			Objects() : storage(s_numPrograms + s_numMeshes * 3 + s_numTextures + 1) {}
+
+			const gl::ShaderObject& Program(unsigned int _index) const		{ return *reinterpret_cast<const gl::ShaderObject*>(&storage[_index % s_numPrograms]); }
+			gl::VertexArrayObject& VertexArray(unsigned int _index)		{ return *reinterpret_cast<gl::VertexArrayObject*>(&storage[s_numPrograms + _index % s_numMeshes]); }
+			const gl::Buffer& VertexBuffer(unsigned int _index) const		{ return *reinterpret_cast<const gl::Buffer*>(&storage[s_numPrograms + s_numMeshes + _index % s_numMeshes]); }
+			gl::Buffer& IndexBuffer(unsigned int _index)					{ return *reinterpret_cast<gl::Buffer*>(&storage[s_numPrograms + s_numMeshes * 2 + _index % s_numMeshes]); }
+			const gl::Texture& Texture(unsigned int _index) const			{ return *reinterpret_cast<const gl::Texture*>(&storage[s_numPrograms + s_numMeshes * 3 + _index % s_numTextures]); }
+			gl::Buffer& UniformBuffer()										{ return *reinterpret_cast<gl::Buffer*>(&storage.back()); }
+
+			std::vector<char> storage;
+		};
+
+		/// Records a typical draw: program, geometry, two textures, 64 bytes of per draw uniform data.
+		void RecordDraws(gl::CommandList& _commandList, Objects& _objects, unsigned int _firstDraw, unsigned int _numDraws)
+		{
+			_commandList.Clear();
+			float uniformData[16] = {};
+			for (unsigned int draw = _firstDraw; draw < _firstDraw + _numDraws; ++draw)
+			{
+				uniformData[0] = static_cast<float>(draw);
+				_commandList.ActivateShader(_objects.Program(draw / 1024));
+				_commandList.BindVertexArray(_objects.VertexArray(draw));
+				_commandList.BindVertexBuffer(_objects.VertexBuffer(draw), 0, 0, 32);
+				_commandList.BindIndexBuffer(_objects.IndexBuffer(draw));
+				_commandList.BindTexture(_objects.Texture(draw), 0);
+				_commandList.BindTexture(_objects.Texture(draw * 7), 1);
+				_commandList.SetBufferData(_objects.UniformBuffer(), uniformData, 0, sizeof(uniformData));
+				_commandList.DrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			}
+		}
+
+		/// Records _numDraws split evenly across _numThreads command lists and returns the wall clock time in milliseconds.
+		double MeasureRecording(std::vector<gl::CommandList>& _commandLists, Objects& _objects, unsigned int _numThreads, unsigned int _numDraws)
+		{
+			Timer timer;
+			std::vector<std::thread> threads;
+			unsigned int drawsPerThread = (_numDraws + _numThreads - 1) / _numThreads;
+			for (unsigned int i = 0; i < _numThreads; ++i)
+			{
+				unsigned int firstDraw = i * drawsPerThread;
+				unsigned int numDraws = std::min(drawsPerThread, _numDraws - std::min(firstDraw, _numDraws));
+				threads.emplace_back(&RecordDraws, std::ref(_commandLists[i]), std::ref(_objects), firstDraw, numDraws);
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+			return timer.GetElapsedMilliseconds();
+		}
+	}
+
+	bool RunCommandList(const std::vector<std::string>& _arguments)
+	{
+		unsigned int numDraws = _arguments.size() < 1 ? 1000000 : std::stoul(_arguments[0]);
+		unsigned int maxThreads = _arguments.size() < 2 ? std::max(std::thread::hardware_concurrency(), 1u) : std::stoul(_arguments[1]);
+		if (numDraws == 0 || maxThreads == 0)
+		{
+			std::cerr << "Number of draws and threads need to be positive." << std::endl;
+			return false;
+		}
+
+		Objects objects;
+		std::vector<gl::CommandList> commandLists(maxThreads);
+
+		std::cout << numDraws << " draws with 8 commands each, recorded on 1 to " << maxThreads << " threads\n";
+		double singleThreadTime = 0.0;
+		for (unsigned int numThreads = 1; ; numThreads = std::min(numThreads * 2, maxThreads))
+		{
+			// The first pass grows the lists to their final size, the measured second pass does not allocate anymore.
+			MeasureRecording(commandLists, objects, numThreads, numDraws);
+			double time = MeasureRecording(commandLists, objects, numThreads, numDraws);
+			if (numThreads == 1)
+				singleThreadTime = time;
+
+			size_t totalBytes = 0;
+			for (unsigned int i = 0; i < numThreads; ++i)
+				totalBytes += commandLists[i].GetSize();
+
+			std::cout << "  " << numThreads << " thread(s): " << time << " ms, " << (numDraws * 8.0 / time / 1000.0) << " million commands/s, speedup "
+				<< (singleThreadTime / time) << ", " << (totalBytes / 1024) << " KiB recorded\n";
+
+			if (numThreads == maxThreads)
+				break;
+		}
+		std::cout.flush();
+
+		return true;
+	}
+}
@@ -0,0 +1,96 @@
+#include "benchmark.hpp"
+
+#include <context.hpp>
+
+#include <iostream>
+#include <thread>
+
+namespace Benchmark
+{
+	namespace
+	{
+		/// Binding table as it was before gl::Context, a plain global like the former VertexArrayObject::s_boundVertexArray.
+		gl::VertexArrayObject* s_globalBoundVertexArray = nullptr;
+
+		/// Redundancy check of VertexArrayObject::Bind with the binding table in the current gl::Context.
+		void BindThreadLocal(gl::VertexArrayObject* _vertexArray)
+		{
+			gl::VertexArrayObject*& boundVertexArray = gl::Context::GetCurrent().boundVertexArray;
+			if (boundVertexArray != _vertexArray)
+				boundVertexArray = _vertexArray;
+		}
+
+		/// Redundancy check of VertexArrayObject::Bind with a global binding table.
+		void BindGlobal(gl::VertexArrayObject* _vertexArray)
+		{
+			if (s_globalBoundVertexArray != _vertexArray)
+				s_globalBoundVertexArray = _vertexArray;
+		}
+
+		/// Calls the bind function through a volatile pointer, so that every call is out of line like a call to VertexArrayObject::Bind.
+		/// Returns nanoseconds per call.
+		double MeasureBinds(void (*_bindFunction)(gl::VertexArrayObject*), unsigned int _numCalls)
+		{
+			void (* volatile bindFunction)(gl::VertexArrayObject*) = _bindFunction;
+			gl::VertexArrayObject* vertexArray = reinterpret_cast<gl::VertexArrayObject*>(&s_globalBoundVertexArray);
+			bindFunction(vertexArray);
+
+			Timer timer;
+			for (unsigned int i = 0; i < _numCalls; ++i)
+				bindFunction(vertexArray);
+			return timer.GetElapsedMilliseconds() * 1000000.0 / _numCalls;
+		}
+
+		/// Redundant state calls of statemanagement.hpp, inlined at the call site. Initial states are known, so no OpenGL calls are made.
+		/// Returns nanoseconds per call.
+		double MeasureRedundantStateCalls(unsigned int _numCalls)
+		{
+			unsigned int numIterations = _numCalls / 2;
+			Timer timer;
+			for (unsigned int i = 0; i < numIterations; ++i)
+			{
+				gl::Disable(gl::Cap::DEPTH_TEST);
+				gl::SetDepthWrite(true);
+			}
+			return timer.GetElapsedMilliseconds() * 1000000.0 / (numIterations * 2.0);
+		}
+
+		void PrintMeasurements(unsigned int _numCalls)
+		{
+			double globalTime = MeasureBinds(&BindGlobal, _numCalls);
+			double threadLocalTime = MeasureBinds(&BindThreadLocal, _numCalls);
+			double stateCallTime = MeasureRedundantStateCalls(_numCalls);
+
+			std::cout << "  Redundant bind, global table:         " << globalTime << " ns per call\n"
+				<< "  Redundant bind, thread local context: " << threadLocalTime << " ns per call (" << (threadLocalTime - globalTime) << " ns overhead)\n"
+				<< "  Redundant inline state call:          " << stateCallTime << " ns per call\n";
+		}
+	}
+
+	bool RunContext(const std::vector<std::string>& _arguments)
+	{
+		unsigned int numCalls = _arguments.empty() ? 100000000 : std::stoul(_arguments[0]);
+		if (numCalls < 2)
+		{
+			std::cerr << "Number of calls needs to be at least 2." << std::endl;
+			return false;
+		}
+
+		std::cout << numCalls << " calls\nDefault context, main thread:\n";
+		PrintMeasurements(numCalls);
+
+		// A second thread with its own context, like an upload thread.
+		std::thread thread([numCalls]()
+		{
+			gl::Context context;
+			context.MakeCurrent();
+			std::cout << "Own context, second thread:\n";
+			PrintMeasurements(numCalls);
+			gl::Context::GetDefault().MakeCurrent();
+		});
+		thread.join();
+		std::cout.flush();
+
+		return true;
+	}
+}
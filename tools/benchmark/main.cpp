@@ -0,0 +1,57 @@
+// Measurements for the performance related parts of glhelper.
+// Each benchmark is selected by name and prints its results to the console.
+
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct BenchmarkEntry
+	{
+		const char* name;
+		const char* description;
+		bool (*run)(const std::vector<std::string>& _arguments);
+	};
+
+	const BenchmarkEntry s_benchmarks[] =
+	{
+		{ "renderqueue", "[numDraws]  State changes of random draw packets before and after RenderQueue::Sort", &Benchmark::RunRenderQueue },
+		{ "writepolicies", "[numIterations]  Cost per BufferInfoView Set with the std::function, mapped memory and staging write policies", &Benchmark::RunWritePolicies },
+		{ "context", "[numCalls]  Cost of the thread local gl::Context lookup on the redundant bind path", &Benchmark::RunContext },
+		{ "commandlist", "[numDraws] [maxThreads]  CommandList recording throughput with increasing numbers of threads", &Benchmark::RunCommandList },
+		{ "bindless", "[numMaterials]  Frame time of per draw texture slot binding vs. bindless handles with multi draw indirect (needs OpenGL)", &Benchmark::RunBindless },
+		{ "textureload", "<directory> [numFiles] [size]  Texture2D::LoadFromFile vs. LoadFromFiles over all PNGs of a directory, generated if there are none (needs OpenGL, TEXTURE2D_FROMFILE_STBI)", &Benchmark::RunTextureLoad },
+	};
+
+	void PrintUsage()
+	{
+		std::cout << "Usage: glhelper_benchmark <benchmark> [arguments]\n"
+			"  Available benchmarks:\n";
+		for (const BenchmarkEntry& benchmark : s_benchmarks)
+			std::cout << "  " << benchmark.name << " " << benchmark.description << "\n";
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	if (_argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::string name(_argv[1]);
+	std::vector<std::string> arguments(_argv + 2, _argv + _argc);
+	for (const BenchmarkEntry& benchmark : s_benchmarks)
+	{
+		if (name == benchmark.name)
+			return benchmark.run(arguments) ? 0 : 1;
+	}
+
+	std::cerr << "Unknown benchmark " << name << std::endl;
+	PrintUsage();
+	return 1;
+}
@@ -0,0 +1,96 @@
+#include "benchmark.hpp"
+
+#include <renderqueue.hpp>
+
+#include <iostream>
+#include <random>
+
+namespace Benchmark
+{
+	namespace
+	{
+		const unsigned int s_numPrograms = 64;
+		const unsigned int s_numPipelineStates = 32;
+		const unsigned int s_numMeshes = 256;
+		const unsigned int s_numTextures = 1024;
+		const unsigned int s_numMaterials = 1000;
+		const unsigned int s_texturesPerMaterial = 2;
+
+		void PrintStatistics(const char* _label, const gl::RenderQueue::Statistics& _statistics)
+		{
+			std::cout << _label << ":\n"
+				<< "  draws                  " << _statistics.numDraws << "\n"
+				<< "  program changes        " << _statistics.numProgramChanges << "\n"
+				<< "  pipeline state changes " << _statistics.numPipelineStateChanges << "\n"
+				<< "  vertex array changes   " << _statistics.numVertexArrayChanges << "\n"
+				<< "  vertex buffer changes  " << _statistics.numVertexBufferChanges << "\n"
+				<< "  index buffer changes   " << _statistics.numIndexBufferChanges << "\n"
+				<< "  texture changes        " << _statistics.numTextureChanges << "\n"
+				<< "  total state changes    " << _statistics.GetNumStateChanges() << "\n";
+		}
+	}
+
+	bool RunRenderQueue(const std::vector<std::string>& _arguments)
+	{
+		unsigned int numDraws = _arguments.empty() ? 100000 : std::stoul(_arguments[0]);
+		if (numDraws == 0)
+		{
+			std::cerr << "Number of draws needs to be positive." << std::endl;
+			return false;
+		}
+
+		// RenderQueue::CountStateChanges only compares pointers and never dereferences them, so the packets can reference placeholder addresses.
+		// This keeps the benchmark independent of an OpenGL context. Every byte of the storage stands for a distinct object.
+		std::vector<char> objectStorage(s_numPrograms + s_numMeshes * 3 + s_numTextures);
+		char* programs = objectStorage.data();
+		char* vertexArrays = programs + s_numPrograms;
+		char* vertexBuffers = vertexArrays + s_numMeshes;
+		char* indexBuffers = vertexBuffers + s_numMeshes;
+		char* textures = indexBuffers + s_numMeshes;
+
+		std::mt19937 random(1234);
+
+		// Materials combine program, pipeline state and textures. Packets draw random meshes with random materials, like a scene traversed in arbitrary order.
+		std::vector<gl::RenderQueue::DrawPacket> materials(s_numMaterials);
+		for (gl::RenderQueue::DrawPacket& material : materials)
+		{
+			material.program = reinterpret_cast<const gl::ShaderObject*>(programs + random() % s_numPrograms);
+			material.pipelineState = static_cast<gl::PipelineStateId>(random() % s_numPipelineStates);
+			for (unsigned int i = 0; i < s_texturesPerMaterial; ++i)
+				material.textures[i] = reinterpret_cast<const gl::Texture*>(textures + random() % s_numTextures);
+		}
+
+		std::uniform_real_distribution<float> depthDistribution(0.1f, 1000.0f);
+		gl::RenderQueue queue;
+		Timer submitTimer;
+		for (unsigned int i = 0; i < numDraws; ++i)
+		{
+			gl::RenderQueue::DrawPacket packet = materials[random() % s_numMaterials];
+			unsigned int mesh = random() % s_numMeshes;
+			packet.vertexArray = reinterpret_cast<gl::VertexArrayObject*>(vertexArrays + mesh);
+			packet.vertexBuffer = reinterpret_cast<gl::Buffer*>(vertexBuffers + mesh);
+			packet.indexBuffer = reinterpret_cast<gl::Buffer*>(indexBuffers + mesh);
+			packet.depth = depthDistribution(random);
+			packet.count = 36;
+			queue.Submit(packet);
+		}
+		double submitTime = submitTimer.GetElapsedMilliseconds();
+
+		gl::RenderQueue::Statistics unsorted = queue.CountStateChanges();
+
+		Timer sortTimer;
+		queue.Sort();
+		double sortTime = sortTimer.GetElapsedMilliseconds();
+
+		gl::RenderQueue::Statistics sorted = queue.CountStateChanges();
+
+		std::cout << numDraws << " draws, " << s_numMaterials << " materials (" << s_numPrograms << " programs, " << s_numPipelineStates << " pipeline states, "
+			<< s_numTextures << " textures), " << s_numMeshes << " meshes\n"
+			<< "Submit: " << submitTime << " ms, Sort: " << sortTime << " ms\n\n";
+		PrintStatistics("Submission order", unsorted);
+		PrintStatistics("Sorted", sorted);
+		std::cout << "\nState changes reduced by " << (100.0 - 100.0 * sorted.GetNumStateChanges() / unsorted.GetNumStateChanges()) << "%" << std::endl;
+
+		return true;
+	}
+}
@@ -0,0 +1,199 @@
+#include "benchmark.hpp"
+
+#include <texture2d.hpp>
+
+#ifndef NOMINMAX
+	#define NOMINMAX
+#endif
+#include <Windows.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace Benchmark
+{
+#ifdef TEXTURE2D_FROMFILE_STBI
+	namespace
+	{
+		std::uint32_t Crc32(const std::uint8_t* _data, size_t _numBytes, std::uint32_t _crc = 0)
+		{
+			static std::uint32_t s_table[256] = {};
+			if (s_table[1] == 0)
+			{
+				for (std::uint32_t i = 0; i < 256; ++i)
+				{
+					std::uint32_t value = i;
+					for (int bit = 0; bit < 8; ++bit)
+						value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+					s_table[i] = value;
+				}
+			}
+
+			_crc = ~_crc;
+			for (size_t i = 0; i < _numBytes; ++i)
+				_crc = s_table[(_crc ^ _data[i]) & 0xFF] ^ (_crc >> 8);
+			return ~_crc;
+		}
+
+		void AppendBigEndian(std::vector<std::uint8_t>& _output, std::uint32_t _value)
+		{
+			_output.push_back(static_cast<std::uint8_t>(_value >> 24));
+			_output.push_back(static_cast<std::uint8_t>(_value >> 16));
+			_output.push_back(static_cast<std::uint8_t>(_value >> 8));
+			_output.push_back(static_cast<std::uint8_t>(_value));
+		}
+
+		void AppendChunk(std::vector<std::uint8_t>& _output, const char* _type, const std::vector<std::uint8_t>& _data)
+		{
+			AppendBigEndian(_output, static_cast<std::uint32_t>(_data.size()));
+			size_t typeStart = _output.size();
+			_output.insert(_output.end(), _type, _type + 4);
+			_output.insert(_output.end(), _data.begin(), _data.end());
+			AppendBigEndian(_output, Crc32(&_output[typeStart], _output.size() - typeStart));
+		}
+
+		/// Writes a noise RGBA8 PNG. Rows use the Sub filter, the zlib stream uses uncompressed (stored) blocks since there is no deflate encoder at hand.
+		bool WritePng(const std::string& _filename, unsigned int _size, std::uint32_t _seed)
+		{
+			std::vector<std::uint8_t> filteredRows;
+			filteredRows.reserve((_size * 4 + 1) * _size);
+			std::uint32_t random = _seed * 2654435761u + 1;
+			for (unsigned int y = 0; y < _size; ++y)
+			{
+				filteredRows.push_back(1); // Sub filter
+				std::uint8_t previous[4] = {};
+				for (unsigned int x = 0; x < _size * 4; ++x)
+				{
+					random = random * 1664525u + 1013904223u;
+					std::uint8_t value = static_cast<std::uint8_t>(random >> 24);
+					filteredRows.push_back(static_cast<std::uint8_t>(value - previous[x % 4]));
+					previous[x % 4] = value;
+				}
+			}
+
+			std::vector<std::uint8_t> zlibStream = { 0x78, 0x01 };
+			for (size_t blockStart = 0; blockStart < filteredRows.size(); blockStart += 0xFFFF)
+			{
+				std::uint16_t blockSize = static_cast<std::uint16_t>(std::min<size_t>(0xFFFF, filteredRows.size() - blockStart));
+				zlibStream.push_back(blockStart + blockSize == filteredRows.size() ? 1 : 0);
+				zlibStream.push_back(static_cast<std::uint8_t>(blockSize));
+				zlibStream.push_back(static_cast<std::uint8_t>(blockSize >> 8));
+				zlibStream.push_back(static_cast<std::uint8_t>(~blockSize));
+				zlibStream.push_back(static_cast<std::uint8_t>(~blockSize >> 8));
+				zlibStream.insert(zlibStream.end(), filteredRows.begin() + blockStart, filteredRows.begin() + blockStart + blockSize);
+			}
+			std::uint32_t adlerA = 1;
+			std::uint32_t adlerB = 0;
+			for (std::uint8_t byte : filteredRows)
+			{
+				adlerA = (adlerA + byte) % 65521;
+				adlerB = (adlerB + adlerA) % 65521;
+			}
+			AppendBigEndian(zlibStream, (adlerB << 16) | adlerA);
+
+			std::vector<std::uint8_t> header;
+			AppendBigEndian(header, _size);
+			AppendBigEndian(header, _size);
+			header.push_back(8); // Bit depth
+			header.push_back(6); // RGBA
+			header.push_back(0); // Compression method
+			header.push_back(0); // Filter method
+			header.push_back(0); // No interlace
+
+			std::vector<std::uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+			AppendChunk(png, "IHDR", header);
+			AppendChunk(png, "IDAT", zlibStream);
+			AppendChunk(png, "IEND", std::vector<std::uint8_t>());
+
+			std::ofstream file(_filename.c_str(), std::ios::binary);
+			file.write(reinterpret_cast<const char*>(png.data()), png.size());
+			return file.good();
+		}
+
+		std::vector<std::string> FindPngFiles(const std::string& _directory)
+		{
+			std::vector<std::string> filenames;
+			WIN32_FIND_DATAA findData;
+			HANDLE findHandle = FindFirstFileA((_directory + "\\*.png").c_str(), &findData);
+			if (findHandle == INVALID_HANDLE_VALUE)
+				return filenames;
+			do
+			{
+				filenames.push_back(_directory + "\\" + findData.cFileName);
+			} while (FindNextFileA(findHandle, &findData));
+			FindClose(findHandle);
+			return filenames;
+		}
+	}
+
+	bool RunTextureLoad(const std::vector<std::string>& _arguments)
+	{
+		if (_arguments.empty())
+		{
+			std::cerr << "Missing directory." << std::endl;
+			return false;
+		}
+		const std::string& directory = _arguments[0];
+		unsigned int numFiles = _arguments.size() < 2 ? 1000 : std::stoul(_arguments[1]);
+		unsigned int imageSize = _arguments.size() < 3 ? 256 : std::stoul(_arguments[2]);
+
+		std::vector<std::string> filenames = FindPngFiles(directory);
+		if (filenames.empty())
+		{
+			std::cout << "Generating " << numFiles << " PNGs of " << imageSize << "x" << imageSize << " in " << directory << "\n";
+			CreateDirectoryA(directory.c_str(), nullptr);
+			for (unsigned int i = 0; i < numFiles; ++i)
+			{
+				std::string filename = directory + "\\image" + std::to_string(i) + ".png";
+				if (!WritePng(filename, imageSize, i))
+				{
+					std::cerr << "Failed to write " << filename << std::endl;
+					return false;
+				}
+				filenames.push_back(filename);
+			}
+		}
+
+		if (!Tools::CreateHiddenContext("glhelper_benchmark"))
+		{
+			std::cerr << "Failed to create OpenGL context." << std::endl;
+			return false;
+		}
+
+		// Both runs read the files from the OS file cache, since they were just generated or are read by the first run.
+		double sequentialTime;
+		{
+			Timer timer;
+			std::vector<std::unique_ptr<gl::Texture2D>> textures;
+			for (const std::string& filename : filenames)
+				textures.push_back(gl::Texture2D::LoadFromFile(filename));
+			glFinish();
+			sequentialTime = timer.GetElapsedMilliseconds();
+		}
+
+		double parallelTime;
+		{
+			Timer timer;
+			std::vector<std::unique_ptr<gl::Texture2D>> textures = gl::Texture2D::LoadFromFiles(filenames);
+			glFinish();
+			parallelTime = timer.GetElapsedMilliseconds();
+		}
+
+		std::cout << filenames.size() << " files, mip maps generated\n"
+			<< "  LoadFromFile, one after another: " << sequentialTime << " ms\n"
+			<< "  LoadFromFiles, " << std::max(1u, std::thread::hardware_concurrency()) << " decode threads: " << parallelTime << " ms (speedup " << (sequentialTime / parallelTime) << ")" << std::endl;
+
+		return true;
+	}
+#else
+	bool RunTextureLoad(const std::vector<std::string>&)
+	{
+		std::cerr << "glhelper was compiled without TEXTURE2D_FROMFILE_STBI." << std::endl;
+		return false;
+	}
+#endif
+}
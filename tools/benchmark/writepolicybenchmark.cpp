@@ -0,0 +1,106 @@
+#include "benchmark.hpp"
+
+#include <shaderdatametainfo.hpp>
+
+#include <cstring>
+#include <iostream>
+
+namespace Benchmark
+{
+	namespace
+	{
+		const unsigned int s_numVec4Variables = 48;
+		const unsigned int s_numFloatVariables = 16;
+
+		/// Creates meta info of a uniform block with std140 layout as the reflection would report it.
+		gl::UniformBufferMetaInfo CreateBlockInfo()
+		{
+			gl::UniformBufferMetaInfo blockInfo;
+			blockInfo.bufferBinding = 0;
+
+			gl::UniformVariableInfo variable;
+			variable.arrayElementCount = 1;
+			variable.arrayStride = 0;
+			variable.matrixStride = 0;
+			variable.rowMajor = false;
+			variable.location = -1;
+			variable.atomicCounterbufferIndex = -1;
+
+			std::int32_t offset = 0;
+			variable.type = gl::ShaderVariableType::FLOAT_VEC4;
+			for (unsigned int i = 0; i < s_numVec4Variables; ++i, offset += sizeof(gl::Vec4))
+			{
+				variable.blockOffset = offset;
+				blockInfo.variables.emplace("vector" + std::to_string(i), variable);
+			}
+			variable.type = gl::ShaderVariableType::FLOAT;
+			for (unsigned int i = 0; i < s_numFloatVariables; ++i, offset += sizeof(float))
+			{
+				variable.blockOffset = offset;
+				blockInfo.variables.emplace("scalar" + std::to_string(i), variable);
+			}
+			blockInfo.bufferDataSizeByte = offset;
+
+			return blockInfo;
+		}
+
+		/// Writes all variables of the block _numIterations times through resolved handles and returns the time per write in nanoseconds.
+		template<typename View>
+		double MeasureWrites(View& _view, const char* _blockMemory, unsigned int _numIterations)
+		{
+			std::vector<typename View::VariableHandle> vectorHandles;
+			std::vector<typename View::VariableHandle> scalarHandles;
+			for (unsigned int i = 0; i < s_numVec4Variables; ++i)
+				vectorHandles.push_back(_view.GetHandle("vector" + std::to_string(i)));
+			for (unsigned int i = 0; i < s_numFloatVariables; ++i)
+				scalarHandles.push_back(_view.GetHandle("scalar" + std::to_string(i)));
+
+			// Reading back a byte per iteration keeps the compiler from discarding overwritten stores.
+			volatile char sink = 0;
+			Timer timer;
+			for (unsigned int iteration = 0; iteration < _numIterations; ++iteration)
+			{
+				float value = static_cast<float>(iteration);
+				for (const auto& handle : vectorHandles)
+					_view[handle].Set(gl::Vec4(value, 1.0f, 2.0f, 3.0f));
+				for (const auto& handle : scalarHandles)
+					_view[handle].Set(value);
+				sink = sink + _blockMemory[iteration % 16];
+			}
+			double elapsed = timer.GetElapsedMilliseconds();
+
+			return elapsed * 1000000.0 / (static_cast<double>(_numIterations) * (s_numVec4Variables + s_numFloatVariables));
+		}
+	}
+
+	bool RunWritePolicies(const std::vector<std::string>& _arguments)
+	{
+		unsigned int numIterations = _arguments.empty() ? 100000 : std::stoul(_arguments[0]);
+		if (numIterations == 0)
+		{
+			std::cerr << "Number of iterations needs to be positive." << std::endl;
+			return false;
+		}
+
+		// BufferSetWritePolicy is left out, its cost is dominated by glNamedBufferSubData and needs an OpenGL context.
+		gl::UniformBufferMetaInfo blockInfo = CreateBlockInfo();
+		std::vector<char> blockMemory(blockInfo.bufferDataSizeByte);
+		char* memory = blockMemory.data();
+
+		// How MappedMemoryView worked before the write policies: a capturing lambda behind a std::function.
+		const GLsizei mapOffset = 0;
+		gl::BufferInfoView<gl::UniformVariableInfo> functionView(blockInfo, [memory, mapOffset](const void* _data, GLsizei _sizeInBytes, std::int32_t _offset)
+		{
+			memcpy(memory + (_offset - mapOffset), _data, _sizeInBytes);
+		});
+		gl::MappedUBOView mappedView(blockInfo, memory, mapOffset);
+		gl::BufferInfoView<gl::UniformVariableInfo, gl::StagingWritePolicy> stagingView(blockInfo, gl::StagingWritePolicy(memory));
+
+		std::cout << numIterations << " iterations over a block of " << s_numVec4Variables << " vec4 and " << s_numFloatVariables << " float variables\n"
+			<< "FunctionWritePolicy (std::function): " << MeasureWrites(functionView, memory, numIterations) << " ns per Set\n"
+			<< "MappedMemoryWritePolicy:             " << MeasureWrites(mappedView, memory, numIterations) << " ns per Set\n"
+			<< "StagingWritePolicy:                  " << MeasureWrites(stagingView, memory, numIterations) << " ns per Set" << std::endl;
+
+		return true;
+	}
+}
@@ -0,0 +1,40 @@
+#include "hiddencontext.hpp"
+
+#include <gl.hpp>
+
+#include <Windows.h>
+
+namespace Tools
+{
+	bool CreateHiddenContext(const char* _windowClassName)
+	{
+		WNDCLASSA windowClass = {};
+		windowClass.style = CS_OWNDC;
+		windowClass.lpfnWndProc = DefWindowProcA;
+		windowClass.hInstance = GetModuleHandle(nullptr);
+		windowClass.lpszClassName = _windowClassName;
+		if (!RegisterClassA(&windowClass))
+			return false;
+
+		HWND window = CreateWindowA(windowClass.lpszClassName, "", WS_OVERLAPPEDWINDOW, 0, 0, 1, 1, nullptr, nullptr, windowClass.hInstance, nullptr);
+		if (!window)
+			return false;
+		HDC deviceContext = GetDC(window);
+
+		PIXELFORMATDESCRIPTOR pixelFormat = {};
+		pixelFormat.nSize = sizeof(pixelFormat);
+		pixelFormat.nVersion = 1;
+		pixelFormat.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL;
+		pixelFormat.iPixelType = PFD_TYPE_RGBA;
+		pixelFormat.cColorBits = 32;
+		if (!SetPixelFormat(deviceContext, ChoosePixelFormat(deviceContext, &pixelFormat), &pixelFormat))
+			return false;
+
+		HGLRC renderContext = wglCreateContext(deviceContext);
+		if (!renderContext || !wglMakeCurrent(deviceContext, renderContext))
+			return false;
+
+		glewExperimental = GL_TRUE;
+		return glewInit() == GLEW_OK;
+	}
+}
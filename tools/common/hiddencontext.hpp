@@ -0,0 +1,12 @@
+#pragma once
+
+// Shared by the tools in this directory, Windows only.
+
+namespace Tools
+{
+	/// Creates an invisible window with a legacy OpenGL context and initializes GLEW. Drivers give access to all core functions and extensions through it.
+	///
+	/// \param _windowClassName
+	///		Name of the registered window class, needs to be unique within the process.
+	bool CreateHiddenContext(const char* _windowClassName);
+}
@@ -0,0 +1,78 @@
+// Offline tool for creating shader bundles.
+// Resolves all #includes of the given shader files and packs them into a single bundle file that can be read with gl::ShaderBundle.
+
+#include <shaderbundle.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::cout << "Usage: glhelper_shaderpack <output bundle> <shader file | @listfile> ...\n"
+			"  Each listfile contains one shader filename per line.\n"
+			"  Entries are named by their canonicalized, lower case filename, use the same relative paths when loading from the bundle.\n";
+	}
+
+	bool ReadListFile(const std::string& _listFilename, std::vector<std::string>& _shaderFiles)
+	{
+		std::ifstream listFile(_listFilename.c_str());
+		if (listFile.bad() || listFile.fail())
+		{
+			std::cerr << "Unable to open list file " << _listFilename << std::endl;
+			return false;
+		}
+
+		std::string line;
+		while (std::getline(listFile, line))
+		{
+			// Trim whitespace & carriage returns.
+			size_t first = line.find_first_not_of(" \t\r");
+			size_t last = line.find_last_not_of(" \t\r");
+			if (first != std::string::npos)
+				_shaderFiles.push_back(line.substr(first, last - first + 1));
+		}
+		return true;
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	if (_argc < 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::vector<std::string> shaderFiles;
+	for (int i = 2; i < _argc; ++i)
+	{
+		std::string argument(_argv[i]);
+		if (argument[0] == '@')
+		{
+			if (!ReadListFile(argument.substr(1), shaderFiles))
+				return 1;
+		}
+		else
+			shaderFiles.push_back(argument);
+	}
+
+	gl::ShaderBundleWriter writer;
+	for (const std::string& shaderFile : shaderFiles)
+	{
+		if (writer.AddShaderFile(shaderFile) == gl::Result::FAILURE)
+		{
+			std::cerr << "Failed to add " << shaderFile << std::endl;
+			return 1;
+		}
+	}
+
+	if (writer.Write(_argv[1]) == gl::Result::FAILURE)
+		return 1;
+
+	std::cout << "Wrote " << writer.GetNumEntries() << " shaders to " << _argv[1] << std::endl;
+	return 0;
+}
@@ -0,0 +1,111 @@
+// Offline tool for generating C++ structs from the uniform and shader storage blocks of a shader program.
+// Compiles and links the given shader files in a hidden OpenGL context and writes a header that can be used with gl::ShaderStructGenerator::CheckLayout.
+
+#include <shaderobject.hpp>
+#include <shaderstructgenerator.hpp>
+
+#include "../common/hiddencontext.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::cout << "Usage: glhelper_shaderstructgen <output header> [-n <namespace>] [-p <prefix code>] <shader file> ...\n"
+			"  Shader types are derived from the file extensions:\n"
+			"  .vert, .tesc, .tese, .geom, .frag, .comp\n";
+	}
+
+	bool GetShaderType(const std::string& _filename, gl::ShaderObject::ShaderType& _type)
+	{
+		static const struct { const char* extension; gl::ShaderObject::ShaderType type; } s_extensions[] =
+		{
+			{ ".vert", gl::ShaderObject::ShaderType::VERTEX },
+			{ ".tesc", gl::ShaderObject::ShaderType::CONTROL },
+			{ ".tese", gl::ShaderObject::ShaderType::EVALUATION },
+			{ ".geom", gl::ShaderObject::ShaderType::GEOMETRY },
+			{ ".frag", gl::ShaderObject::ShaderType::FRAGMENT },
+			{ ".comp", gl::ShaderObject::ShaderType::COMPUTE },
+		};
+
+		size_t extensionStart = _filename.find_last_of('.');
+		if (extensionStart == std::string::npos)
+			return false;
+		std::string extension = _filename.substr(extensionStart);
+		for (auto& entry : s_extensions)
+		{
+			if (extension == entry.extension)
+			{
+				_type = entry.type;
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	if (_argc < 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::string outputFilename(_argv[1]);
+	std::string namespaceName;
+	std::string prefixCode;
+	std::vector<std::string> shaderFiles;
+	for (int i = 2; i < _argc; ++i)
+	{
+		std::string argument(_argv[i]);
+		if (argument == "-n" && i + 1 < _argc)
+			namespaceName = _argv[++i];
+		else if (argument == "-p" && i + 1 < _argc)
+			prefixCode = std::string(_argv[++i]) + "\n";
+		else
+			shaderFiles.push_back(argument);
+	}
+	if (shaderFiles.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	if (!Tools::CreateHiddenContext("glhelper_shaderstructgen"))
+	{
+		std::cerr << "Failed to create OpenGL context." << std::endl;
+		return 1;
+	}
+
+	gl::ShaderObject shaderObject(outputFilename);
+	for (const std::string& shaderFile : shaderFiles)
+	{
+		gl::ShaderObject::ShaderType type;
+		if (!GetShaderType(shaderFile, type))
+		{
+			std::cerr << "Unknown shader type of " << shaderFile << std::endl;
+			return 1;
+		}
+		if (shaderObject.AddShaderFromFile(type, shaderFile, prefixCode) != gl::Result::SUCCEEDED)
+			return 1;
+	}
+	if (shaderObject.CreateProgram() != gl::Result::SUCCEEDED)
+		return 1;
+
+	std::ofstream outputFile(outputFilename.c_str());
+	if (outputFile.bad() || outputFile.fail())
+	{
+		std::cerr << "Unable to open output file " << outputFilename << std::endl;
+		return 1;
+	}
+	outputFile << gl::ShaderStructGenerator::GenerateHeader(shaderObject, namespaceName);
+
+	std::cout << "Wrote " << shaderObject.GetUniformBufferInfo().size() << " uniform and " << shaderObject.GetShaderStorageBufferInfo().size()
+		<< " shader storage block structs to " << outputFilename << std::endl;
+
+	return 0;
+}